@@ -0,0 +1,1100 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/*
+* radio_bench : measures the overhead of the radio API on top of the mock tuner backend.
+* Every result line is "<name> <calls> <ns/op> <ops/s> <p50 ns> <p99 ns>" so that CI can track it.
+* The behaviour behind the rows is checked by radio_test, a failed call only ends the run here.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <radio.h>
+#include <radio_backend_private.h>
+#include <radio_rds_private.h>
+#include <radio_meter_private.h>
+#include <radio_fixture.h>
+
+#define BENCH_DEFAULT_ITERATIONS	100000
+#define BENCH_DEFAULT_SEEKS			1000
+#define BENCH_DEFAULT_SCANS			20
+
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int done;
+	int events;
+	unsigned long long last_ns;
+	unsigned long long *samples;
+	int sample_count;
+	int sample_max;
+} bench_sync_s;
+
+static bench_sync_s g_sync = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0, NULL, 0, 0 };
+
+static unsigned long long __now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int __compare_ull(const void *a, const void *b)
+{
+	unsigned long long x = *(const unsigned long long *)a;
+	unsigned long long y = *(const unsigned long long *)b;
+	return (x > y) - (x < y);
+}
+
+static void __report(const char *name, unsigned long long *samples, int count, unsigned long long total_ns)
+{
+	unsigned long long p50 = 0, p99 = 0;
+	double per_op = count ? (double)total_ns / count : 0;
+
+	if(count > 0)
+	{
+		qsort(samples, count, sizeof(unsigned long long), __compare_ull);
+		p50 = samples[count / 2];
+		p99 = samples[(int)((count - 1) * 0.99)];
+	}
+	printf("%-24s %10d %12.1f %14.0f %10llu %10llu\n", name, count, per_op,
+		per_op > 0 ? 1e9 / per_op : 0, p50, p99);
+}
+
+static int __bench_set_frequency(radio_h radio, unsigned long long *samples, int iterations)
+{
+	unsigned long long start = __now_ns();
+	int i;
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_set_frequency(radio, 87500 + (i % 200) * 100) != RADIO_ERROR_NONE)
+			return -1;
+		samples[i] = __now_ns() - t0;
+	}
+	__report("radio_set_frequency", samples, iterations, __now_ns() - start);
+	return 0;
+}
+
+static int __bench_get_state(radio_h radio, unsigned long long *samples, int iterations)
+{
+	radio_state_e state;
+	unsigned long long start = __now_ns();
+	int i;
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_get_state(radio, &state) != RADIO_ERROR_NONE)
+			return -1;
+		samples[i] = __now_ns() - t0;
+	}
+	__report("radio_get_state", samples, iterations, __now_ns() - start);
+	return 0;
+}
+
+/* A UI refresh : the four getters one after the other, then the same values from one radio_get_status() */
+static int __bench_ui_refresh(radio_h radio, unsigned long long *samples, int iterations)
+{
+	radio_status_s status;
+	radio_state_e state;
+	int frequency, strength;
+	bool muted;
+	unsigned long long start = __now_ns();
+	int i;
+
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_get_state(radio, &state) != RADIO_ERROR_NONE || radio_get_frequency(radio, &frequency) != RADIO_ERROR_NONE
+			|| radio_get_signal_strength(radio, &strength) != RADIO_ERROR_NONE || radio_is_muted(radio, &muted) != RADIO_ERROR_NONE)
+			return -1;
+		samples[i] = __now_ns() - t0;
+	}
+	__report("ui_refresh_getters", samples, iterations, __now_ns() - start);
+
+	start = __now_ns();
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_get_status(radio, &status) != RADIO_ERROR_NONE)
+			return -1;
+		samples[i] = __now_ns() - t0;
+	}
+	__report("radio_get_status", samples, iterations, __now_ns() - start);
+	return 0;
+}
+
+static void __seek_completed_cb(int frequency, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.done = 1;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static int __bench_seek_up(radio_h radio, const char *name, unsigned long long *samples, int iterations)
+{
+	unsigned long long start = __now_ns();
+	int i;
+
+	if(radio_start(radio) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		g_sync.done = 0;
+		if(radio_seek_up(radio, __seek_completed_cb, NULL) != RADIO_ERROR_NONE)
+			return -1;
+		pthread_mutex_lock(&g_sync.lock);
+		while(!g_sync.done)
+			pthread_cond_wait(&g_sync.cond, &g_sync.lock);
+		pthread_mutex_unlock(&g_sync.lock);
+		samples[i] = __now_ns() - t0;
+	}
+	__report(name, samples, iterations, __now_ns() - start);
+	return radio_stop(radio) == RADIO_ERROR_NONE ? 0 : -1;
+}
+
+static void __scan_updated_cb(int frequency, void *user_data)
+{
+	unsigned long long now = __now_ns();
+	pthread_mutex_lock(&g_sync.lock);
+	if(g_sync.sample_count < g_sync.sample_max)
+		g_sync.samples[g_sync.sample_count++] = now - g_sync.last_ns;
+	g_sync.last_ns = now;
+	g_sync.events++;
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static void __scan_completed_cb(void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.done = 1;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static int __bench_scan(radio_h radio, const char *name, unsigned long long *samples, int sample_max, int scans)
+{
+	unsigned long long total = 0;
+	radio_state_e state;
+	int i;
+
+	g_sync.samples = samples;
+	g_sync.sample_max = sample_max;
+	g_sync.sample_count = 0;
+	g_sync.events = 0;
+	if(radio_set_scan_completed_cb(radio, __scan_completed_cb, NULL) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < scans; i++)
+	{
+		unsigned long long t0;
+		g_sync.done = 0;
+		t0 = g_sync.last_ns = __now_ns();
+		if(radio_scan_start(radio, __scan_updated_cb, NULL) != RADIO_ERROR_NONE)
+			return -1;
+		pthread_mutex_lock(&g_sync.lock);
+		while(!g_sync.done)
+			pthread_cond_wait(&g_sync.cond, &g_sync.lock);
+		pthread_mutex_unlock(&g_sync.lock);
+		total += __now_ns() - t0;
+		/* the mock posts READY right before SCAN_FINISH, wait until the handle has seen it */
+		do {
+			radio_get_state(radio, &state);
+		} while(state != RADIO_STATE_READY);
+	}
+	radio_unset_scan_completed_cb(radio);
+	__report(name, samples, g_sync.sample_count, total);
+	return 0;
+}
+
+static void __scan_batch_cb(const radio_station_s *stations, int count, void *user_data)
+{
+	__scan_updated_cb(stations[0].frequency, user_data);
+}
+
+/* same scans as scan_event_delivery, delivered in batches of 16 stations */
+static int __bench_scan_batch(radio_h radio, unsigned long long *samples, int sample_max, int scans)
+{
+	unsigned long long total = 0;
+	radio_state_e state;
+	int i;
+
+	g_sync.samples = samples;
+	g_sync.sample_max = sample_max;
+	g_sync.sample_count = 0;
+	g_sync.events = 0;
+	if(radio_set_scan_completed_cb(radio, __scan_completed_cb, NULL) != RADIO_ERROR_NONE
+		|| radio_set_scan_batch_cb(radio, 16, 0, __scan_batch_cb, NULL) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < scans; i++)
+	{
+		unsigned long long t0;
+		g_sync.done = 0;
+		t0 = g_sync.last_ns = __now_ns();
+		if(radio_scan_start(radio, NULL, NULL) != RADIO_ERROR_NONE)
+			return -1;
+		pthread_mutex_lock(&g_sync.lock);
+		while(!g_sync.done)
+			pthread_cond_wait(&g_sync.cond, &g_sync.lock);
+		pthread_mutex_unlock(&g_sync.lock);
+		total += __now_ns() - t0;
+		do {
+			radio_get_state(radio, &state);
+		} while(state != RADIO_STATE_READY);
+	}
+	radio_unset_scan_batch_cb(radio);
+	radio_unset_scan_completed_cb(radio);
+	__report("scan_batch_delivery", samples, g_sync.sample_count, total);
+	return 0;
+}
+
+/* same scans as scan_event_delivery, delivered on a main context iterated by the bench thread */
+static int __bench_scan_context(radio_h radio, unsigned long long *samples, int sample_max, int scans)
+{
+	GMainContext *context = g_main_context_new();
+	unsigned long long total = 0;
+	radio_state_e state;
+	int i, ret = 0;
+
+	g_sync.samples = samples;
+	g_sync.sample_max = sample_max;
+	g_sync.sample_count = 0;
+	g_sync.events = 0;
+	if(radio_set_event_context(radio, context) != RADIO_ERROR_NONE
+		|| radio_set_scan_completed_cb(radio, __scan_completed_cb, NULL) != RADIO_ERROR_NONE)
+		ret = -1;
+	for(i = 0; i < scans && ret == 0; i++)
+	{
+		unsigned long long t0;
+		g_sync.done = 0;
+		t0 = g_sync.last_ns = __now_ns();
+		if(radio_scan_start(radio, __scan_updated_cb, NULL) != RADIO_ERROR_NONE)
+		{
+			ret = -1;
+			break;
+		}
+		while(!g_sync.done)
+			g_main_context_iteration(context, TRUE);
+		total += __now_ns() - t0;
+		do {
+			radio_get_state(radio, &state);
+		} while(state != RADIO_STATE_READY);
+	}
+	radio_unset_scan_completed_cb(radio);
+	radio_set_event_context(radio, NULL);
+	g_main_context_unref(context);
+	if(ret == 0)
+		__report("context_event_delivery", samples, g_sync.sample_count, total);
+	return ret;
+}
+
+/* same scans as scan_event_delivery, read from the event descriptor : latency from the event to its read */
+static int __bench_scan_event_fd(radio_h radio, unsigned long long *samples, int sample_max, int scans)
+{
+	radio_event_s events[64];
+	struct pollfd pfd;
+	unsigned long long total = 0;
+	radio_state_e state;
+	int i, j, count, wakeups = 0, sample_count = 0;
+
+	if(radio_get_event_fd(radio, &pfd.fd) != RADIO_ERROR_NONE)
+		return -1;
+	pfd.events = POLLIN;
+	/* drop what was recorded before the first scan */
+	while(radio_read_events(radio, events, 64, &count) == RADIO_ERROR_NONE && count > 0)
+		;
+	for(i = 0; i < scans; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		bool done = false;
+		if(radio_scan_start(radio, NULL, NULL) != RADIO_ERROR_NONE)
+			return -1;
+		while(!done)
+		{
+			if(poll(&pfd, 1, 5000) != 1)
+				return -1;
+			wakeups++;
+			if(radio_read_events(radio, events, 64, &count) != RADIO_ERROR_NONE)
+				return -1;
+			for(j = 0; j < count; j++)
+			{
+				if(events[j].type == RADIO_EVENT_SCAN_INFO && sample_count < sample_max)
+					samples[sample_count++] = __now_ns() - events[j].timestamp;
+				else if(events[j].type == RADIO_EVENT_SCAN_FINISH)
+					done = true;
+			}
+		}
+		total += __now_ns() - t0;
+		do {
+			radio_get_state(radio, &state);
+		} while(state != RADIO_STATE_READY);
+	}
+	__report("event_fd_delivery", samples, sample_count, total);
+	fprintf(stderr, "event_fd : %d events in %d wakeups\n", sample_count, wakeups);
+	return 0;
+}
+
+static void __signal_strength_changed_cb(int strength, radio_signal_strength_event_e event, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.done = 1;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+/* time from radio_start() to the first signal strength event of the subscription */
+static int __bench_signal_strength(radio_h radio, unsigned long long *samples, int iterations)
+{
+	unsigned long long start = __now_ns();
+	int i;
+
+	if(radio_set_signal_strength_changed_cb(radio, 1000, 30, 5, 0, __signal_strength_changed_cb, NULL) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		g_sync.done = 0;
+		if(radio_start(radio) != RADIO_ERROR_NONE)
+			return -1;
+		pthread_mutex_lock(&g_sync.lock);
+		while(!g_sync.done)
+			pthread_cond_wait(&g_sync.cond, &g_sync.lock);
+		pthread_mutex_unlock(&g_sync.lock);
+		samples[i] = __now_ns() - t0;
+		if(radio_stop(radio) != RADIO_ERROR_NONE)
+			return -1;
+	}
+	radio_unset_signal_strength_changed_cb(radio);
+	__report("signal_strength_event", samples, iterations, __now_ns() - start);
+	return 0;
+}
+
+/*
+* Command queue : each burst is a dial turned over 8 channels then start, seek up and stop, all asynchronous.
+* The row is the time from the first command of a burst to the completion of its stop.
+*/
+#define BENCH_BURST_FREQUENCIES	8
+
+static int g_completed_frequencies;
+
+static void __command_completed_cb(radio_command_e command, radio_error_e error, int frequency, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	if(command == RADIO_COMMAND_SET_FREQUENCY && error == RADIO_ERROR_NONE)
+		g_completed_frequencies++;
+	if(command == RADIO_COMMAND_STOP)
+	{
+		g_sync.done = 1;
+		pthread_cond_signal(&g_sync.cond);
+	}
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static int __bench_command_queue(radio_h radio, unsigned long long *samples, int bursts)
+{
+	unsigned long long start = __now_ns();
+	int i, j;
+
+	g_completed_frequencies = 0;
+	for(i = 0; i < bursts; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		g_sync.done = 0;
+		for(j = 0; j < BENCH_BURST_FREQUENCIES; j++)
+		{
+			if(radio_set_frequency_async(radio, 87500 + ((i + j) % 200) * 100, __command_completed_cb, NULL) != RADIO_ERROR_NONE)
+				return -1;
+		}
+		if(radio_start_async(radio, __command_completed_cb, NULL) != RADIO_ERROR_NONE
+			|| radio_seek_up_async(radio, __command_completed_cb, NULL) != RADIO_ERROR_NONE
+			|| radio_stop_async(radio, __command_completed_cb, NULL) != RADIO_ERROR_NONE)
+			return -1;
+		pthread_mutex_lock(&g_sync.lock);
+		while(!g_sync.done)
+			pthread_cond_wait(&g_sync.cond, &g_sync.lock);
+		pthread_mutex_unlock(&g_sync.lock);
+		samples[i] = __now_ns() - t0;
+	}
+	__report("command_queue_burst", samples, bursts, __now_ns() - start);
+	fprintf(stderr, "command_queue : %d frequency changes reached the tuner out of %d\n", g_completed_frequencies, bursts * BENCH_BURST_FREQUENCIES);
+	return 0;
+}
+
+/*
+* Callback stress : the scan row again while a thread keeps registering and unregistering callbacks.
+*/
+static int g_stress_stop;
+
+static void __stress_completed_cb(void *user_data)
+{
+}
+
+static void __stress_interrupted_cb(radio_interrupted_code_e code, void *user_data)
+{
+}
+
+static void *__stress_register_thread(void *data)
+{
+	radio_h radio = (radio_h)data;
+	int i = 0;
+	while(!__atomic_load_n(&g_stress_stop, __ATOMIC_RELAXED))
+	{
+		if(i++ % 2 == 0)
+			radio_set_scan_completed_cb(radio, __stress_completed_cb, NULL);
+		else
+			radio_unset_scan_completed_cb(radio);
+		radio_set_interrupted_cb(radio, __stress_interrupted_cb, NULL);
+		radio_unset_interrupted_cb(radio);
+	}
+	return NULL;
+}
+
+static int __bench_callback_stress(radio_h radio, unsigned long long *samples, int scans)
+{
+	unsigned long long start;
+	radio_state_e state;
+	pthread_t thread;
+	int i;
+
+	g_stress_stop = 0;
+	if(pthread_create(&thread, NULL, __stress_register_thread, radio) != 0)
+		return -1;
+	start = __now_ns();
+	for(i = 0; i < scans; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_scan_start(radio, NULL, NULL) != RADIO_ERROR_NONE)
+			break;
+		do {
+			radio_get_state(radio, &state);
+		} while(state != RADIO_STATE_READY);
+		samples[i] = __now_ns() - t0;
+	}
+	__atomic_store_n(&g_stress_stop, 1, __ATOMIC_RELAXED);
+	pthread_join(thread, NULL);
+	radio_unset_scan_completed_cb(radio);
+	if(i < scans)
+		return -1;
+	__report("callback_stress", samples, scans, __now_ns() - start);
+	return 0;
+}
+
+/*
+* Listeners : the scan row again with extra scan listeners, while a thread keeps adding and removing one more.
+*/
+#define BENCH_LISTENERS	4
+
+static int g_listener_events;
+
+static void __listener_updated_cb(int frequency, void *user_data)
+{
+	__atomic_add_fetch(&g_listener_events, 1, __ATOMIC_RELAXED);
+}
+
+static void *__listener_churn_thread(void *data)
+{
+	radio_h radio = (radio_h)data;
+	int id;
+	while(!__atomic_load_n(&g_stress_stop, __ATOMIC_RELAXED))
+	{
+		if(radio_add_scan_updated_cb(radio, __listener_updated_cb, NULL, &id) == RADIO_ERROR_NONE)
+			radio_remove_cb(radio, id);
+	}
+	return NULL;
+}
+
+static int __bench_scan_listeners(radio_h radio, unsigned long long *samples, int sample_max, int scans)
+{
+	int ids[BENCH_LISTENERS];
+	pthread_t thread;
+	int i, ret;
+
+	for(i = 0; i < BENCH_LISTENERS; i++)
+	{
+		if(radio_add_scan_updated_cb(radio, __listener_updated_cb, NULL, &ids[i]) != RADIO_ERROR_NONE)
+			return -1;
+	}
+	g_stress_stop = 0;
+	if(pthread_create(&thread, NULL, __listener_churn_thread, radio) != 0)
+		return -1;
+	ret = __bench_scan(radio, "scan_listeners", samples, sample_max, scans);
+	__atomic_store_n(&g_stress_stop, 1, __ATOMIC_RELAXED);
+	pthread_join(thread, NULL);
+	for(i = 0; i < BENCH_LISTENERS; i++)
+	{
+		if(radio_remove_cb(radio, ids[i]) != RADIO_ERROR_NONE)
+			ret = -1;
+	}
+	return ret;
+}
+
+/*
+* Idle suspend : the handle is left ready past its idle timeout before every radio_start(), which resumes the device.
+* The row is the latency of that radio_start().
+*/
+#define BENCH_IDLE_TIMEOUT_MS	100
+
+static int __bench_idle_resume(radio_h radio, unsigned long long *samples, int iterations)
+{
+	unsigned long long total = 0;
+	int i;
+
+	if(radio_set_idle_timeout(radio, BENCH_IDLE_TIMEOUT_MS) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0;
+		if(radio_set_frequency(radio, 87500 + (i % 100) * 200) != RADIO_ERROR_NONE)
+			return -1;
+		usleep((BENCH_IDLE_TIMEOUT_MS + 50) * 1000);
+		t0 = __now_ns();
+		if(radio_start(radio) != RADIO_ERROR_NONE)
+			return -1;
+		samples[i] = __now_ns() - t0;
+		total += samples[i];
+		if(radio_stop(radio) != RADIO_ERROR_NONE)
+			return -1;
+	}
+	if(radio_set_idle_timeout(radio, 0) != RADIO_ERROR_NONE)
+		return -1;
+	/* the idle periods are not part of the row */
+	__report("idle_resume", samples, iterations, total);
+	return 0;
+}
+
+/*
+* Alternate frequency : the radio plays the weakest station with the strongest one as its alternate, until the monitor
+* switches over to it. The row is the time from radio_start() to the switch, the share of the tuner time spent in the
+* windows is printed along.
+*/
+#define BENCH_AF_MARGIN			10
+#define BENCH_AF_TUNER_SHARE	20
+#define BENCH_AF_SWITCHES		2
+
+static void __alternate_frequency_cb(int frequency, int strength, bool switched, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.last_ns = __now_ns();
+	g_sync.done = 1;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static bool __af_window_cb(const radio_statistics_s *statistics, void *user_data)
+{
+	if(strcmp(statistics->name, "device:af_window") != 0)
+		return true;
+	*(unsigned long long *)user_data = statistics->total_ns;
+	return false;
+}
+
+static int __bench_alternate_frequency(radio_h radio, const _radio_mock_config_s *config, unsigned long long *samples)
+{
+	int weak = config->stations[0].frequency;
+	int strong = config->stations[29].frequency;
+	unsigned long long total = 0, windows = 0, windowed = 0, elapsed = 0;
+	int i;
+
+	if(radio_set_alternate_frequency_cb(radio, BENCH_AF_MARGIN, BENCH_AF_TUNER_SHARE, true, __alternate_frequency_cb, NULL) != RADIO_ERROR_NONE)
+		return -1;
+	radio_foreach_statistics(__af_window_cb, &windows);
+	for(i = 0; i < BENCH_AF_SWITCHES; i++)
+	{
+		unsigned long long t0;
+		g_sync.done = 0;
+		if(radio_set_frequency(radio, weak) != RADIO_ERROR_NONE || radio_set_alternate_frequencies(radio, &strong, 1) != RADIO_ERROR_NONE)
+			return -1;
+		t0 = __now_ns();
+		if(radio_start(radio) != RADIO_ERROR_NONE)
+			return -1;
+		pthread_mutex_lock(&g_sync.lock);
+		while(!g_sync.done)
+			pthread_cond_wait(&g_sync.cond, &g_sync.lock);
+		pthread_mutex_unlock(&g_sync.lock);
+		samples[i] = g_sync.last_ns - t0;
+		total += samples[i];
+		elapsed += __now_ns() - t0;
+		if(radio_stop(radio) != RADIO_ERROR_NONE)
+			return -1;
+	}
+	if(radio_unset_alternate_frequency_cb(radio) != RADIO_ERROR_NONE || radio_set_alternate_frequencies(radio, NULL, 0) != RADIO_ERROR_NONE)
+		return -1;
+	radio_foreach_statistics(__af_window_cb, &windowed);
+	__report("alternate_frequency", samples, BENCH_AF_SWITCHES, total);
+	fprintf(stderr, "alternate_frequency : windows took %.2f%% of the tuner time\n", 100.0 * (windowed - windows) / elapsed);
+	return 0;
+}
+
+/*
+* Audio tap : the mock plays the fixture file in real time, readers follow the tap through the handle and through the
+* descriptor. The row is the delay from the capture of a period to its delivery to a reader.
+*/
+#define BENCH_PCM_PERIOD_FRAMES	256
+#define BENCH_PCM_PERIODS		8
+#define BENCH_PCM_READERS		3
+#define BENCH_PCM_READS			200
+
+typedef struct {
+	radio_pcm_reader_h reader;
+	unsigned long long *samples;
+	int errors;
+} bench_pcm_reader_s;
+
+static void *__pcm_reader_thread(void *data)
+{
+	bench_pcm_reader_s *pcm = (bench_pcm_reader_s *)data;
+	radio_pcm_period_s period;
+	bool overrun;
+	int i;
+
+	for(i = 0; i < BENCH_PCM_READS; i++)
+	{
+		if(radio_pcm_reader_acquire(pcm->reader, 1000, &period) != RADIO_ERROR_NONE)
+		{
+			pcm->errors++;
+			break;
+		}
+		pcm->samples[i] = __now_ns() - period.timestamp;
+		if(radio_pcm_reader_release(pcm->reader, &overrun) != RADIO_ERROR_NONE)
+			pcm->errors++;
+	}
+	return NULL;
+}
+
+static int __bench_pcm_tap(radio_h radio, unsigned long long *samples)
+{
+	bench_pcm_reader_s readers[BENCH_PCM_READERS];
+	pthread_t threads[BENCH_PCM_READERS];
+	unsigned long long total = 0;
+	int i, fd, started = 0, ret = 0;
+
+	if(radio_pcm_tap_start(radio, BENCH_PCM_PERIOD_FRAMES, BENCH_PCM_PERIODS) != RADIO_ERROR_NONE
+		|| radio_pcm_tap_get_fd(radio, &fd) != RADIO_ERROR_NONE)
+		return -1;
+	memset(readers, 0, sizeof(readers));
+	for(i = 0; i < BENCH_PCM_READERS; i++)
+	{
+		readers[i].samples = samples + i * BENCH_PCM_READS;
+		/* the last one maps the ring like another process would */
+		if((i < BENCH_PCM_READERS - 1 ? radio_pcm_reader_create(radio, &readers[i].reader)
+			: radio_pcm_reader_create_from_fd(fd, &readers[i].reader)) != RADIO_ERROR_NONE)
+			ret = -1;
+	}
+	if(ret == 0 && radio_start(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	for(i = 0; i < BENCH_PCM_READERS && ret == 0; i++, started++)
+	{
+		if(pthread_create(&threads[i], NULL, __pcm_reader_thread, &readers[i]) != 0)
+			ret = -1;
+	}
+	for(i = 0; i < started; i++)
+	{
+		pthread_join(threads[i], NULL);
+		if(readers[i].errors > 0)
+			ret = -1;
+	}
+	radio_stop(radio);
+	if(radio_pcm_tap_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	for(i = 0; i < BENCH_PCM_READERS; i++)
+	{
+		if(readers[i].reader != NULL)
+			radio_pcm_reader_destroy(readers[i].reader);
+	}
+	if(ret != 0)
+		return ret;
+	for(i = 0; i < BENCH_PCM_READERS * BENCH_PCM_READS; i++)
+		total += samples[i];
+	__report("pcm_tap_delivery", samples, BENCH_PCM_READERS * BENCH_PCM_READS, total);
+	return 0;
+}
+
+/*
+* Time-shift : the tap is recorded into a two second buffer until it is full.
+* The row is the latency of radio_timeshift_seek() over random delays.
+*/
+#define BENCH_TIMESHIFT_SECONDS		2
+#define BENCH_TIMESHIFT_RECORD_MS	2500
+
+static int __bench_timeshift(radio_h radio, unsigned long long *samples, int iterations)
+{
+	char path[] = "/tmp/radio_bench_timeshift_XXXXXX";
+	unsigned long long start;
+	int fd, i, ret = 0;
+
+	fd = mkstemp(path);
+	if(fd < 0)
+		return -1;
+	close(fd);
+	if(radio_pcm_tap_start(radio, BENCH_PCM_PERIOD_FRAMES, 64) != RADIO_ERROR_NONE
+		|| radio_timeshift_start(radio, path, BENCH_TIMESHIFT_SECONDS) != RADIO_ERROR_NONE
+		|| radio_start(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	if(ret == 0)
+		usleep(BENCH_TIMESHIFT_RECORD_MS * 1000);
+
+	start = __now_ns();
+	for(i = 0; i < iterations && ret == 0; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_timeshift_seek(radio, rand() % (BENCH_TIMESHIFT_SECONDS * 1000)) != RADIO_ERROR_NONE)
+			ret = -1;
+		samples[i] = __now_ns() - t0;
+	}
+	if(ret == 0)
+		__report("radio_timeshift_seek", samples, iterations, __now_ns() - start);
+
+	radio_stop(radio);
+	if(radio_timeshift_stop(radio) != RADIO_ERROR_NONE || radio_pcm_tap_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	unlink(path);
+	return ret;
+}
+
+/*
+* Recording : the tap is recorded as IMA ADPCM at 16 kHz for a second.
+* The row is the latency of radio_recording_get_status() while the recording runs.
+*/
+#define BENCH_RECORDING_MS		1000
+#define BENCH_RECORDING_RATE	16000
+
+static int __bench_recording(radio_h radio, unsigned long long *samples, int iterations)
+{
+	char path[] = "/tmp/radio_bench_recording_XXXXXX";
+	radio_recording_status_s status;
+	unsigned long long total = 0;
+	int fd, i, ret = 0;
+
+	fd = mkstemp(path);
+	if(fd < 0)
+		return -1;
+	close(fd);
+	if(radio_pcm_tap_start(radio, BENCH_PCM_PERIOD_FRAMES, 64) != RADIO_ERROR_NONE || radio_start(radio) != RADIO_ERROR_NONE
+		|| radio_recording_start(radio, path, RADIO_RECORDING_FORMAT_WAV_IMA_ADPCM, BENCH_RECORDING_RATE) != RADIO_ERROR_NONE)
+		ret = -1;
+	/* the total leaves out the sleeps between the calls */
+	for(i = 0; i < iterations && ret == 0; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_recording_get_status(radio, &status) != RADIO_ERROR_NONE)
+			ret = -1;
+		samples[i] = __now_ns() - t0;
+		total += samples[i];
+		usleep(BENCH_RECORDING_MS * 1000 / iterations);
+	}
+	if(ret == 0)
+		__report("radio_recording_get_status", samples, iterations, total);
+	if(radio_recording_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	radio_stop(radio);
+	if(radio_pcm_tap_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	unlink(path);
+	return ret;
+}
+
+/*
+* RDS : the row is the decoding time of a block over a long stream of the fixtures, the tuner delivers one every 21.9 ms.
+* Then the fixtures are played by the mock, and the time coming back to a station takes to report its cached metadata
+* is printed along.
+*/
+#define BENCH_RDS_CHUNK			1024
+
+static int g_rds_frequency;
+
+static int __bench_rds_decoder(unsigned long long *samples, int iterations)
+{
+	static uint32_t stream[BENCH_RDS_CHUNK * 4];
+	static _radio_rds_cache_s cache;
+	_radio_rds_decoder_s decoder;
+	unsigned long long total = 0;
+	int i, count = 0;
+
+	_radio_rds_cache_init(&cache);
+	_radio_rds_decoder_init(&decoder);
+	_radio_rds_decoder_tune(&decoder, &cache, 90000);
+	/* a long stream of both fixtures, decoded one chunk at a time */
+	while(count + _RADIO_FIXTURE_RDS_BLOCKS_MAX <= (int)(sizeof(stream) / sizeof(stream[0])))
+		count += _radio_fixture_rds_stream(&_radio_fixture_rds_stations[(count / _RADIO_FIXTURE_RDS_BLOCKS_MAX) % 2], stream + count);
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		_radio_rds_decode(&decoder, &cache, stream + (i * BENCH_RDS_CHUNK) % (count - BENCH_RDS_CHUNK), BENCH_RDS_CHUNK);
+		samples[i] = (__now_ns() - t0) / BENCH_RDS_CHUNK;
+		total += samples[i];
+	}
+	_radio_rds_cache_deinit(&cache);
+	__report("rds_decode_block", samples, iterations, total);
+	return 0;
+}
+
+static void __rds_changed_cb(int frequency, unsigned int fields, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	if(frequency == g_rds_frequency)
+	{
+		g_sync.events |= fields;
+		g_sync.last_ns = __now_ns();
+		pthread_cond_signal(&g_sync.cond);
+	}
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+/* Tunes a station and waits for the fields, returns the time they took or 0 */
+static unsigned long long __bench_rds_tune(radio_h radio, int frequency, unsigned int fields)
+{
+	struct timespec deadline;
+	unsigned long long t0;
+	int ret = 0;
+
+	pthread_mutex_lock(&g_sync.lock);
+	g_rds_frequency = frequency;
+	g_sync.events = 0;
+	pthread_mutex_unlock(&g_sync.lock);
+	t0 = __now_ns();
+	if(radio_set_frequency(radio, frequency) != RADIO_ERROR_NONE)
+		return 0;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += 2;
+	pthread_mutex_lock(&g_sync.lock);
+	while(((unsigned int)g_sync.events & fields) != fields && ret == 0)
+		ret = pthread_cond_timedwait(&g_sync.cond, &g_sync.lock, &deadline);
+	pthread_mutex_unlock(&g_sync.lock);
+	return ret == 0 ? g_sync.last_ns - t0 : 0;
+}
+
+static int __bench_rds(radio_h radio, const _radio_mock_config_s *config, unsigned long long *samples, int iterations)
+{
+	unsigned long long cached = 0;
+	int ret = 0;
+
+	if(__bench_rds_decoder(samples, iterations) != 0)
+		return -1;
+	if(radio_set_rds_changed_cb(radio, __rds_changed_cb, NULL) != RADIO_ERROR_NONE || radio_start(radio) != RADIO_ERROR_NONE)
+		return -1;
+	if(__bench_rds_tune(radio, config->stations[0].frequency, _RADIO_FIXTURE_RDS_ALL) == 0
+		|| __bench_rds_tune(radio, config->stations[1].frequency, _RADIO_FIXTURE_RDS_ALL & ~RADIO_RDS_FIELD_AF) == 0
+		|| (cached = __bench_rds_tune(radio, config->stations[0].frequency, _RADIO_FIXTURE_RDS_ALL)) == 0)
+		ret = -1;
+	else
+		fprintf(stderr, "rds : cached metadata reported %.1f us after the retune\n", cached / 1e3);
+	if(radio_unset_rds_changed_cb(radio) != RADIO_ERROR_NONE || radio_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	return ret;
+}
+
+/*
+* Level meter : the kernel and its scalar reference measure blocks of a period of stereo audio, streamed from a buffer
+* larger than the caches. Then the row of radio_level_meter_get() while the tap is metered.
+*/
+#define BENCH_METER_SAMPLES		(4 * 1024 * 1024)
+#define BENCH_METER_BLOCK		(2 * 1024)
+#define BENCH_METER_INTERVAL_MS	20
+
+static int __bench_meter_scan(const char *name, void (*scan)(const int16_t *, int, int, _radio_meter_block_s *),
+	const int16_t *buffer, unsigned long long *samples, int iterations)
+{
+	_radio_meter_block_s block;
+	unsigned long long total = 0, energy = 0;
+	int i, offset = 0;
+
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		scan(buffer + offset, BENCH_METER_BLOCK, _RADIO_FIXTURE_SILENCE, &block);
+		samples[i] = __now_ns() - t0;
+		total += samples[i];
+		energy += block.energy;
+		offset = (offset + BENCH_METER_BLOCK) % BENCH_METER_SAMPLES;
+	}
+	/* keeps the results alive */
+	if(energy == 0)
+		return -1;
+	__report(name, samples, iterations, total);
+	return 0;
+}
+
+static int __bench_meter_kernel(unsigned long long *samples, int iterations)
+{
+	int16_t *buffer = (int16_t *)malloc(sizeof(int16_t) * BENCH_METER_SAMPLES);
+	int ret;
+
+	if(buffer == NULL)
+		return -1;
+	_radio_fixture_meter_signal(buffer, BENCH_METER_SAMPLES);
+	ret = __bench_meter_scan("meter_scan_block_scalar", _radio_meter_scan_scalar, buffer, samples, iterations);
+	if(ret == 0)
+		ret = __bench_meter_scan("meter_scan_block", _radio_meter_scan, buffer, samples, iterations);
+	free(buffer);
+	return ret;
+}
+
+static void __level_cb(int peak, int rms, int silence_ms, void *user_data)
+{
+}
+
+static int __bench_level_meter(radio_h radio, unsigned long long *samples, int iterations)
+{
+	radio_level_s level;
+	unsigned long long total = 0;
+	int i, ret = 0;
+
+	if(__bench_meter_kernel(samples, iterations) != 0)
+		return -1;
+	if(radio_pcm_tap_start(radio, BENCH_PCM_PERIOD_FRAMES, 64) != RADIO_ERROR_NONE || radio_start(radio) != RADIO_ERROR_NONE
+		|| radio_level_meter_start(radio, BENCH_METER_INTERVAL_MS, _RADIO_FIXTURE_SILENCE, __level_cb, NULL) != RADIO_ERROR_NONE)
+		ret = -1;
+	for(i = 0; i < iterations && ret == 0; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_level_meter_get(radio, &level) != RADIO_ERROR_NONE)
+			ret = -1;
+		samples[i] = __now_ns() - t0;
+		total += samples[i];
+	}
+	if(ret == 0)
+		__report("radio_level_meter_get", samples, iterations, total);
+	if(radio_level_meter_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	radio_stop(radio);
+	if(radio_pcm_tap_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	return ret;
+}
+
+/* Handle lifetime : lazy handles created and destroyed in a loop */
+static int __bench_create_destroy(unsigned long long *samples, int iterations)
+{
+	unsigned long long start = __now_ns();
+	radio_h radio;
+	int i;
+
+	for(i = 0; i < iterations; i++)
+	{
+		unsigned long long t0 = __now_ns();
+		if(radio_create_lazy(&radio) != RADIO_ERROR_NONE || radio_destroy(radio) != RADIO_ERROR_NONE)
+			return -1;
+		samples[i] = __now_ns() - t0;
+	}
+	__report("create_destroy", samples, iterations, __now_ns() - start);
+	return 0;
+}
+
+static bool __print_statistics_cb(const radio_statistics_s *statistics, void *user_data)
+{
+	printf("%-40s %10llu %8llu %12llu %10llu %10llu %12llu\n", statistics->name, statistics->calls, statistics->errors,
+		statistics->calls ? statistics->total_ns / statistics->calls : 0, statistics->p50_ns, statistics->p99_ns, statistics->max_ns);
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = BENCH_DEFAULT_ITERATIONS;
+	int seeks = BENCH_DEFAULT_SEEKS;
+	int scans = BENCH_DEFAULT_SCANS;
+	_radio_fixture_s fixture;
+	unsigned long long *samples;
+	radio_h radio = NULL;
+	int opt, ret = 0;
+	bool statistics = false;
+
+	while((opt = getopt(argc, argv, "n:s:S:t")) != -1)
+	{
+		switch(opt)
+		{
+			case 'n': iterations = atoi(optarg); break;
+			case 's': seeks = atoi(optarg); break;
+			case 'S': scans = atoi(optarg); break;
+			case 't': statistics = true; break;
+			default:
+				fprintf(stderr, "usage: %s [-n iterations] [-s seeks] [-S scans] [-t]\n", argv[0]);
+				return 2;
+		}
+	}
+	if(iterations <= 0 || seeks <= 0 || scans <= 0)
+		return 2;
+
+	if(_radio_fixture_open(&fixture) != 0)
+		return 1;
+
+	samples = (unsigned long long *)malloc(sizeof(unsigned long long) *
+		(iterations > seeks * 2 ? iterations : seeks * 2) + sizeof(unsigned long long) * _RADIO_MOCK_MAX_STATIONS * scans
+		+ sizeof(unsigned long long) * BENCH_PCM_READERS * BENCH_PCM_READS);
+	if(samples == NULL)
+	{
+		_radio_fixture_close(&fixture);
+		return 1;
+	}
+
+	if(radio_create(&radio) != RADIO_ERROR_NONE)
+	{
+		fprintf(stderr, "radio_create failed\n");
+		free(samples);
+		_radio_fixture_close(&fixture);
+		return 1;
+	}
+
+	printf("%-24s %10s %12s %14s %10s %10s\n", "name", "calls", "ns/op", "ops/s", "p50(ns)", "p99(ns)");
+	if(__bench_set_frequency(radio, samples, iterations) != 0
+		|| __bench_get_state(radio, samples, iterations) != 0
+		|| radio_start(radio) != RADIO_ERROR_NONE
+		|| __bench_ui_refresh(radio, samples, iterations) != 0
+		|| radio_stop(radio) != RADIO_ERROR_NONE
+		|| radio_set_predictive_seek(radio, false) != RADIO_ERROR_NONE
+		|| __bench_seek_up(radio, "radio_seek_up", samples, seeks) != 0
+		|| __bench_scan(radio, "scan_event_delivery", samples, _RADIO_MOCK_MAX_STATIONS * scans, scans) != 0
+		|| __bench_scan_listeners(radio, samples, _RADIO_MOCK_MAX_STATIONS * scans, scans) != 0
+		|| __bench_scan_batch(radio, samples, _RADIO_MOCK_MAX_STATIONS * scans, scans) != 0
+		|| __bench_scan_context(radio, samples, _RADIO_MOCK_MAX_STATIONS * scans, scans) != 0
+		|| __bench_scan_event_fd(radio, samples, _RADIO_MOCK_MAX_STATIONS * scans, scans) != 0
+		|| radio_set_predictive_seek(radio, true) != RADIO_ERROR_NONE
+		|| __bench_seek_up(radio, "radio_seek_up_predicted", samples, seeks) != 0
+		|| __bench_signal_strength(radio, samples, seeks) != 0
+		|| __bench_command_queue(radio, samples, seeks) != 0
+		|| __bench_callback_stress(radio, samples, seeks) != 0
+		|| __bench_idle_resume(radio, samples, scans) != 0
+		|| __bench_alternate_frequency(radio, &fixture.config, samples) != 0
+		|| __bench_pcm_tap(radio, samples) != 0
+		|| __bench_timeshift(radio, samples, iterations) != 0
+		|| __bench_recording(radio, samples, 100) != 0
+		|| __bench_rds(radio, &fixture.config, samples, iterations) != 0
+		|| __bench_level_meter(radio, samples, iterations) != 0
+		|| __bench_create_destroy(samples, seeks) != 0)
+	{
+		fprintf(stderr, "benchmark failed\n");
+		ret = 1;
+	}
+
+	radio_destroy(radio);
+	free(samples);
+	_radio_fixture_close(&fixture);
+
+	/* -t : per-API statistics collected by the library over the whole run */
+	if(statistics)
+	{
+		printf("\n%-40s %10s %8s %12s %10s %10s %12s\n", "api", "calls", "errors", "mean(ns)", "p50(ns)", "p99(ns)", "max(ns)");
+		radio_foreach_statistics(__print_statistics_cb, NULL);
+	}
+	return ret;
+}
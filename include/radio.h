@@ -18,6 +18,7 @@
 #define __TIZEN_MEDIA_RADIO_H__
 
 #include <tizen.h>
+#include <glib.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +62,7 @@ typedef enum
 		RADIO_ERROR_INVALID_OPERATION	= TIZEN_ERROR_INVALID_OPERATION,		/**< Invalid operation */
 		RADIO_ERROR_INVALID_STATE	    = RADIO_ERROR_CLASS | 0x01	,		    		/**< Invalid state */
 		RADIO_ERROR_SOUND_POLICY	    = RADIO_ERROR_CLASS | 0x02	,		    		/**< Sound policy error */
+		RADIO_ERROR_CANCELLED	    = RADIO_ERROR_CLASS | 0x03	,		    		/**< Cancelled, a queued command was replaced by a newer one */
 } radio_error_e;
 
 /**
@@ -77,9 +79,218 @@ typedef enum
        RADIO_INTERRUPTED_BY_ALARM_END,						/**< Interrupted by alarm ending*/
 } radio_interrupted_code_e;
 
+/**
+ * @brief Enumerations of radio region, each region has its own band plan
+ */
+typedef enum
+{
+	RADIO_REGION_EUROPE = 0,		/**< 87500 ~ 108000 kHz, 100 kHz spacing (default) */
+	RADIO_REGION_US,				/**< 87500 ~ 108000 kHz, 200 kHz spacing */
+	RADIO_REGION_JAPAN,				/**< 76000 ~ 95000 kHz, 100 kHz spacing */
+	RADIO_REGION_OIRT,				/**< 65800 ~ 74000 kHz, 50 kHz spacing */
+} radio_region_e;
+
+/**
+ * @brief Enumerations of signal strength events
+ */
+typedef enum
+{
+	RADIO_SIGNAL_STRENGTH_BELOW_THRESHOLD = 0,	/**< The signal strength dropped below the threshold */
+	RADIO_SIGNAL_STRENGTH_ABOVE_THRESHOLD,		/**< The signal strength rose back to the threshold plus the hysteresis */
+	RADIO_SIGNAL_STRENGTH_CHANGED,				/**< The signal strength moved by the delta or more since the last event */
+} radio_signal_strength_event_e;
+
+/**
+ * @brief Enumerations of the commands run asynchronously
+ */
+typedef enum
+{
+	RADIO_COMMAND_SET_FREQUENCY = 0,	/**< radio_set_frequency_async() */
+	RADIO_COMMAND_START,				/**< radio_start_async() */
+	RADIO_COMMAND_STOP,					/**< radio_stop_async() */
+	RADIO_COMMAND_SEEK_UP,				/**< radio_seek_up_async() */
+	RADIO_COMMAND_SEEK_DOWN,			/**< radio_seek_down_async() */
+} radio_command_e;
+
+/**
+ * @brief Enumerations of the events read with radio_read_events()
+ */
+typedef enum
+{
+	RADIO_EVENT_SCAN_INFO = 0,		/**< A scan found a station, the value is its frequency (kHz) */
+	RADIO_EVENT_SCAN_START,			/**< The tuner started a scan */
+	RADIO_EVENT_SCAN_STOP,			/**< A scan was stopped */
+	RADIO_EVENT_SCAN_FINISH,		/**< A scan completed */
+	RADIO_EVENT_SEEK_START,			/**< The tuner started a seek */
+	RADIO_EVENT_SEEK_FINISH,		/**< A seek found a station, the value is its frequency (kHz) */
+	RADIO_EVENT_STATE_CHANGED,		/**< The state changed, the value is the new #radio_state_e */
+	RADIO_EVENT_INTERRUPTED,		/**< The radio was interrupted, the value is the #radio_interrupted_code_e */
+	RADIO_EVENT_ERROR,				/**< The tuner reported an error, the value is the #radio_error_e */
+	RADIO_EVENT_OVERFLOW,			/**< Events were dropped because they were not read in time, the value is their number */
+} radio_event_e;
+
+/**
+ * @brief The structure type for an event read with radio_read_events().
+ */
+typedef struct
+{
+	radio_event_e type;				/**< The event */
+	int value;						/**< The value of the event, see #radio_event_e */
+	unsigned long long timestamp;	/**< When the event happened, CLOCK_MONOTONIC (ns) */
+} radio_event_s;
+
+/**
+ * @brief The structure type for the status of a radio, read with radio_get_status().
+ */
+typedef struct
+{
+	radio_state_e state;				/**< The current state */
+	int frequency;						/**< The current frequency (kHz), 0 while a scan moves the tuner */
+	int signal_strength;				/**< The signal strength last measured on @a frequency (dbuV), 0 when never measured */
+	bool muted;							/**< The mute status */
+	int scan_frequency;					/**< The last frequency reported by the running or the last scan (kHz), 0 before any */
+	int scan_station_count;				/**< The stations found by the running or the last scan */
+	bool interrupted;					/**< The radio was interrupted since the handle was created */
+	radio_interrupted_code_e interrupted_code;	/**< The last interruption, valid when @a interrupted is true */
+} radio_status_s;
+
+/**
+ * @brief The structure type for a period of tuner audio, read in place with radio_pcm_reader_acquire().
+ */
+typedef struct
+{
+	unsigned long long sequence;	/**< The sequence number of the period, one more than the previous period */
+	unsigned long long timestamp;	/**< When the period was captured, CLOCK_MONOTONIC (ns) */
+	const short *frames;			/**< The interleaved 16-bit samples, valid until radio_pcm_reader_release() */
+	int frame_count;				/**< The number of frames, a frame holds one sample per channel */
+	int lost;						/**< The periods overwritten before they could be read since the previous one */
+} radio_pcm_period_s;
+
+/**
+ * @brief The reader of the audio tap of a radio, in this process or in another one.
+ */
+typedef struct radio_pcm_reader_s *radio_pcm_reader_h;
+
+/**
+ * @brief Enumerations of the file formats of a recording.
+ */
+typedef enum
+{
+	RADIO_RECORDING_FORMAT_WAV_PCM = 0,		/**< WAV, 16-bit PCM */
+	RADIO_RECORDING_FORMAT_WAV_IMA_ADPCM,	/**< WAV, 4-bit IMA ADPCM, a quarter of the size of PCM */
+} radio_recording_format_e;
+
+/**
+ * @brief The structure type for the status of a recording, read with radio_recording_get_status().
+ */
+typedef struct
+{
+	bool recording;						/**< The recording is running */
+	unsigned long long frames_recorded;	/**< The frames of the tap encoded so far */
+	unsigned long long frames_dropped;	/**< The frames of the tap missed because the recording fell behind */
+	unsigned long long bytes_written;	/**< The bytes written after the header */
+	int queue_peak;						/**< The most buffers waiting for the file at once */
+	radio_error_e error;				/**< #RADIO_ERROR_INVALID_OPERATION once the file could not be written */
+} radio_recording_status_s;
+
+/**
+ * @brief The structure type for the level of the tuner audio over the last window, read with radio_level_meter_get().
+ * @details Levels are magnitudes of 16-bit samples, from 0 to 32767, over all the channels.
+ */
+typedef struct
+{
+	bool running;						/**< The meter is running */
+	int peak;							/**< The largest magnitude of the window */
+	int rms;							/**< The root mean square of the window */
+	int silence_ms;						/**< How long the audio has stayed at or below the silence level, 0 while it is not */
+	unsigned long long windows;			/**< The windows measured since the meter started, 0 before the first one */
+} radio_level_s;
+
+#define RADIO_RDS_PS_LENGTH			8	/**< The characters of a program service name */
+#define RADIO_RDS_RADIO_TEXT_LENGTH	64	/**< The most characters of a RadioText */
+#define RADIO_RDS_AF_MAX			25	/**< The most alternate frequencies of a station */
+
+/**
+ * @brief Enumerations of the RDS metadata of a station, combined in masks.
+ */
+typedef enum
+{
+	RADIO_RDS_FIELD_PI = 0x01,			/**< Program identification */
+	RADIO_RDS_FIELD_PTY = 0x02,			/**< Program type */
+	RADIO_RDS_FIELD_PS = 0x04,			/**< Program service name */
+	RADIO_RDS_FIELD_RADIO_TEXT = 0x08,	/**< RadioText */
+	RADIO_RDS_FIELD_AF = 0x10,			/**< Alternate frequencies */
+} radio_rds_field_e;
+
+/**
+ * @brief The structure type for the RDS metadata received on a frequency, read with radio_get_rds_info().
+ * @details Characters outside of ASCII are replaced by '?'.
+ */
+typedef struct
+{
+	unsigned int fields;						/**< The #radio_rds_field_e received so far, the other members are empty */
+	int pi;										/**< The program identification code */
+	int pty;									/**< The program type, from 0 to 31 */
+	char ps[RADIO_RDS_PS_LENGTH + 1];			/**< The program service name, null-terminated */
+	char radio_text[RADIO_RDS_RADIO_TEXT_LENGTH + 1];	/**< The RadioText without its trailing spaces, null-terminated */
+	int af_count;								/**< The number of alternate frequencies */
+	int af[RADIO_RDS_AF_MAX];					/**< The alternate frequencies (kHz) */
+} radio_rds_info_s;
+
+/**
+ * @brief The structure type for a station found by a scan.
+ */
+typedef struct
+{
+	int frequency;			/**< The station frequency (kHz) */
+	int rssi;				/**< The signal strength measured when the station was last seen (dbuV) */
+	long long timestamp;	/**< When the station was last seen, in seconds since the Epoch */
+} radio_station_s;
+
+/**
+ * @brief The structure type for the statistics of an API function or of a message from the tuner.
+ * @details The statistics are process-wide. Latencies are measured from the entry to the return of the function,
+ * or over the handling of the message including the callbacks it invokes.
+ */
+typedef struct
+{
+	const char *name;						/**< The function name, or "message:" followed by the message type */
+	unsigned long long calls;				/**< The number of calls */
+	unsigned long long errors;				/**< The number of calls which failed */
+	unsigned long long invalid_parameter;	/**< The number of #RADIO_ERROR_INVALID_PARAMETER errors */
+	unsigned long long invalid_operation;	/**< The number of #RADIO_ERROR_INVALID_OPERATION errors */
+	unsigned long long invalid_state;		/**< The number of #RADIO_ERROR_INVALID_STATE errors */
+	unsigned long long out_of_memory;		/**< The number of #RADIO_ERROR_OUT_OF_MEMORY errors */
+	unsigned long long sound_policy;		/**< The number of #RADIO_ERROR_SOUND_POLICY errors */
+	unsigned long long total_ns;			/**< The total time spent (nanoseconds) */
+	unsigned long long p50_ns;				/**< The median latency, rounded up to a power of two minus one (nanoseconds) */
+	unsigned long long p99_ns;				/**< The 99th percentile latency, rounded up to a power of two minus one (nanoseconds) */
+	unsigned long long max_ns;				/**< The longest latency (nanoseconds) */
+} radio_statistics_s;
+
+/**
+ * @brief  Called for every station of the station list.
+ * @param[in] station The station
+ * @param[in] user_data  The user data passed from the foreach function
+ * @return @c true to continue with the next iteration of the loop, otherwise @c false to break out of the loop
+ * @pre radio_foreach_station() will invoke this callback.
+ * @see radio_foreach_station()
+ */
+typedef bool (*radio_station_cb)(const radio_station_s *station, void *user_data);
+
+/**
+ * @brief  Called for every API function or message type with statistics.
+ * @param[in] statistics The statistics, only valid during the call
+ * @param[in] user_data  The user data passed from the foreach function
+ * @return @c true to continue with the next iteration of the loop, otherwise @c false to break out of the loop
+ * @pre radio_foreach_statistics() will invoke this callback.
+ * @see radio_foreach_statistics()
+ */
+typedef bool (*radio_statistics_cb)(const radio_statistics_s *statistics, void *user_data);
+
 /**
  * @brief  Called when the scan information is updated.
- * @param[in] frequency The tuned radio frequency [87500 ~ 108000] (kHz)
+ * @param[in] frequency The tuned radio frequency (kHz)
  * @param[in] user_data  The user data passed from the callback registration function
  * @pre It will be invoked by radio_scan_start()
  * @see radio_scan_start()
@@ -104,9 +315,19 @@ typedef void (*radio_scan_stopped_cb)(void *user_data);
  */
 typedef void (*radio_scan_completed_cb)(void *user_data);
 
+/**
+ * @brief  Called with the stations found by a scan since the previous call.
+ * @param[in] stations The stations, in the order they were found
+ * @param[in] count The number of stations
+ * @param[in] user_data  The user data passed from the callback registration function
+ * @remarks @a stations is only valid during the call.
+ * @see radio_set_scan_batch_cb()
+ */
+typedef void (*radio_scan_batch_cb)(const radio_station_s *stations, int count, void *user_data);
+
 /**
  * @brief  Called when the radio seek is completed.
- * @param[in] frequency The current frequency [87500 ~ 108000] (kHz)
+ * @param[in] frequency The current frequency (kHz)
  * @param[in] user_data  The user data passed from the callback registration function
  * @pre It will be invoked when radio seek completed if you register this callback using radio_seek_up() or radio_seek_down()
  * @see radio_seek_up()
@@ -123,9 +344,74 @@ typedef void (*radio_seek_completed_cb)(int frequency, void *user_data);
  */
 typedef void (*radio_interrupted_cb)(radio_interrupted_code_e code, void *user_data);
 
+/**
+ * @brief  Called when the signal strength crosses the threshold or changes by the delta.
+ * @param[in] strength The signal strength (dbuV)
+ * @param[in] event The reason of the call
+ * @param[in] user_data  The user data passed from the callback registration function
+ * @remarks It is invoked on an internal thread.
+ * @see radio_set_signal_strength_changed_cb()
+ */
+typedef void (*radio_signal_strength_changed_cb)(int strength, radio_signal_strength_event_e event, void *user_data);
+
+/**
+ * @brief  Called when an alternate frequency is received clearly better than the current one.
+ * @param[in] frequency The alternate frequency (kHz)
+ * @param[in] strength The signal strength measured on @a frequency (dbuV)
+ * @param[in] switched True when the radio was moved to @a frequency, false when it is only reported
+ * @param[in] user_data  The user data passed from the callback registration function
+ * @remarks It is invoked on an internal thread, radio_destroy() must not be called from it.
+ * @see radio_set_alternate_frequency_cb()
+ */
+typedef void (*radio_alternate_frequency_cb)(int frequency, int strength, bool switched, void *user_data);
+
+/**
+ * @brief  Called when RDS metadata of the tuned station is received, or is known from an earlier visit right after a retune.
+ * @param[in] frequency The frequency of the station (kHz)
+ * @param[in] fields The #radio_rds_field_e which changed, read them with radio_get_rds_info()
+ * @param[in] user_data  The user data passed from the callback registration function
+ * @remarks It is invoked on an internal thread, radio_destroy() must not be called from it.
+ * @see radio_set_rds_changed_cb()
+ */
+typedef void (*radio_rds_changed_cb)(int frequency, unsigned int fields, void *user_data);
+
+/**
+ * @brief  Called at the end of every window of the level meter.
+ * @param[in] peak The largest magnitude of the window, from 0 to 32767
+ * @param[in] rms The root mean square of the window
+ * @param[in] silence_ms How long the audio has stayed at or below the silence level, 0 while it is not
+ * @param[in] user_data  The user data passed from the callback registration function
+ * @remarks It is invoked on an internal thread, radio_destroy() must not be called from it.
+ * Windows not delivered yet are replaced by the next one.
+ * @see radio_level_meter_start()
+ */
+typedef void (*radio_level_cb)(int peak, int rms, int silence_ms, void *user_data);
+
+/**
+ * @brief  Called when a command queued by an asynchronous function has run.
+ * @param[in] command The command
+ * @param[in] error The result of the command, #RADIO_ERROR_NONE on success, #RADIO_ERROR_CANCELLED when it was replaced before it ran
+ * @param[in] frequency The frequency tuned after the command (kHz), the station found by a seek
+ * @param[in] user_data  The user data passed from the asynchronous function
+ * @remarks It is invoked on an internal thread, radio_destroy() must not be called from it.
+ * @see radio_set_frequency_async()
+ */
+typedef void (*radio_command_completed_cb)(radio_command_e command, radio_error_e error, int frequency, void *user_data);
+
+/**
+ * @brief  Called when the device of a radio handle created by radio_create_async() is ready.
+ * @param[in] error The result of the device initialization, #RADIO_ERROR_NONE on success
+ * @param[in] user_data  The user data passed from the callback registration function
+ * @remarks It is invoked on an internal thread.
+ * @see radio_create_async()
+ */
+typedef void (*radio_ready_cb)(radio_error_e error, void *user_data);
+
 /**
  * @brief Creates a radio handle.
  * @remarks @a radio must be released radio_destroy() by you.
+ * The number of handles alive at the same time is limited, #RADIO_ERROR_OUT_OF_MEMORY is returned beyond it.
+ * When the device fails to initialize, @a radio is set to NULL and there is nothing to release.
  * @param[out]  radio  A new handle to radio
  * @retval #RADIO_ERROR_NONE Successful
  * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
@@ -135,10 +421,50 @@ typedef void (*radio_interrupted_cb)(radio_interrupted_code_e code, void *user_d
  */
 int radio_create(radio_h *radio);
 
+/**
+ * @brief Creates a radio handle and initializes the tuner device asynchronously.
+ * @details The handle is returned right away and the device is opened on an internal thread.
+ * radio_set_frequency() and radio_set_mute() can be called immediately : they are applied once the device is ready.
+ * radio_start() and radio_scan_start() wait until the device is ready.
+ * When the device failed to open, the error is reported to radio_ready_cb() and the next radio_start() or
+ * radio_scan_start() opens it again, like on a handle of radio_create_lazy().
+ * @remarks @a radio must be released radio_destroy() by you.
+ * @param[out]  radio  A new handle to radio
+ * @param[in] callback	The callback function invoked when the device is ready, can be NULL
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @post radio_ready_cb() will be invoked
+ * @see radio_create()
+ * @see radio_destroy()
+ */
+int radio_create_async(radio_h *radio, radio_ready_cb callback, void *user_data);
+
+/**
+ * @brief Creates a radio handle without opening the tuner device.
+ * @details The device is opened by the first radio_start() or radio_scan_start(), which returns its error when it fails :
+ * the next one tries again. Frequency and mute changes made before are applied at that time.
+ * radio_get_signal_strength() returns #RADIO_ERROR_INVALID_STATE until the device is opened.
+ * @remarks @a radio must be released radio_destroy() by you.
+ * @param[out]  radio  A new handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @see radio_create()
+ * @see radio_destroy()
+ */
+int radio_create_lazy(radio_h *radio);
+
 /**
  * @brief Destroys the radio handle and releases all its resources.
  *
  * @remarks To completely shutdown radio operation, call this function with a valid radio handle.
+ * Once destroyed, the handle is rejected by every function with #RADIO_ERROR_INVALID_PARAMETER.
  *
  * @param[in]		radio The handle to radio to be destroyed
  * @return 0 on success, otherwise a negative error value.
@@ -151,14 +477,30 @@ int radio_destroy(radio_h radio);
 
 /**
  * @brief Gets the radio's current state.
+ * @remarks The state is kept up to date from the tuner's notifications, so this function does not access the tuner.
  * @param[in]   radio	The handle to radio
  * @param[out]  state	The current state of the radio
  * @return 0 on success, otherwise a negative error value.
  * @retval #RADIO_ERROR_NONE Successful
  * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_refresh()
  */
 int  radio_get_state(radio_h radio, radio_state_e *state);
 
+/**
+ * @brief Reads the state and the frequency back from the tuner.
+ * @details radio_get_state() and radio_get_frequency() return the values cached by the radio handle.
+ * Call this function first when the values must come from the tuner itself.
+ * @param[in]   radio	The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @see radio_get_state()
+ * @see radio_get_frequency()
+ */
+int radio_refresh(radio_h radio);
+
 /**
  * @brief Starts playing radio.
  *
@@ -190,6 +532,8 @@ int radio_stop(radio_h radio);
 
 /**
  * @brief Seeks up the effective frequency of radio, asynchronously.
+ * @details When a previous scan or signal strength read found a station in this direction, the radio tunes to it
+ * directly and radio_seek_completed_cb() is invoked before this function returns. See radio_set_predictive_seek().
  * @param[in]   radio The handle to radio
  * @param[in] callback	The callback function to register
  * @param[in] user_data	The user data to be passed to the callback function
@@ -201,11 +545,14 @@ int radio_stop(radio_h radio);
  * @pre The radio state must be #RADIO_STATE_PLAYING by radio_start().
  * @post It invokes radio_seek_completed_cb() when seek completes.
  * @see radio_seek_down()
+ * @see radio_set_predictive_seek()
  */
 int radio_seek_up(radio_h radio,radio_seek_completed_cb callback, void *user_data );
 
 /**
  * @brief Seeks down the effective frequency of radio, asynchronously.
+ * @details When a previous scan or signal strength read found a station in this direction, the radio tunes to it
+ * directly and radio_seek_completed_cb() is invoked before this function returns. See radio_set_predictive_seek().
  * @param[in]   radio The handle to radio
  * @param[in] callback	The callback function to register
  * @param[in] user_data	The user data to be passed to the callback function
@@ -217,13 +564,65 @@ int radio_seek_up(radio_h radio,radio_seek_completed_cb callback, void *user_dat
  * @pre The radio state must be #RADIO_STATE_PLAYING by radio_start().
  * @post It invokes radio_seek_completed_cb() when seek completes.
  * @see radio_seek_up()
+ * @see radio_set_predictive_seek()
  */
 int radio_seek_down(radio_h radio,radio_seek_completed_cb callback, void *user_data );
 
+/**
+ * @brief Sets the region, which selects the band plan used by frequency validation, seek and scan.
+ * @details Every band keeps its own station list.
+ * @param[in]   radio The handle to radio
+ * @param[in]   region The region
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_STATE Invalid radio state
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY No station list can be mapped for the band
+ * @pre The radio state must be #RADIO_STATE_READY.
+ * @see radio_get_region()
+ * @see radio_get_frequency_range()
+ * @see radio_get_channel_spacing()
+ */
+int radio_set_region(radio_h radio, radio_region_e region);
+
+/**
+ * @brief Gets the region.
+ * @param[in]   radio The handle to radio
+ * @param[out]  region The region, #RADIO_REGION_EUROPE by default
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_region()
+ */
+int radio_get_region(radio_h radio, radio_region_e *region);
+
+/**
+ * @brief Gets the lowest and the highest frequency of the band plan of the region.
+ * @param[in]   radio The handle to radio
+ * @param[out]  min_frequency The lowest frequency (kHz)
+ * @param[out]  max_frequency The highest frequency (kHz)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_region()
+ */
+int radio_get_frequency_range(radio_h radio, int *min_frequency, int *max_frequency);
+
+/**
+ * @brief Gets the channel spacing of the band plan of the region.
+ * @param[in]   radio The handle to radio
+ * @param[out]  spacing The distance between two channels (kHz)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_region()
+ */
+int radio_get_channel_spacing(radio_h radio, int *spacing);
+
 /**
  * @brief Sets the radio frequency.
  * @param[in]   radio The handle to radio
- * @param[in]   percent The frequency to set [87500 ~ 108000] (kHz)
+ * @param[in]   frequency The frequency to set (kHz). It must be a channel of the band plan of the region, [87500 ~ 108000] by default.
  * @return 0 on success, otherwise a negative error value.
  * @retval #RADIO_ERROR_NONE Successful
  * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
@@ -234,8 +633,9 @@ int radio_set_frequency(radio_h radio, int frequency);
 
 /**
  * @brief Gets the current frequency of radio. 
+ * @remarks The frequency cached by the handle is returned. The tuner is accessed only when it is unknown, for example while scanning.
  * @param[in]   radio The handle to radio
- * @param[out]  frequency The current frequency [87500 ~ 108000] (kHz)
+ * @param[out]  frequency The current frequency (kHz)
  * @return 0 on success, otherwise a negative error value.
  * @retval #RADIO_ERROR_NONE Successful
  * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
@@ -268,7 +668,7 @@ int radio_get_signal_strength(radio_h radio, int *strength);
  * @retval #RADIO_ERROR_INVALID_STATE Invalid radio state
  * @pre The radio state must be #RADIO_STATE_READY by either radio_create() or radio_stop().
  * @post The radio state will be #RADIO_STATE_SCANNING during searching. After scan is completed, radio state will be #RADIO_STATE_READY.
- * @post It invokes radio_scan_updated_cb() when the scan information updates.
+ * @post It invokes radio_scan_updated_cb() when the scan information updates, for the channels of the band plan of the region.
  * @post It invokes radio_scan_completed_cb() when scan completes, if you set a callback with radio_set_scan_completed_cb().
  * @see radio_scan_stop()
  * @see radio_set_scan_completed_cb()
@@ -286,13 +686,142 @@ int radio_scan_start(radio_h radio, radio_scan_updated_cb callback, void *user_d
  * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid state
  * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
  * @retval #RADIO_ERROR_INVALID_STATE Invalid radio state
- * @pre The radio state must be #RADIO_STATE_SCANNING by radio_scan_start().
+ * @pre The radio state must be #RADIO_STATE_SCANNING by radio_scan_start(), radio_scan_range_start(), radio_scan_resume() or radio_scan_incremental_start().
  * @post It invokes radio_scan_stopped_cb() when the scan stops.
+ * @post The scan can be continued later with radio_scan_resume().
  * @post The radio state will be #RADIO_STATE_READY.
  * @see radio_scan_start()
  */
 int radio_scan_stop(radio_h radio, radio_scan_stopped_cb callback, void *user_data);
 
+/**
+ * @brief Starts scanning a part of the band, asynchronously.
+ * @details The tuner is moved from @a start_frequency to @a end_frequency by @a step and every channel whose
+ * signal strength reaches the scan threshold is reported. Only the stations of the range are updated in the station list.
+ * @param[in]   radio The handle to radio
+ * @param[in]   start_frequency The first frequency to check, a channel of the band plan of the region (kHz)
+ * @param[in]   end_frequency The last frequency to check (kHz)
+ * @param[in]   step The distance between two checked frequencies, a multiple of the channel spacing, or 0 to check every channel (kHz)
+ * @param[in] callback	The callback function to register
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @retval #RADIO_ERROR_INVALID_STATE Invalid radio state
+ * @pre The radio state must be #RADIO_STATE_READY by either radio_create() or radio_stop().
+ * @post The radio state will be #RADIO_STATE_SCANNING during searching. After scan is completed, radio state will be #RADIO_STATE_READY.
+ * @post It invokes radio_scan_updated_cb() for every station found.
+ * @post It invokes radio_scan_completed_cb() when scan completes, if you set a callback with radio_set_scan_completed_cb().
+ * @see radio_scan_stop()
+ * @see radio_scan_resume()
+ * @see radio_set_scan_threshold()
+ */
+int radio_scan_range_start(radio_h radio, int start_frequency, int end_frequency, int step, radio_scan_updated_cb callback, void *user_data);
+
+/**
+ * @brief Resumes the last scan stopped by radio_scan_stop(), asynchronously.
+ * @details The scan continues after the last frequency it checked. A stopped radio_scan_start() continues after the last station it reported.
+ * @param[in]   radio The handle to radio
+ * @param[in] callback	The callback function to register
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION There is no stopped scan to resume
+ * @retval #RADIO_ERROR_INVALID_STATE Invalid radio state
+ * @pre The radio state must be #RADIO_STATE_READY.
+ * @post The radio state will be #RADIO_STATE_SCANNING during searching. After scan is completed, radio state will be #RADIO_STATE_READY.
+ * @see radio_scan_range_start()
+ * @see radio_scan_stop()
+ */
+int radio_scan_resume(radio_h radio, radio_scan_updated_cb callback, void *user_data);
+
+/**
+ * @brief Checks again the stations of the station list and their neighbour channels, asynchronously.
+ * @details This refreshes the station list in a fraction of the time of a full scan.
+ * Stations which are not found anymore are removed from the station list when the scan completes.
+ * @param[in]   radio The handle to radio
+ * @param[in] callback	The callback function to register
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @retval #RADIO_ERROR_INVALID_STATE Invalid radio state
+ * @pre The radio state must be #RADIO_STATE_READY.
+ * @post The radio state will be #RADIO_STATE_SCANNING during searching. After scan is completed, radio state will be #RADIO_STATE_READY.
+ * @see radio_foreach_station()
+ * @see radio_scan_stop()
+ */
+int radio_scan_incremental_start(radio_h radio, radio_scan_updated_cb callback, void *user_data);
+
+/**
+ * @brief Sets the minimum signal strength of a station for radio_scan_range_start(), radio_scan_resume(), radio_scan_incremental_start()
+ * and predictive seeks.
+ * @param[in]   radio The handle to radio
+ * @param[in]   strength The minimum signal strength (dbuV)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ */
+int radio_set_scan_threshold(radio_h radio, int strength);
+
+/**
+ * @brief Enables or disables predictive seeks.
+ * @details The radio keeps the last signal strength of every channel measured by scans and radio_get_signal_strength().
+ * With predictive seeks, radio_seek_up() and radio_seek_down() tune directly to the next channel which reached the
+ * scan threshold and confirm it with a single signal strength read. The tuner's own seek is only used when
+ * no such channel is known or the station is gone. Predictive seeks are enabled by default.
+ * @param[in]   radio The handle to radio
+ * @param[in]   enable @c true to enable predictive seeks, @c false to always use the tuner's seek
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_seek_up()
+ * @see radio_seek_down()
+ * @see radio_set_scan_threshold()
+ */
+int radio_set_predictive_seek(radio_h radio, bool enable);
+
+/**
+ * @brief Retrieves the stations found by previous scans, in ascending frequency order.
+ * @details The station list is stored on disk and restored when the handle is created,
+ * so it is available before any scan. Scans add new stations as they are reported
+ * and a completed scan removes the stations it did not find.
+ * @param[in]   radio The handle to radio
+ * @param[in] callback	The callback function to invoke
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @post It invokes radio_station_cb() for every station.
+ * @see radio_get_station_count()
+ * @see radio_clear_stations()
+ */
+int radio_foreach_station(radio_h radio, radio_station_cb callback, void *user_data);
+
+/**
+ * @brief Gets the number of stations in the station list.
+ * @param[in]   radio The handle to radio
+ * @param[out]  count The number of stations
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_foreach_station()
+ */
+int radio_get_station_count(radio_h radio, int *count);
+
+/**
+ * @brief Removes all the stations from the station list.
+ * @param[in]   radio The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_foreach_station()
+ */
+int radio_clear_stations(radio_h radio);
+
 /**
  * @brief Sets the radio's mute status.
  * @details  If the mute status is @c true, no sounds will be played. If @c false, sounds will be played. Until this function is called, by default the radio is not muted.
@@ -345,6 +874,36 @@ int radio_set_scan_completed_cb(radio_h radio, radio_scan_completed_cb callback,
  */
 int radio_unset_scan_completed_cb(radio_h radio);
 
+/**
+ * @brief Registers a callback function to be invoked with the stations found by scans, in batches.
+ * @details The stations found by a scan are collected and delivered together when @a max_count stations are pending,
+ * when the oldest pending station was found @a max_latency_ms ago or more, and before the scan stops or completes.
+ * The latency is checked when the scan reports a station and, for scans done in software, on every channel.
+ * It applies to every scan started by radio_scan_start(), radio_scan_range_start(), radio_scan_resume()
+ * and radio_scan_incremental_start(), alongside radio_scan_updated_cb().
+ * @param[in] radio	The handle to radio
+ * @param[in] max_count	The maximum number of stations of a batch, 0 for no limit
+ * @param[in] max_latency_ms	The maximum time a station is held back (milliseconds), 0 for no limit
+ * @param[in] callback	The callback function to register
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @post  radio_scan_batch_cb() will be invoked
+ * @see radio_unset_scan_batch_cb()
+ */
+int radio_set_scan_batch_cb(radio_h radio, int max_count, int max_latency_ms, radio_scan_batch_cb callback, void *user_data);
+
+/**
+ * @brief	Unregisters the callback function. Pending stations are dropped.
+ * @param[in] radio The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_scan_batch_cb()
+ */
+int radio_unset_scan_batch_cb(radio_h radio);
+
 /**
  * @brief Registers a callback function to be invoked when the radio is interrupted.
  * @param[in] radio	The handle to radio
@@ -372,6 +931,703 @@ int radio_set_interrupted_cb(radio_h radio, radio_interrupted_cb callback, void
  */
 int radio_unset_interrupted_cb(radio_h radio);
 
+/**
+ * @brief Registers a callback function to be invoked when the signal strength changes.
+ * @details The signal strength is sampled every @a interval_ms while the radio state is #RADIO_STATE_PLAYING,
+ * and sampling stops in any other state. The first sample after the radio starts playing is reported with
+ * #RADIO_SIGNAL_STRENGTH_BELOW_THRESHOLD or #RADIO_SIGNAL_STRENGTH_ABOVE_THRESHOLD. After that, the callback is
+ * invoked when the signal strength drops below @a threshold, when it rises back to @a threshold + @a hysteresis,
+ * or when it moves by @a delta or more since the last call. Registering again replaces the previous callback and parameters.
+ * @param[in] radio	The handle to radio
+ * @param[in] interval_ms	The sampling interval (milliseconds)
+ * @param[in] threshold	The signal strength threshold (dbuV)
+ * @param[in] hysteresis	The margin above @a threshold needed to report the signal back, 0 or more
+ * @param[in] delta	The minimum change reported with #RADIO_SIGNAL_STRENGTH_CHANGED, 0 to report threshold crossings only
+ * @param[in] callback	The callback function to register
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @post  radio_signal_strength_changed_cb() will be invoked
+ * @see radio_unset_signal_strength_changed_cb()
+ * @see radio_get_signal_strength()
+ */
+int radio_set_signal_strength_changed_cb(radio_h radio, int interval_ms, int threshold, int hysteresis, int delta,
+	radio_signal_strength_changed_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the callback function and stops sampling the signal strength.
+ * @param[in] radio The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_signal_strength_changed_cb()
+ */
+int radio_unset_signal_strength_changed_cb(radio_h radio);
+
+/**
+ * @brief Sets the alternate frequencies of the current station, watched by radio_set_alternate_frequency_cb().
+ * @details The list replaces the previous one, the current frequency is skipped if it is part of it.
+ * @param[in] radio	The handle to radio
+ * @param[in] frequencies	The alternate frequencies (kHz) on the band plan of the region, can be NULL when @a count is 0
+ * @param[in] count	The number of frequencies, from 0 to clear the list to 16
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_alternate_frequency_cb()
+ */
+int radio_set_alternate_frequencies(radio_h radio, const int *frequencies, int count);
+
+/**
+ * @brief Registers a callback function to be invoked when an alternate frequency is received clearly better.
+ * @details While the radio state is #RADIO_STATE_PLAYING, the tuner is moved to one of the alternate frequencies for a short
+ * window from time to time, to measure its signal strength and the current one, and moved back. The audio is interrupted
+ * during the windows, which take at most @a tuner_share percent of the time. No window is taken in the second following
+ * a frequency change or a state change. An alternate frequency is reported when it beats the current one by @a margin
+ * on two windows in a row. With @a auto_switch, the radio is moved to it first and the former frequency becomes an alternate.
+ * Registering again replaces the previous callback and parameters.
+ * @param[in] radio	The handle to radio
+ * @param[in] margin	The signal strength an alternate frequency must have above the current one (dbuV), more than 0
+ * @param[in] tuner_share	The share of the time the tuner may spend on alternate frequencies, from 1 to 50 percent
+ * @param[in] auto_switch	True to move the radio to a better alternate frequency, false to report it only
+ * @param[in] callback	The callback function to register
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @post  radio_alternate_frequency_cb() will be invoked
+ * @see radio_set_alternate_frequencies()
+ * @see radio_unset_alternate_frequency_cb()
+ */
+int radio_set_alternate_frequency_cb(radio_h radio, int margin, int tuner_share, bool auto_switch,
+	radio_alternate_frequency_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the callback function and stops watching the alternate frequencies.
+ * @param[in] radio The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_alternate_frequency_cb()
+ */
+int radio_unset_alternate_frequency_cb(radio_h radio);
+
+/**
+ * @brief Sets the radio frequency without waiting for the tuner.
+ * @details The commands of the asynchronous functions run one by one, in the order they were queued, on an internal thread.
+ * When the last queued command which has not run yet is also a frequency change, it is replaced by this one : only the
+ * newest of several quick frequency changes reaches the tuner. The replaced ones complete with #RADIO_ERROR_CANCELLED
+ * before the next command runs.
+ * Commands still queued when the handle is destroyed are dropped without being reported.
+ * @param[in] radio	The handle to radio
+ * @param[in] frequency	The frequency to set (kHz), on the band plan of the region
+ * @param[in] callback	The callback function invoked when the command has run, or @c NULL
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Too many queued commands
+ * @post radio_command_completed_cb() will be invoked
+ * @see radio_set_frequency()
+ */
+int radio_set_frequency_async(radio_h radio, int frequency, radio_command_completed_cb callback, void *user_data);
+
+/**
+ * @brief Queues radio_start() behind the pending asynchronous commands.
+ * @param[in] radio	The handle to radio
+ * @param[in] callback	The callback function invoked when the command has run, or @c NULL
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Too many queued commands
+ * @post radio_command_completed_cb() will be invoked
+ * @see radio_set_frequency_async()
+ */
+int radio_start_async(radio_h radio, radio_command_completed_cb callback, void *user_data);
+
+/**
+ * @brief Queues radio_stop() behind the pending asynchronous commands.
+ * @param[in] radio	The handle to radio
+ * @param[in] callback	The callback function invoked when the command has run, or @c NULL
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Too many queued commands
+ * @post radio_command_completed_cb() will be invoked
+ * @see radio_set_frequency_async()
+ */
+int radio_stop_async(radio_h radio, radio_command_completed_cb callback, void *user_data);
+
+/**
+ * @brief Queues radio_seek_up() behind the pending asynchronous commands.
+ * @details The command completes when the seek has found a station, the next command runs after that.
+ * @param[in] radio	The handle to radio
+ * @param[in] callback	The callback function invoked with the station found, or @c NULL
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Too many queued commands
+ * @post radio_command_completed_cb() will be invoked
+ * @see radio_set_frequency_async()
+ */
+int radio_seek_up_async(radio_h radio, radio_command_completed_cb callback, void *user_data);
+
+/**
+ * @brief Queues radio_seek_down() behind the pending asynchronous commands.
+ * @details The command completes when the seek has found a station, the next command runs after that.
+ * @param[in] radio	The handle to radio
+ * @param[in] callback	The callback function invoked with the station found, or @c NULL
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Too many queued commands
+ * @post radio_command_completed_cb() will be invoked
+ * @see radio_set_frequency_async()
+ */
+int radio_seek_down_async(radio_h radio, radio_command_completed_cb callback, void *user_data);
+
+/**
+ * @brief Sets the main context on which the callbacks of the radio are invoked.
+ * @details By default, the callbacks are invoked on the internal thread which reports the event. Once a context is set,
+ * the events are queued and the callbacks run on the thread iterating the context, from a single source attached to it.
+ * The queue is bounded : when the context does not keep up, the newest events are dropped and a warning is logged.
+ * A signal strength change still queued is replaced by the next one. A scan batch still queued is merged with the next one.
+ * Replacing or unsetting a callback drops its queued events.
+ * @param[in] radio	The handle to radio
+ * @param[in] context	The context to deliver the events on, or @c NULL to invoke the callbacks directly again
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @remarks The events still queued when the context is replaced, or when the handle is destroyed, are dropped.
+ */
+int radio_set_event_context(radio_h radio, GMainContext *context);
+
+/**
+ * @brief Adds a listener of the stations found by the scans, next to the callback given to radio_scan_start().
+ * @details Up to 8 listeners of each event can be added, each one is removed with the identifier it was given.
+ * @param[in] radio	The handle to radio
+ * @param[in] callback	The callback function to invoke
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @param[out] id	The identifier of the listener, for radio_remove_cb()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY 8 listeners of the event were added already, or the listeners are being replaced too often
+ * @remarks The listeners are invoked before the callback of radio_scan_start(), radio_destroy() must not be called from them.
+ * @see radio_remove_cb()
+ */
+int radio_add_scan_updated_cb(radio_h radio, radio_scan_updated_cb callback, void *user_data, int *id);
+
+/**
+ * @brief Adds a listener of the scan completion, next to the callback set by radio_set_scan_completed_cb().
+ * @details Up to 8 listeners of each event can be added, each one is removed with the identifier it was given.
+ * @param[in] radio	The handle to radio
+ * @param[in] callback	The callback function to invoke
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @param[out] id	The identifier of the listener, for radio_remove_cb()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY 8 listeners of the event were added already, or the listeners are being replaced too often
+ * @remarks The listeners are invoked before the callback of radio_set_scan_completed_cb(), radio_destroy() must not be called from them.
+ * @see radio_remove_cb()
+ */
+int radio_add_scan_completed_cb(radio_h radio, radio_scan_completed_cb callback, void *user_data, int *id);
+
+/**
+ * @brief Adds a listener of the interruptions, next to the callback set by radio_set_interrupted_cb().
+ * @details Up to 8 listeners of each event can be added, each one is removed with the identifier it was given.
+ * Components sharing a handle add their own listener instead of replacing each other's radio_set_interrupted_cb().
+ * @param[in] radio	The handle to radio
+ * @param[in] callback	The callback function to invoke
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @param[out] id	The identifier of the listener, for radio_remove_cb()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY 8 listeners of the event were added already, or the listeners are being replaced too often
+ * @remarks The listeners are invoked before the callback of radio_set_interrupted_cb(), radio_destroy() must not be called from them.
+ * @see radio_remove_cb()
+ */
+int radio_add_interrupted_cb(radio_h radio, radio_interrupted_cb callback, void *user_data, int *id);
+
+/**
+ * @brief Removes a listener added by radio_add_scan_updated_cb(), radio_add_scan_completed_cb() or radio_add_interrupted_cb().
+ * @details The listener may still run once if its event is being delivered, never after that.
+ * It can be removed from its own callback.
+ * @param[in] radio	The handle to radio
+ * @param[in] id	The identifier of the listener
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter or unknown identifier
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY The listeners are being replaced too often
+ */
+int radio_remove_cb(radio_h radio, int id);
+
+/**
+ * @brief Sets the inactivity period after which the tuner device of a ready radio is released.
+ * @details When the radio stays in #RADIO_STATE_READY without using the device for @a timeout_ms, the device is closed
+ * while the handle and its state are kept. radio_start(), the scans, radio_set_frequency(), radio_get_signal_strength()
+ * and radio_refresh() open it again and restore the frequency and mute status in the same step.
+ * When that fails, the call returns the error and the device stays released until the next one.
+ * radio_set_mute() only updates the cached status meanwhile.
+ * @param[in] radio	The handle to radio
+ * @param[in] timeout_ms	The inactivity period in milliseconds, at least 100, or 0 to keep the device open (default)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @remarks The first call which opens the device again takes longer, see the "device:resume" entry of radio_foreach_statistics().
+ */
+int radio_set_idle_timeout(radio_h radio, int timeout_ms);
+
+/**
+ * @brief Gets the state, frequency, signal strength, mute status, scan progress and last interruption in one call.
+ * @details The status is served from values cached by the handle, it does not access the tuner.
+ * All the fields are read from the same instant : the frequency is the one of @a state, the signal strength the one of @a frequency.
+ * @param[in] radio	The handle to radio
+ * @param[out] status	The status
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_get_state()
+ * @see radio_get_frequency()
+ * @see radio_get_signal_strength()
+ * @see radio_is_muted()
+ */
+int radio_get_status(radio_h radio, radio_status_s *status);
+
+/**
+ * @brief Gets a file descriptor which becomes readable when events are pending for radio_read_events().
+ * @details The events are recorded from the first call on, alongside the callbacks which keep working as before.
+ * The descriptor is non-blocking and can be polled with poll() or epoll in level-triggered mode.
+ * It belongs to the handle : it must not be read nor closed by the caller, radio_destroy() closes it.
+ * @param[in] radio	The handle to radio
+ * @param[out] fd	The file descriptor
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Failed to create the descriptor
+ * @see radio_read_events()
+ */
+int radio_get_event_fd(radio_h radio, int *fd);
+
+/**
+ * @brief Reads the pending events, oldest first, without blocking.
+ * @details Up to 256 events are kept. When they are not read in time, the newest events are dropped and the next read
+ * starts with a #RADIO_EVENT_OVERFLOW event. The descriptor stays readable while events are left.
+ * @param[in] radio	The handle to radio
+ * @param[out] events	The array to fill
+ * @param[in] max_count	The size of @a events
+ * @param[out] count	The number of events read, 0 when none is pending
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION radio_get_event_fd() was not called
+ * @see radio_get_event_fd()
+ */
+int radio_read_events(radio_h radio, radio_event_s *events, int max_count, int *count);
+
+/**
+ * @brief Starts copying the tuner audio into a ring of periods in shared memory.
+ * @details The audio is captured while the radio state is #RADIO_STATE_PLAYING, @a period_frames frames at a time.
+ * The ring keeps the last @a period_count periods. The capture never waits for the readers : a reader which falls behind
+ * by more than @a period_count - 1 periods loses the oldest ones.
+ * @param[in] radio	The handle to radio
+ * @param[in] period_frames	The frames of a period, from 1 to 8192
+ * @param[in] period_count	The periods of the ring, a power of two from 2 to 1024
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION The tuner does not provide its audio, or the shared memory could not be created
+ * @retval #RADIO_ERROR_INVALID_STATE The tap is already started
+ * @see radio_pcm_tap_stop()
+ * @see radio_pcm_reader_create()
+ */
+int radio_pcm_tap_start(radio_h radio, int period_frames, int period_count);
+
+/**
+ * @brief Stops the audio tap.
+ * @details Waiting readers are woken up, radio_pcm_reader_acquire() returns #RADIO_ERROR_INVALID_STATE once they read
+ * the last period. radio_destroy() stops the tap too.
+ * @param[in] radio	The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_pcm_tap_start()
+ */
+int radio_pcm_tap_stop(radio_h radio);
+
+/**
+ * @brief Gets the shared memory descriptor of the audio tap, to be passed to another process.
+ * @details It belongs to the handle : it must not be closed by the caller, radio_pcm_tap_stop() closes it.
+ * The other process opens its reader with radio_pcm_reader_create_from_fd().
+ * @param[in] radio	The handle to radio
+ * @param[out] fd	The file descriptor
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_STATE The tap is not started
+ * @see radio_pcm_tap_start()
+ */
+int radio_pcm_tap_get_fd(radio_h radio, int *fd);
+
+/**
+ * @brief Creates a reader of the audio tap of a radio, starting with the next period.
+ * @details Any number of readers can read the tap, each one at its own pace. A reader keeps its own mapping of the ring,
+ * it stays valid after the tap is stopped. The readers come from a fixed pool of 64 per process, shared with the
+ * time-shift, the recording and the level meter of every handle.
+ * @param[in] radio	The handle to radio
+ * @param[out] reader	The reader
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY Every reader of the pool is in use
+ * @retval #RADIO_ERROR_INVALID_STATE The tap is not started
+ * @see radio_pcm_reader_destroy()
+ */
+int radio_pcm_reader_create(radio_h radio, radio_pcm_reader_h *reader);
+
+/**
+ * @brief Creates a reader of an audio tap from its shared memory descriptor, starting with the next period.
+ * @details The descriptor is duplicated, it can be closed once the reader is created.
+ * @param[in] fd	The descriptor returned by radio_pcm_tap_get_fd() in the process of the radio
+ * @param[out] reader	The reader
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER @a fd is not the descriptor of an audio tap
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY Every reader of the pool is in use, or @a fd cannot be duplicated
+ * @see radio_pcm_reader_destroy()
+ */
+int radio_pcm_reader_create_from_fd(int fd, radio_pcm_reader_h *reader);
+
+/**
+ * @brief Destroys a reader, releasing the period it holds.
+ * @param[in] reader	The reader
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ */
+int radio_pcm_reader_destroy(radio_pcm_reader_h reader);
+
+/**
+ * @brief Gets the format of the audio read by a reader.
+ * @param[in] reader	The reader
+ * @param[out] sample_rate	The sample rate (Hz)
+ * @param[out] channels	The number of channels
+ * @param[out] period_frames	The frames of a period
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ */
+int radio_pcm_reader_get_format(radio_pcm_reader_h reader, int *sample_rate, int *channels, int *period_frames);
+
+/**
+ * @brief Gets the next period of audio, in place in the ring.
+ * @details When the reader fell behind, the periods already overwritten are skipped and counted in @a period->lost.
+ * The frames stay in the ring : the capture may overwrite them while they are read, which radio_pcm_reader_release() tells.
+ * A reader holds at most one period, the previous one is released first.
+ * @param[in] reader	The reader
+ * @param[in] timeout_ms	The time to wait for the next period (ms), 0 to return at once, -1 to wait until it comes
+ * @param[out] period	The period
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION No period came within @a timeout_ms
+ * @retval #RADIO_ERROR_INVALID_STATE The tap was stopped and every period was read
+ * @see radio_pcm_reader_release()
+ */
+int radio_pcm_reader_acquire(radio_pcm_reader_h reader, int timeout_ms, radio_pcm_period_s *period);
+
+/**
+ * @brief Releases the period returned by radio_pcm_reader_acquire().
+ * @param[in] reader	The reader
+ * @param[out] overrun	Set to true when the capture overwrote the period before it was released, its frames are then
+ * not reliable. Can be NULL.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION The reader holds no period
+ * @see radio_pcm_reader_acquire()
+ */
+int radio_pcm_reader_release(radio_pcm_reader_h reader, bool *overrun);
+
+/**
+ * @brief Starts recording the tuner audio into a time-shift buffer, so that it can be paused and played back later.
+ * @details The audio of the tap is written to a file of fixed size used as a ring : once full, the oldest audio is
+ * overwritten. The audio is written a batch of pages at a time and is readable about a third of a second after it
+ * was captured. The file is mapped in memory, it is kept when the time-shift stops.
+ * The playback position starts live. It moves with radio_timeshift_read() only : the application plays the audio
+ * it returns, and mutes the radio with radio_set_mute() meanwhile.
+ * @remarks The batch of frames staged before the file is allocated here, sized by the format of the tap, and freed by
+ * radio_timeshift_stop() : it is the only heap allocation of a handle besides those of radio_recording_start(), the
+ * capture itself never allocates.
+ * @param[in] radio	The handle to radio
+ * @param[in] path	The file of the buffer, created or truncated
+ * @param[in] seconds	The duration of audio kept, from 1 to 14400 seconds
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter, or @a path cannot be created
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY The file cannot be sized or mapped
+ * @retval #RADIO_ERROR_INVALID_STATE The tap is not started, or the time-shift is already started
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @pre radio_pcm_tap_start()
+ * @see radio_timeshift_stop()
+ */
+int radio_timeshift_start(radio_h radio, const char *path, int seconds);
+
+/**
+ * @brief Stops the time-shift, the audio buffered so far can no longer be read.
+ * @details radio_destroy() stops the time-shift too.
+ * @param[in] radio	The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_timeshift_start()
+ */
+int radio_timeshift_stop(radio_h radio);
+
+/**
+ * @brief Pauses the time-shift playback : radio_timeshift_read() returns no audio until radio_timeshift_resume().
+ * @details The recording goes on. A playback position which the recording overwrites moves on to the oldest audio left.
+ * @param[in] radio	The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_STATE The time-shift is not started
+ * @see radio_timeshift_resume()
+ */
+int radio_timeshift_pause(radio_h radio);
+
+/**
+ * @brief Resumes the time-shift playback from where it was paused.
+ * @param[in] radio	The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_STATE The time-shift is not started
+ * @see radio_timeshift_pause()
+ */
+int radio_timeshift_resume(radio_h radio);
+
+/**
+ * @brief Moves the time-shift playback to the audio captured @a delay_ms ago.
+ * @details The position is looked up in constant time from an index of the capture time, with a second of granularity
+ * refined from the sample rate. A delay beyond the buffer moves to the oldest audio, 0 catches up with live.
+ * While the radio was not playing, no audio was recorded : a delay in such a gap moves to where the audio resumed.
+ * @param[in] radio	The handle to radio
+ * @param[in] delay_ms	The delay behind live (ms), 0 for live
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_STATE The time-shift is not started
+ * @see radio_timeshift_get_position()
+ */
+int radio_timeshift_seek(radio_h radio, int delay_ms);
+
+/**
+ * @brief Gets the time-shift playback position.
+ * @param[in] radio	The handle to radio
+ * @param[out] delay_ms	The audio between the playback position and live (ms)
+ * @param[out] buffered_ms	The audio in the buffer (ms)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_STATE The time-shift is not started
+ * @see radio_timeshift_seek()
+ */
+int radio_timeshift_get_position(radio_h radio, int *delay_ms, int *buffered_ms);
+
+/**
+ * @brief Reads the audio at the time-shift playback position and moves the position past it, without blocking.
+ * @details The frames have the format of the tap, see radio_pcm_reader_get_format().
+ * @param[in] radio	The handle to radio
+ * @param[out] frames	The interleaved 16-bit samples
+ * @param[in] frame_count	The frames @a frames can hold
+ * @param[out] read_count	The frames read, 0 when paused or live
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_STATE The time-shift is not started
+ */
+int radio_timeshift_read(radio_h radio, short *frames, int frame_count, int *read_count);
+
+/**
+ * @brief Starts recording the tuner audio to a WAV file.
+ * @details The recording reads the tap on a thread of its own, converts the audio to @a sample_rate and encodes it
+ * into a fixed pool of buffers, which another thread writes to the file. A slow file never holds back the tuner : when
+ * every buffer waits for the file, the periods of the tap are missed and counted in
+ * radio_recording_status_s::frames_dropped. The file is complete once radio_recording_stop() returns.
+ * @remarks The conversion buffers and the pool of buffers are allocated here, sized by the format of the tap and of the
+ * file, and freed by radio_recording_stop() : the capture and the writer never allocate.
+ * @param[in] radio	The handle to radio
+ * @param[in] path	The file, created or truncated
+ * @param[in] format	The format of the file
+ * @param[in] sample_rate	The sample rate of the file from 8000 to 96000 Hz, 0 for the rate of the tap
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter, or @a path cannot be created
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #RADIO_ERROR_INVALID_STATE The tap is not started, or a recording is already running
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @pre radio_pcm_tap_start()
+ * @see radio_recording_stop()
+ */
+int radio_recording_start(radio_h radio, const char *path, radio_recording_format_e format, int sample_rate);
+
+/**
+ * @brief Stops the recording, encodes the audio captured so far and completes the file.
+ * @details radio_destroy() stops the recording too. Stopping the tap ends the recording, which still has to be stopped.
+ * @param[in] radio	The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_recording_start()
+ */
+int radio_recording_stop(radio_h radio);
+
+/**
+ * @brief Gets the status of the running or the last recording.
+ * @param[in] radio	The handle to radio
+ * @param[out] status	The status
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_recording_start()
+ */
+int radio_recording_get_status(radio_h radio, radio_recording_status_s *status);
+
+/**
+ * @brief Registers a callback function to be invoked when RDS metadata is received, and starts decoding RDS.
+ * @details While the radio state is #RADIO_STATE_PLAYING, the RDS blocks of the tuner are checked, short error bursts are
+ * corrected and the groups are decoded on an internal thread. The program service name is reported once each of its
+ * segments was received twice alike, the RadioText once all of its segments were received, the alternate frequencies
+ * once the list announced is complete. The metadata is kept per frequency for the lifetime of the handle, for the 32 most
+ * recently heard stations : after a retune, what is known of the new station is reported at once.
+ * Registering again replaces the previous callback.
+ * @param[in] radio	The handle to radio
+ * @param[in] callback	The callback function to register
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION The tuner does not provide RDS
+ * @post  radio_rds_changed_cb() will be invoked
+ * @see radio_unset_rds_changed_cb()
+ * @see radio_get_rds_info()
+ */
+int radio_set_rds_changed_cb(radio_h radio, radio_rds_changed_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the callback function and stops decoding RDS. The metadata received so far is kept.
+ * @param[in] radio The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_rds_changed_cb()
+ */
+int radio_unset_rds_changed_cb(radio_h radio);
+
+/**
+ * @brief Gets the RDS metadata received on a frequency.
+ * @param[in] radio	The handle to radio
+ * @param[in] frequency	The frequency (kHz), 0 for the current one
+ * @param[out] info	The metadata, with no field when nothing is known of @a frequency
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_set_rds_changed_cb()
+ */
+int radio_get_rds_info(radio_h radio, int frequency, radio_rds_info_s *info);
+
+/**
+ * @brief Starts measuring the level of the tuner audio, for level meters and the detection of dead air.
+ * @details The meter reads the tap on a thread of its own and measures the peak and the RMS level of every window of
+ * @a interval_ms, along with how long the audio has stayed at or below @a silence_level. The last window is read with
+ * radio_level_meter_get() and, when @a callback is not NULL, delivered to it.
+ * @param[in] radio	The handle to radio
+ * @param[in] interval_ms	The length of a window (ms), from 10 to 10000, rounded up to whole periods of the tap
+ * @param[in] silence_level	The largest magnitude of a silent sample, from 0 to 32767
+ * @param[in] callback	The callback function to register, or NULL to poll the level
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_STATE The tap is not started, or the meter is already running
+ * @retval #RADIO_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #RADIO_ERROR_INVALID_OPERATION Invalid operation
+ * @pre radio_pcm_tap_start()
+ * @see radio_level_meter_stop()
+ * @see radio_level_meter_get()
+ */
+int radio_level_meter_start(radio_h radio, int interval_ms, int silence_level, radio_level_cb callback, void *user_data);
+
+/**
+ * @brief Stops the level meter. The level of the last window is kept.
+ * @details No callback is invoked once it returns. radio_destroy() stops the meter too. Stopping the tap ends the
+ * metering, which still has to be stopped. Without an event context, it must not be called from radio_level_cb().
+ * @param[in] radio	The handle to radio
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_level_meter_start()
+ */
+int radio_level_meter_stop(radio_h radio);
+
+/**
+ * @brief Gets the level of the last window of the level meter.
+ * @details It takes no lock and never blocks, it can be polled by every frame of a user interface.
+ * @param[in] radio	The handle to radio
+ * @param[out] level	The level
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see radio_level_meter_start()
+ */
+int radio_level_meter_get(radio_h radio, radio_level_s *level);
+
+/**
+ * @brief Writes the recent internal events of the radio handle to a file descriptor, one line of text each.
+ * @details Every message from the tuner, callback registration, state change and tuner error is recorded in a fixed-size
+ * binary ring per handle. The oldest events are overwritten. Each line starts with the monotonic time of the event in seconds.
+ * @param[in] radio	The handle to radio
+ * @param[in] fd	The file descriptor to write to
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #RADIO_ERROR_INVALID_OPERATION Failed to write to @a fd
+ */
+int radio_dump_trace(radio_h radio, int fd);
+
+/**
+ * @brief Retrieves the call statistics of every API function and message type used since the last reset.
+ * @details Every public function and every message from the tuner is counted and timed in a log-scale histogram.
+ * Functions and message types which were not used are skipped.
+ * @param[in] callback	The callback function to invoke
+ * @param[in] user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @retval #RADIO_ERROR_INVALID_PARAMETER Invalid parameter
+ * @post  radio_statistics_cb() will be invoked
+ * @see radio_reset_statistics()
+ */
+int radio_foreach_statistics(radio_statistics_cb callback, void *user_data);
+
+/**
+ * @brief Clears the call statistics.
+ * @remarks Calls running concurrently may be partly counted.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #RADIO_ERROR_NONE Successful
+ * @see radio_foreach_statistics()
+ */
+int radio_reset_statistics(void);
+
 /**
  * @}
  */
@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_BACKEND_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_BACKEND_PRIVATE_H__
+#include <stdbool.h>
+#include <stdint.h>
+#include <mm_radio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+* Tuner backend operations.
+* Every entry follows the mm_radio_* calling convention : MM_ERROR_* codes are returned
+* and messages are posted through the registered MMMessageCallback.
+*/
+typedef struct {
+	const char *name;
+	int (*create)(MMHandleType *backend);
+	int (*destroy)(MMHandleType backend);
+	int (*realize)(MMHandleType backend);
+	int (*unrealize)(MMHandleType backend);
+	int (*set_message_callback)(MMHandleType backend, MMMessageCallback callback, void *user_param);
+	int (*get_state)(MMHandleType backend, MMRadioStateType *state);
+	int (*start)(MMHandleType backend);
+	int (*stop)(MMHandleType backend);
+	int (*seek)(MMHandleType backend, MMRadioSeekDirectionType direction);
+	int (*set_frequency)(MMHandleType backend, int frequency);
+	int (*get_frequency)(MMHandleType backend, int *frequency);
+	int (*scan_start)(MMHandleType backend);
+	int (*scan_stop)(MMHandleType backend);
+	int (*set_mute)(MMHandleType backend, bool muted);
+	int (*get_signal_strength)(MMHandleType backend, int *strength);
+	/* Audio of the tuner as interleaved 16-bit frames, both NULL when the backend does not expose it */
+	int (*get_pcm_format)(MMHandleType backend, int *sample_rate, int *channels);
+	/* Blocks until frame_count frames are captured, MM_ERROR_RADIO_NO_OP when the tuner is not playing */
+	int (*read_pcm)(MMHandleType backend, short *frames, int frame_count);
+	/*
+	* RDS of the tuned station as 26-bit blocks, in the order received. Waits for about count blocks and returns the blocks
+	* received meanwhile, none when the station has no RDS. MM_ERROR_RADIO_NO_OP when the tuner is not playing, NULL when
+	* the backend does not provide RDS.
+	*/
+	int (*read_rds)(MMHandleType backend, uint32_t *blocks, int count, int *read_count);
+} _radio_backend_s;
+
+/* mm-radio backend, used by default */
+extern const _radio_backend_s _radio_backend_mm;
+
+const _radio_backend_s *_radio_backend_get_default(void);
+
+/*
+* Deterministic software tuner, for benchmarks and tests without tuner hardware.
+* It is only built into the static library of radio_test and radio_bench, along with _radio_backend_set_default().
+*/
+#ifdef RADIO_BACKEND_MOCK
+extern const _radio_backend_s _radio_backend_mock;
+
+#define _RADIO_MOCK_MAX_STATIONS	64
+
+typedef struct {
+	int frequency;	/* kHz */
+	int rssi;		/* dBuV */
+	int rds_first;	/* first block of the station in rds_file */
+	int rds_count;	/* blocks of the station, played in a loop while it is tuned, 0 without RDS */
+} _radio_mock_station_s;
+
+typedef struct {
+	int band_min;				/* lowest channel of the synthetic band (kHz) */
+	int band_max;				/* highest channel of the synthetic band (kHz) */
+	int band_step;				/* channel spacing (kHz) */
+	int noise_rssi;				/* RSSI reported on channels without a station */
+	int seek_delay_ms;			/* time spent by each seek before SEEK_FINISH is posted */
+	int scan_step_delay_us;		/* time spent on each channel during a scan */
+	int station_count;
+	_radio_mock_station_s stations[_RADIO_MOCK_MAX_STATIONS];
+	char pcm_file[256];			/* raw interleaved 16-bit PCM played in a loop while playing, empty for no audio */
+	int pcm_sample_rate;		/* Hz */
+	int pcm_channels;
+	bool pcm_unpaced;			/* audio is captured as fast as it is read instead of in real time */
+	char rds_file[256];			/* RDS blocks of the stations, one 32-bit word each in host order, empty for no RDS */
+	bool rds_unpaced;			/* blocks are received as fast as they are read instead of at 1187.5 bit/s */
+} _radio_mock_config_s;
+
+/**
+ * Selects the backend used by subsequent radio_create() calls.
+ * Handles which are already created keep their backend.
+ */
+int _radio_backend_set_default(const _radio_backend_s *backend);
+
+/**
+ * Replaces the synthetic band of the mock backend. It is applied to mock instances created afterwards.
+ */
+int _radio_mock_set_config(const _radio_mock_config_s *config);
+
+void _radio_mock_get_config(_radio_mock_config_s *config);
+
+/**
+ * Makes the next count realizes of the mock instances fail with MM_ERROR_RADIO_INTERNAL, 0 to stop.
+ */
+void _radio_mock_fail_realize(int count);
+
+/**
+ * Makes the worker of every mock instance post MM_MESSAGE_STATE_INTERRUPTED with code, as the sound manager does.
+ * The tuner keeps its state, a running hardware scan or seek posts it once it ends.
+ */
+void _radio_mock_interrupt(int code);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_BACKEND_PRIVATE_H__
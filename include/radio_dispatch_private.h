@@ -0,0 +1,84 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_DISPATCH_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_DISPATCH_PRIVATE_H__
+#include <stdbool.h>
+#include <glib.h>
+#include <radio.h>
+#include <radio_station_cache_private.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* must be powers of two */
+#define _RADIO_DISPATCH_ENTRIES		256
+#define _RADIO_DISPATCH_STATIONS	(_RADIO_STATION_CACHE_MAX * 2)
+
+typedef enum {
+	_RADIO_DISPATCH_NONE,				/* purged, skipped by the dispatch */
+	_RADIO_DISPATCH_SCAN_INFO,			/* args : frequency */
+	_RADIO_DISPATCH_SCAN_STOP,
+	_RADIO_DISPATCH_SCAN_FINISH,
+	_RADIO_DISPATCH_SEEK_FINISH,		/* args : frequency */
+	_RADIO_DISPATCH_INTERRUPT,			/* args : radio_interrupted_code_e */
+	_RADIO_DISPATCH_SCAN_BATCH,			/* stations only */
+	_RADIO_DISPATCH_SIGNAL_STRENGTH,	/* args : strength, radio_signal_strength_event_e */
+	_RADIO_DISPATCH_COMMAND,			/* args : radio_command_e, radio_error_e, frequency */
+	_RADIO_DISPATCH_READY,				/* args : radio_error_e */
+	_RADIO_DISPATCH_ALTERNATE_FREQUENCY,	/* args : frequency, strength, switched */
+	_RADIO_DISPATCH_RDS,				/* args : frequency, radio_rds_field_e which changed */
+	_RADIO_DISPATCH_LEVEL,				/* args : peak, rms, silence_ms */
+}_radio_dispatch_event_e;
+
+typedef struct {
+	_radio_dispatch_event_e event;
+	const void *callback;
+	void *user_data;
+	int args[3];
+	int station_count;		/* stations of the entry in the station ring */
+	bool coalesce;			/* may be replaced by the next entry of the same event and callback */
+}_radio_dispatch_entry_s;
+
+/* Invokes the callback of an entry on the thread of the context. The stations of a batch are contiguous. */
+typedef void (*_radio_dispatch_handler)(const _radio_dispatch_entry_s *entry, const radio_station_s *stations);
+
+/*
+* Bounded queue of events for a GMainContext.
+* The queue lives in a single GSource attached to the context, allocated once, which wakes the context up when
+* the queue stops being empty and drains it in one dispatch. Producers from any thread never allocate.
+* An entry pushed with coalesce replaces the newest queued entry when that one has the same event and callback
+* and was pushed with coalesce too. A batch pushed right behind a batch of the same callback is merged into it.
+*/
+GSource *_radio_dispatch_create(GMainContext *context, _radio_dispatch_handler handler);
+
+/* Detaches the source from its context, the queued entries are dropped. Safe from a callback of the source. */
+void _radio_dispatch_destroy(GSource *source);
+
+/* Returns false when the queue is full and the entry was dropped */
+bool _radio_dispatch_push(GSource *source, const _radio_dispatch_entry_s *entry);
+
+bool _radio_dispatch_push_stations(GSource *source, const void *callback, void *user_data, const radio_station_s *stations, int count);
+
+/* Drops the queued entries of an event registered with the given callback and user data */
+void _radio_dispatch_purge(GSource *source, _radio_dispatch_event_e event, const void *callback, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_DISPATCH_PRIVATE_H__
@@ -0,0 +1,66 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_EVENT_RING_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_EVENT_RING_PRIVATE_H__
+#include <stdint.h>
+#include <radio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* must be a power of two */
+#define _RADIO_EVENT_RING_ENTRIES	256
+
+typedef struct {
+	uint32_t seq;			/* position + 1 once the event is written, position + _RADIO_EVENT_RING_ENTRIES once it is read */
+	radio_event_s event;
+}_radio_event_cell_s;
+
+/*
+* Events read through an eventfd.
+* Bounded lock-free queue : posting claims a cell with one compare and swap and never blocks nor allocates.
+* The eventfd is written only when the queue stops being empty, so one wakeup of the reader covers many events.
+* Events posted to a full queue are dropped and reported by a RADIO_EVENT_OVERFLOW event.
+*/
+typedef struct {
+	int fd;					/* eventfd, -1 until _radio_event_ring_open() */
+	int signaled;			/* the eventfd is readable */
+	uint32_t overflow;		/* events dropped since the last read */
+	uint32_t head;			/* next position to read */
+	uint32_t tail;			/* next position to write */
+	_radio_event_cell_s cells[_RADIO_EVENT_RING_ENTRIES];
+}_radio_event_ring_s;
+
+void _radio_event_ring_init(_radio_event_ring_s *ring);
+
+/* Creates the eventfd on the first call, events are posted from then on. Returns a radio_error_e. */
+int _radio_event_ring_open(_radio_event_ring_s *ring, int *fd);
+
+void _radio_event_ring_close(_radio_event_ring_s *ring);
+
+/* Does nothing until the ring is open */
+void _radio_event_ring_post(_radio_event_ring_s *ring, radio_event_e type, int value, uint64_t timestamp);
+
+/* Reads up to max_count events, oldest first. Returns the number of events read. */
+int _radio_event_ring_read(_radio_event_ring_s *ring, radio_event_s *events, int max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_EVENT_RING_PRIVATE_H__
@@ -0,0 +1,53 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_HANDLE_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_HANDLE_PRIVATE_H__
+#include <radio.h>
+#include <radio_private.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* radio handles alive at the same time, at most 255 */
+#define _RADIO_HANDLE_MAX	8
+
+/*
+* Handle arena.
+* Every radio_s lives in a static slot, so creating and destroying a handle never touches the heap.
+* The exceptions are the buffers of a time-shift or of a recording, up to a few hundred kilobytes sized by the audio
+* format : they are allocated when it starts and freed when it stops, so that an idle slot does not reserve them.
+* A radio_h is not a pointer but a token packing the slot index with the generation of the slot : destroying
+* a handle bumps the generation, so the tokens of destroyed handles are rejected by _radio_handle_get().
+*/
+
+/* Takes a free slot, the handle is zeroed and its token stored in radio_s::self. Returns NULL when every slot is in use. */
+radio_s *_radio_handle_acquire(void);
+
+/* The token of the handle is rejected from now on, the slot stays reserved until _radio_handle_release() */
+void _radio_handle_invalidate(radio_s *handle);
+
+void _radio_handle_release(radio_s *handle);
+
+/* Returns NULL unless radio is the token of a live handle. Lock-free. */
+radio_s *_radio_handle_get(radio_h radio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_HANDLE_PRIVATE_H__
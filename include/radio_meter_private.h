@@ -0,0 +1,95 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_METER_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_METER_PRIVATE_H__
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <radio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _RADIO_METER_INTERVAL_MIN	10		/* ms */
+#define _RADIO_METER_INTERVAL_MAX	10000	/* ms */
+#define _RADIO_METER_LEVEL_MAX		32767
+
+/* Measure of a block of samples, the magnitude of -32768 is taken as 32767 */
+typedef struct {
+	int peak;					/* largest magnitude */
+	uint64_t energy;			/* sum of the squared magnitudes */
+	int silent_tail;			/* samples at the end of the block at or below the silence level */
+}_radio_meter_block_s;
+
+/* Called on the thread of the meter at the end of every window, to deliver the level to callback */
+typedef void (*_radio_meter_notify)(void *data, radio_level_cb callback, void *user_data, const radio_level_s *level);
+
+/*
+* Level meter, fed by a reader of the audio tap on its own thread.
+* Every period goes through the block kernel once, the window totals are kept by the thread alone. The level of the
+* last complete window is published under seq, odd while the thread writes it : readers retry instead of locking.
+*/
+typedef struct {
+	pthread_mutex_t lock;		/* protects the thread and the configuration */
+	pthread_t thread;
+	bool running;
+	bool quit;					/* atomic */
+	radio_pcm_reader_h reader;
+	radio_level_cb callback;	/* NULL when the level is only polled */
+	void *user_data;
+	_radio_meter_notify notify;
+	void *notify_data;
+	int silence_level;
+	int channels;
+	int sample_rate;
+	int window_frames;
+
+	/* meter thread only */
+	int frames;					/* of the window */
+	int peak;
+	uint64_t energy;
+	uint64_t silent_samples;	/* run of silent samples, which goes on across the windows */
+
+	uint32_t seq;
+	radio_level_s level;
+}_radio_meter_s;
+
+void _radio_meter_init(_radio_meter_s *meter);
+
+void _radio_meter_deinit(_radio_meter_s *meter);
+
+/* Starts metering the tap with reader, which belongs to the meter once it succeeded */
+int _radio_meter_start(_radio_meter_s *meter, radio_pcm_reader_h reader, int interval_ms, int silence_level,
+	radio_level_cb callback, void *user_data, _radio_meter_notify notify, void *notify_data);
+
+void _radio_meter_stop(_radio_meter_s *meter);
+
+/* Copies the level of the last window, without any lock */
+void _radio_meter_get(_radio_meter_s *meter, radio_level_s *level);
+
+/* Measures count interleaved samples, vectorized where the target has SSE2 or NEON */
+void _radio_meter_scan(const int16_t *samples, int count, int silence_level, _radio_meter_block_s *block);
+
+/* Reference of _radio_meter_scan(), one sample at a time */
+void _radio_meter_scan_scalar(const int16_t *samples, int count, int silence_level, _radio_meter_block_s *block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_METER_PRIVATE_H__
@@ -0,0 +1,87 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_PCM_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_PCM_PRIVATE_H__
+#include <stdint.h>
+#include <stddef.h>
+#include <radio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _RADIO_PCM_MAGIC			0x52504331	/* "RPC1", first word of the shared memory */
+#define _RADIO_PCM_PERIOD_FRAMES_MAX	8192
+#define _RADIO_PCM_PERIOD_COUNT_MAX		1024
+#define _RADIO_PCM_CHANNELS_MAX			8
+/* readers alive at the same time in a process, the time-shift, the recorder and the meter of a handle hold one each */
+#define _RADIO_PCM_READERS_MAX			64
+
+/*
+* Layout of the shared memory, a header followed by period_count periods of period_stride bytes.
+* The header is written once before the descriptor is handed out, then only write_seq, waiters and closed change.
+*/
+typedef struct {
+	uint32_t magic;
+	uint32_t sample_rate;
+	uint32_t channels;
+	uint32_t period_frames;
+	uint32_t period_count;		/* power of two */
+	uint32_t period_stride;		/* bytes */
+	uint32_t waiters;			/* readers sleeping on wake */
+	uint32_t wake;				/* futex word, incremented with every period and when the tap closes */
+	uint64_t write_seq;			/* sequence of the next period, the previous ones are readable */
+	uint32_t closed;			/* the producer is gone, no period will follow */
+}__attribute__((aligned(64))) _radio_pcm_header_s;
+
+typedef struct {
+	uint64_t seq;				/* sequence + 1 of the frames held, 0 while the producer writes them */
+	uint64_t timestamp;			/* monotonic (ns) time the period was captured */
+	int16_t frames[];			/* interleaved */
+}__attribute__((aligned(64))) _radio_pcm_period_s;
+
+/*
+* Single producer, multiple consumer ring of PCM periods in shared memory.
+* The producer writes the period of sequence n into slot n % period_count in place and never waits for the readers,
+* which read the frames in place too. A reader tells a period overwritten under its feet by the slot sequence, checked
+* again once the frames are read, like a seqlock. Readers of any process sleep on a futex of the header.
+*/
+typedef struct {
+	int fd;						/* -1 when closed */
+	size_t size;
+	_radio_pcm_header_s *header;
+	uint64_t writing;			/* sequence of the period between _radio_pcm_ring_begin() and _radio_pcm_ring_commit() */
+}_radio_pcm_ring_s;
+
+void _radio_pcm_ring_init(_radio_pcm_ring_s *ring);
+
+/* Creates and maps the shared memory. Returns a radio_error_e. */
+int _radio_pcm_ring_open(_radio_pcm_ring_s *ring, int sample_rate, int channels, int period_frames, int period_count);
+
+/* Wakes up the readers for good and unmaps the memory, the readers keep their own mapping */
+void _radio_pcm_ring_close(_radio_pcm_ring_s *ring);
+
+/* Returns the frames of the next period, to be filled by the producer before _radio_pcm_ring_commit() */
+int16_t *_radio_pcm_ring_begin(_radio_pcm_ring_s *ring);
+
+void _radio_pcm_ring_commit(_radio_pcm_ring_s *ring, uint64_t timestamp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_PCM_PRIVATE_H__
@@ -16,8 +16,21 @@
 
 #ifndef __TIZEN_MEDIA_RADIO_PRIVATE_H__
 #define	__TIZEN_MEDIA_RADIO_PRIVATE_H__
+#include <stdint.h>
+#include <pthread.h>
 #include <radio.h>
 #include <mm_radio.h>
+#include <radio_backend_private.h>
+#include <radio_station_cache_private.h>
+#include <radio_spectrum_private.h>
+#include <radio_trace_private.h>
+#include <radio_dispatch_private.h>
+#include <radio_event_ring_private.h>
+#include <radio_pcm_private.h>
+#include <radio_timeshift_private.h>
+#include <radio_recorder_private.h>
+#include <radio_rds_private.h>
+#include <radio_meter_private.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,15 +42,262 @@ typedef enum {
 	_RADIO_EVENT_TYPE_SCAN_FINISH,
 	_RADIO_EVENT_TYPE_SEEK_FINISH,
 	_RADIO_EVENT_TYPE_INTERRUPT,
+	_RADIO_EVENT_TYPE_SCAN_BATCH,
 	_RADIO_EVENT_TYPE_NUM
 }_radio_event_e;
 
+typedef enum {
+	_RADIO_REALIZE_NONE,		/* deferred until the first radio_start() or radio_scan_start() */
+	_RADIO_REALIZE_PENDING,
+	_RADIO_REALIZE_DONE,
+	_RADIO_REALIZE_FAILED,		/* radio_create() only, a failed lazy realize or resume goes back to be retried */
+	_RADIO_REALIZE_SUSPENDED,	/* unrealized after radio_s::idle_timeout_ms, realized again like _RADIO_REALIZE_NONE */
+}_radio_realize_e;
+
+typedef enum {
+	_RADIO_SWEEP_RANGE,		/* every channel from start to end */
+	_RADIO_SWEEP_LIST,		/* the channels listed in _radio_sweep_s::channels */
+}_radio_sweep_mode_e;
+
+typedef struct {
+	radio_region_e region;
+	int min;		/* lowest channel (kHz) */
+	int max;		/* highest channel (kHz) */
+	int spacing;	/* channel raster (kHz) */
+}_radio_band_plan_s;
+
+#define _RADIO_SWEEP_MAX_CHANNELS	(_RADIO_STATION_CACHE_MAX * 3)
+
+/* Software scan, also used to resume a stopped hardware scan */
+typedef struct {
+	pthread_t thread;
+	bool thread_started;
+	bool running;
+	bool cancel;
+	bool resumable;			/* the last scan was stopped before it reached its end */
+	_radio_sweep_mode_e mode;
+	int start;
+	int end;
+	int step;
+	int next;				/* next frequency (_RADIO_SWEEP_RANGE) or channel index (_RADIO_SWEEP_LIST) to check, atomic */
+	int tuned;				/* frequency restored when the sweep ends */
+	int64_t start_time;		/* of the scan, kept by a resume : stations not seen since then are removed when it completes, atomic */
+	int count;
+	int channels[_RADIO_SWEEP_MAX_CHANNELS];
+}_radio_sweep_s;
+
+/*
+* Stations found by the running scan and not delivered to radio_scan_batch_cb() yet.
+* The pending stations are changed with lock held : the thread reporting the scan adds them, and the message callback
+* flushes them when the sound manager interrupts the radio, also during a software scan.
+*/
+typedef struct {
+	pthread_mutex_t lock;
+	int max_count;			/* atomic */
+	int max_latency_ms;		/* atomic */
+	int count;
+	int64_t first_ms;		/* when the oldest pending station was found (monotonic) */
+	radio_station_s stations[_RADIO_STATION_CACHE_MAX];
+}_radio_scan_batch_s;
+
+/*
+* Signal strength sampler, one thread per handle shared by all the sampling parameters.
+* It is parked on cond while the radio is not playing.
+*/
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t thread;
+	bool thread_started;
+	uint32_t generation;	/* identifies the running thread, bumped to make it exit */
+	bool restart;			/* the parameters or the state changed, the next sample is the new reference */
+	int interval_ms;
+	int threshold;
+	int hysteresis;
+	int delta;
+	radio_signal_strength_changed_cb callback;
+	void *user_data;
+}_radio_sampler_s;
+
+/* alternate frequencies of radio_set_alternate_frequencies() */
+#define _RADIO_AF_MAX	16
+
+/*
+* Alternate frequency monitor, one thread per handle started by radio_set_alternate_frequency_cb().
+* It is parked on cond while the radio is not playing or has no alternate frequency.
+*/
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t thread;
+	bool thread_started;
+	uint32_t generation;	/* identifies the running thread, bumped to make it exit */
+	int frequencies[_RADIO_AF_MAX];
+	int hits[_RADIO_AF_MAX];	/* windows in a row where the alternate beat the current frequency by margin */
+	int count;
+	int next;				/* alternate measured by the next window */
+	int margin;
+	int tuner_share;		/* percent */
+	bool auto_switch;
+	radio_alternate_frequency_cb callback;
+	void *user_data;
+}_radio_af_monitor_s;
+
+/*
+* RDS decoder, one thread per handle started by radio_set_rds_changed_cb().
+* The thread reads the blocks of the tuner a group at a time and is parked on cond while the radio is not playing.
+* The metadata of the stations is kept in cache, which outlives the thread.
+*/
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t thread;
+	bool thread_started;
+	uint32_t generation;	/* identifies the running thread, bumped to make it exit */
+	radio_rds_changed_cb callback;
+	void *user_data;
+	_radio_rds_decoder_s decoder;	/* decoder thread only */
+	_radio_rds_cache_s cache;
+}_radio_rds_monitor_s;
+
+/*
+* Audio tap, one thread per handle started by radio_pcm_tap_start().
+* The thread reads the tuner straight into the ring and is parked on cond while the radio is not playing.
+*/
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t thread;
+	bool thread_started;	/* atomic */
+	bool quit;
+	_radio_pcm_ring_s ring;
+}_radio_pcm_tap_s;
+
+/*
+* A callback and its user data, published together.
+* seq is odd while a writer updates the pair : readers retry instead of taking a lock on the event path.
+*/
+typedef struct {
+	uint32_t seq;
+	const void *callback;
+	void *user_data;
+}_radio_callback_slot_s;
+
+/*
+* Values of radio_get_status() without a field of their own in radio_s.
+* seq is odd while a writer updates them or radio_s::state_word, frequency and mute : readers retry until they
+* read them all outside of an update.
+*/
+typedef struct {
+	uint32_t seq;
+	int scan_frequency;
+	int scan_station_count;
+	bool interrupted;
+	radio_interrupted_code_e interrupted_code;
+}_radio_status_s;
+
+typedef struct {
+	int id;
+	const void *callback;
+	void *user_data;
+}_radio_listener_s;
+
+#define _RADIO_LISTENER_MAX		8	/* of each event */
+#define _RADIO_LISTENER_ARRAYS	6	/* one published per event with listeners, the others being rebuilt or still iterated */
+
+/*
+* Listeners added by radio_add_*_cb(), never modified once published : adding or removing a listener fills
+* an array of radio_s::listener_pool which is neither published nor iterated, then publishes it.
+*/
+typedef struct {
+	uint32_t readers;		/* events iterating the array */
+	int count;
+	_radio_listener_s listeners[_RADIO_LISTENER_MAX];
+}_radio_listener_array_s;
+
+#define _RADIO_COMMAND_QUEUE_MAX	16
+
+typedef struct {
+	radio_command_e command;
+	int frequency;
+	radio_command_completed_cb callback;
+	void *user_data;
+}_radio_command_s;
+
+/*
+* Commands of the asynchronous functions, run in order by a worker thread started with the first one.
+* A frequency change queued right behind another one which has not run yet replaces it, the replaced one is kept in
+* cancelled until the worker reports it.
+*/
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t thread;
+	bool thread_started;
+	bool quit;
+	bool seeking;			/* the worker waits for the result of a seek, its callback is not dispatched */
+	int seek_frequency;
+	int predicted_frequency;	/* station found by a predictive seek, reported by the worker, 0 when none */
+	int head;				/* index of the oldest queued command */
+	int count;
+	_radio_command_s commands[_RADIO_COMMAND_QUEUE_MAX];
+	int cancelled_head;		/* index of the oldest replaced command not reported yet */
+	int cancelled_count;
+	_radio_command_s cancelled[_RADIO_COMMAND_QUEUE_MAX];
+}_radio_command_queue_s;
+
+#define _RADIO_ATOMIC_GET(var)			__atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define _RADIO_ATOMIC_SET(var, value)	__atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+
+/* radio_s::state_word packs the mirrored radio_state_e with the count of state changes reported by the backend */
+#define _RADIO_STATE_WORD(seq, state)	(((uint64_t)(seq) << 32) | (uint32_t)(state))
+#define _RADIO_STATE_WORD_STATE(word)	((radio_state_e)(uint32_t)(word))
+#define _RADIO_STATE_WORD_SEQ(word)		((uint32_t)((word) >> 32))
+
 typedef struct _radio_s{
+	radio_h self;			/* token of the handle, see radio_handle_private.h */
 	MMHandleType mm_handle;
-	const void* user_cb[_RADIO_EVENT_TYPE_NUM];
-	void* user_data[_RADIO_EVENT_TYPE_NUM];
-	radio_state_e state;
-	bool mute;
+	const _radio_backend_s *backend;
+	_radio_callback_slot_s user_cb[_RADIO_EVENT_TYPE_NUM];
+	_radio_listener_array_s *listeners[_RADIO_EVENT_TYPE_NUM];	/* in listener_pool, NULL without listener */
+	pthread_mutex_t listener_lock;		/* serializes the writers */
+	int listener_next_id;
+	_radio_listener_array_s listener_pool[_RADIO_LISTENER_ARRAYS];
+	uint64_t state_word;	/* mirrored state, see _RADIO_STATE_WORD() */
+	int frequency;			/* mirrored frequency (kHz), 0 when unknown */
+	bool mute;				/* mirrored mute status */
+	pthread_mutex_t realize_lock;
+	pthread_cond_t realize_cond;
+	pthread_t realize_thread;
+	bool realize_thread_started;
+	_radio_realize_e realize_status;	/* atomic, changed with realize_lock held */
+	int realize_error;				/* error of the last failed realize, written with realize_lock held */
+	bool pending_frequency;	/* frequency was set before the device was realized */
+	bool pending_mute;		/* mute was set before the device was realized */
+	radio_ready_cb ready_cb;
+	void *ready_user_data;
+	_radio_station_cache_s stations;
+	int scan_threshold;			/* minimum signal strength of a station for software scans and predictive seeks, atomic */
+	const _radio_band_plan_s *band;	/* atomic, replaced by radio_set_region() */
+	_radio_sweep_s sweep;
+	_radio_spectrum_s spectrum;	/* last signal strength of every channel of the band */
+	bool predictive_seek;		/* atomic */
+	_radio_sampler_s sampler;
+	_radio_af_monitor_s af;
+	_radio_rds_monitor_s rds;
+	_radio_pcm_tap_s tap;
+	_radio_timeshift_s timeshift;	/* reads the tap */
+	_radio_recorder_s recorder;		/* reads the tap */
+	_radio_meter_s meter;			/* reads the tap */
+	_radio_scan_batch_s batch;
+	_radio_trace_s trace;
+	_radio_command_queue_s commands;
+	pthread_mutex_t dispatch_lock;
+	GSource *dispatch;				/* set by radio_set_event_context() */
+	_radio_event_ring_s events;		/* read by radio_read_events() */
+	int idle_timeout_ms;			/* set by radio_set_idle_timeout(), 0 when disabled, atomic */
+	uint64_t last_activity;			/* monotonic (ns) time of the last use of the device, atomic */
+	_radio_status_s status;			/* read by radio_get_status() */
 } radio_s;
 
 #ifdef __cplusplus
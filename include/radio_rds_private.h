@@ -0,0 +1,122 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_RDS_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_RDS_PRIVATE_H__
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <radio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _RADIO_RDS_CACHE_MAX	32	/* stations whose metadata is kept */
+#define _RADIO_RDS_BURST_MAX	2	/* longest burst of bit errors corrected in a block */
+#define _RADIO_RDS_SYNC_LOSS	16	/* uncorrectable blocks in a row which lose the sync */
+
+/* A block is 16 bits of data followed by 10 check bits, in the low 26 bits of a word */
+#define _RADIO_RDS_BLOCK_BITS	26
+#define _RADIO_RDS_POLY			0x5B9	/* x^10 + x^8 + x^7 + x^5 + x^4 + x^3 + 1 */
+
+/* Offset words added to the check bits, they tell the position of a block in its group */
+typedef enum {
+	_RADIO_RDS_OFFSET_A,
+	_RADIO_RDS_OFFSET_B,
+	_RADIO_RDS_OFFSET_C,
+	_RADIO_RDS_OFFSET_C_PRIME,	/* block C of the version B groups */
+	_RADIO_RDS_OFFSET_D,
+	_RADIO_RDS_OFFSET_NUM
+}_radio_rds_offset_e;
+
+/* Metadata of a station and the state of its decoding, which survive the retunes */
+typedef struct {
+	int frequency;				/* 0 when unused */
+	uint64_t used;				/* decoder tick of the last visit, the oldest station is replaced */
+	radio_rds_info_s info;		/* published, under the cache lock */
+
+	/* decoder thread only */
+	char ps[RADIO_RDS_PS_LENGTH];
+	uint8_t ps_seen;			/* segments received once */
+	uint8_t ps_confirmed;		/* segments received twice in a row alike */
+	char rt[RADIO_RDS_RADIO_TEXT_LENGTH];
+	uint16_t rt_received;		/* segments */
+	int rt_length;				/* up to the end mark, the full size until one is received */
+	int rt_flag;				/* text A/B flag and group version, -1 before the first segment */
+	int af_expected;			/* size of the list being received, 0 outside of a list */
+	bool af_skip;				/* the next code is an LF/MF frequency, which is not kept */
+	int af_count;
+	int af[RADIO_RDS_AF_MAX];
+}_radio_rds_station_s;
+
+typedef struct {
+	pthread_mutex_t lock;		/* protects the published info, the decoder thread is the only writer */
+	uint64_t tick;
+	_radio_rds_station_s stations[_RADIO_RDS_CACHE_MAX];
+}_radio_rds_cache_s;
+
+/*
+* Block decoder. The blocks come aligned, the decoder finds the group boundaries from the offset words : two blocks in
+* a row with the offsets of consecutive positions give the sync. Once in sync, the offset of every block is known and
+* a block with errors is corrected when its syndrome is the one of a short burst. Everything is table driven and
+* nothing is allocated.
+*/
+typedef struct {
+	int frequency;				/* of the blocks being decoded, 0 before the first one */
+	_radio_rds_station_s *station;	/* NULL until a group is decoded on frequency */
+	bool synced;
+	int expected;				/* position of the next block once in sync, _RADIO_RDS_OFFSET_A to _RADIO_RDS_OFFSET_D */
+	int previous;				/* offset of the previous block while out of sync, -1 when it had none */
+	int bad_run;
+	uint16_t group[4];
+	uint8_t valid;				/* blocks of group received or corrected */
+	uint16_t pi_candidate;
+	bool pi_confirmed;			/* pi_candidate was received twice in a row */
+
+	/* counters since the decoder was initialized */
+	uint64_t blocks;
+	uint64_t corrected;
+	uint64_t uncorrectable;
+	uint64_t groups;
+}_radio_rds_decoder_s;
+
+void _radio_rds_decoder_init(_radio_rds_decoder_s *decoder);
+
+/* Starts decoding the blocks of frequency. Returns the fields already known of it. */
+unsigned int _radio_rds_decoder_tune(_radio_rds_decoder_s *decoder, _radio_rds_cache_s *cache, int frequency);
+
+/* Decodes blocks received on the tuned frequency. Returns the fields which changed. */
+unsigned int _radio_rds_decode(_radio_rds_decoder_s *decoder, _radio_rds_cache_s *cache, const uint32_t *blocks, int count);
+
+void _radio_rds_cache_init(_radio_rds_cache_s *cache);
+
+void _radio_rds_cache_deinit(_radio_rds_cache_s *cache);
+
+/* Copies the metadata of frequency, without any field when it is unknown */
+void _radio_rds_cache_get(_radio_rds_cache_s *cache, int frequency, radio_rds_info_s *info);
+
+/* Returns the syndrome of a block, equal to the offset word of its position when it has no error */
+uint16_t _radio_rds_syndrome(uint32_t block);
+
+/* Offset word of a position */
+uint16_t _radio_rds_offset(_radio_rds_offset_e offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_RDS_PRIVATE_H__
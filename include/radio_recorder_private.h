@@ -0,0 +1,119 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_RECORDER_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_RECORDER_PRIVATE_H__
+#include <stdint.h>
+#include <pthread.h>
+#include <radio.h>
+#include <radio_pcm_private.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* buffers between the encoder and the writer, the memory of a recording is bounded by them */
+#define _RADIO_RECORDER_BUFFERS			8
+#define _RADIO_RECORDER_BUFFER_BYTES	32768
+#define _RADIO_RECORDER_RATE_MIN		8000
+#define _RADIO_RECORDER_RATE_MAX		96000
+/* an IMA ADPCM block holds 4 header bytes and 508 bytes of samples per channel */
+#define _RADIO_RECORDER_ADPCM_BLOCK		512
+#define _RADIO_RECORDER_ADPCM_SAMPLES	((_RADIO_RECORDER_ADPCM_BLOCK - 4) * 2 + 1)
+
+typedef struct {
+	uint8_t *data;
+	int size;
+}_radio_recorder_buffer_s;
+
+/* Linear interpolation, carried from one period to the next */
+typedef struct {
+	uint64_t step;				/* input frames per output frame, 32.32 fixed point */
+	uint64_t position;			/* position of the next output frame from previous, 32.32 fixed point */
+	int16_t previous[_RADIO_PCM_CHANNELS_MAX];	/* last input frame of the previous period */
+	bool primed;				/* previous holds a frame */
+}_radio_recorder_resampler_s;
+
+typedef struct {
+	int predictor;
+	int index;
+}_radio_recorder_adpcm_s;
+
+/*
+* Recorder, fed by a reader of the audio tap.
+* The capture thread converts the periods and encodes them into a fixed pool of buffers, the writer thread writes the
+* full buffers to the file. When the writer falls behind, the capture thread waits for a free buffer while the tap
+* goes on without it : the periods it misses are counted as dropped, the tuner audio is never held back.
+*/
+typedef struct {
+	pthread_mutex_t lock;		/* protects the queues and the threads */
+	pthread_cond_t cond;
+	bool running;
+	bool quit;					/* the capture thread must flush and exit */
+	bool eof;					/* the capture thread queued its last buffer */
+	pthread_t capture_thread;
+	pthread_t writer_thread;
+	radio_pcm_reader_h reader;
+	int fd;
+	radio_recording_format_e format;
+	int channels;
+	int input_rate;
+	int output_rate;
+	int period_frames;
+
+	/* capture thread only */
+	int16_t *work;				/* period after the resampler */
+	int16_t *block;				/* ADPCM block being filled */
+	int block_samples;			/* frames in block */
+	_radio_recorder_resampler_s resampler;
+	_radio_recorder_adpcm_s adpcm[_RADIO_PCM_CHANNELS_MAX];
+	_radio_recorder_buffer_s *current;	/* buffer being filled */
+	uint64_t output_frames;		/* frames given to the encoder, at the output rate */
+
+	/* buffers, each one is either free, filled or current */
+	_radio_recorder_buffer_s buffers[_RADIO_RECORDER_BUFFERS];
+	_radio_recorder_buffer_s *free_list[_RADIO_RECORDER_BUFFERS];
+	int free_count;
+	_radio_recorder_buffer_s *filled[_RADIO_RECORDER_BUFFERS];	/* ring, oldest first */
+	int filled_head;
+	int filled_count;
+	int queue_peak;
+
+	/* read by radio_recording_get_status(), atomic */
+	uint64_t frames_recorded;
+	uint64_t frames_dropped;
+	uint64_t bytes_written;
+	int error;
+}_radio_recorder_s;
+
+void _radio_recorder_init(_radio_recorder_s *recorder);
+
+void _radio_recorder_deinit(_radio_recorder_s *recorder);
+
+/* Creates the file and starts reading the tap with reader, which belongs to the recorder once it succeeded */
+int _radio_recorder_start(_radio_recorder_s *recorder, radio_pcm_reader_h reader, const char *path,
+	radio_recording_format_e format, int sample_rate);
+
+/* Encodes what was captured so far, completes the file and closes it */
+void _radio_recorder_stop(_radio_recorder_s *recorder);
+
+int _radio_recorder_get_status(_radio_recorder_s *recorder, radio_recording_status_s *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_RECORDER_PRIVATE_H__
@@ -0,0 +1,57 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_SPECTRUM_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_SPECTRUM_PRIVATE_H__
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* enough for the densest band plan */
+#define _RADIO_SPECTRUM_MAX_CHANNELS	256
+#define _RADIO_SPECTRUM_UNKNOWN			INT16_MIN
+
+/*
+* Last signal strength measured on every channel of the band plan.
+* Entries are written by the scan and sampling paths and read by seek without locking.
+*/
+typedef struct {
+	int min;
+	int spacing;
+	int count;
+	int16_t rssi[_RADIO_SPECTRUM_MAX_CHANNELS];
+} _radio_spectrum_s;
+
+void _radio_spectrum_init(_radio_spectrum_s *spectrum, int min, int max, int spacing);
+
+/* Frequencies off the band plan are ignored */
+void _radio_spectrum_set(_radio_spectrum_s *spectrum, int frequency, int rssi);
+
+int _radio_spectrum_get(_radio_spectrum_s *spectrum, int frequency);
+
+/*
+* Returns the first channel after frequency in the given direction (1 up, -1 down) whose last signal strength
+* reaches threshold, wrapping around the band like a hardware seek. Returns 0 when no channel qualifies.
+*/
+int _radio_spectrum_next(_radio_spectrum_s *spectrum, int frequency, int direction, int threshold);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_SPECTRUM_PRIVATE_H__
@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_STATION_CACHE_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_STATION_CACHE_PRIVATE_H__
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <radio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RADIO_STATION_CACHE_DIR
+#define RADIO_STATION_CACHE_DIR	"/opt/usr/share/radio"
+#endif
+
+/* RADIO_STATION_CACHE_DIR can be overridden at run time with this environment variable */
+#define _RADIO_STATION_CACHE_DIR_ENV	"CAPI_RADIO_STATION_CACHE_DIR"
+
+#define _RADIO_STATION_CACHE_MAGIC		0x53525243	/* "CRRS" */
+#define _RADIO_STATION_CACHE_VERSION	2
+#define _RADIO_STATION_CACHE_MAX		128
+
+/* On-disk layout, the file is mapped as is. Records are sorted by frequency. */
+typedef struct {
+	int32_t frequency;
+	int32_t rssi;
+	int64_t timestamp;
+} _radio_station_record_s;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	int32_t band_min;
+	int32_t band_max;
+	int32_t band_step;
+	uint32_t count;
+	uint32_t reserved[2];
+	_radio_station_record_s records[_RADIO_STATION_CACHE_MAX];
+} _radio_station_cache_file_s;
+
+/* distinct bands mapped by a process, every band plan fits */
+#define _RADIO_STATION_CACHE_BANDS		16
+
+/*
+* Station list of a band, shared by every handle of the process tuned to the band : two handles never map the same
+* file twice. Writers take lock against the other threads and an flock() of the file against the other processes,
+* readers take a shared flock(). A band stays mapped until the process exits, so a reader holding one across a
+* change of region never sees it unmapped.
+*/
+typedef struct {
+	int band_min;
+	int band_max;
+	int band_step;
+	pthread_mutex_t lock;
+	int fd;				/* -1 when the file could not be mapped, the list is then kept in memory only */
+	_radio_station_cache_file_s *map;
+} _radio_station_cache_band_s;
+
+typedef struct {
+	_radio_station_cache_band_s *band;	/* atomic, NULL without any list */
+} _radio_station_cache_s;
+
+/* Maps the station list of the band, one list is kept per band. A list already open is replaced. */
+int _radio_station_cache_open(_radio_station_cache_s *cache, int band_min, int band_max, int band_step);
+
+/* Detaches the cache from its list, which stays mapped for the other handles */
+void _radio_station_cache_close(_radio_station_cache_s *cache);
+
+/* Adds the station, or refreshes its RSSI and timestamp */
+void _radio_station_cache_update(_radio_station_cache_s *cache, int frequency, int rssi, int64_t timestamp);
+
+/* Refreshes the RSSI and timestamp of a known station, unknown frequencies are ignored */
+void _radio_station_cache_refresh(_radio_station_cache_s *cache, int frequency, int rssi, int64_t timestamp);
+
+/* Removes the stations of [min_frequency, max_frequency] which were not seen since the given time */
+void _radio_station_cache_prune(_radio_station_cache_s *cache, int min_frequency, int max_frequency, int64_t timestamp);
+
+void _radio_station_cache_clear(_radio_station_cache_s *cache);
+
+/* Copies up to max stations, returns the number of stations copied */
+int _radio_station_cache_copy(_radio_station_cache_s *cache, radio_station_s *stations, int max);
+
+int _radio_station_cache_count(_radio_station_cache_s *cache);
+
+/* Schedules the write back of the mapped file */
+void _radio_station_cache_sync(_radio_station_cache_s *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_STATION_CACHE_PRIVATE_H__
@@ -0,0 +1,148 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_STATS_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_STATS_PRIVATE_H__
+#include <stdint.h>
+#include <radio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Instrumented entry points and backend messages, see radio_foreach_statistics() */
+typedef enum {
+	_RADIO_STATS_CREATE,
+	_RADIO_STATS_CREATE_ASYNC,
+	_RADIO_STATS_CREATE_LAZY,
+	_RADIO_STATS_DESTROY,
+	_RADIO_STATS_GET_STATE,
+	_RADIO_STATS_REFRESH,
+	_RADIO_STATS_START,
+	_RADIO_STATS_STOP,
+	_RADIO_STATS_SEEK_UP,
+	_RADIO_STATS_SEEK_DOWN,
+	_RADIO_STATS_SET_REGION,
+	_RADIO_STATS_GET_REGION,
+	_RADIO_STATS_GET_FREQUENCY_RANGE,
+	_RADIO_STATS_GET_CHANNEL_SPACING,
+	_RADIO_STATS_SET_FREQUENCY,
+	_RADIO_STATS_GET_FREQUENCY,
+	_RADIO_STATS_GET_SIGNAL_STRENGTH,
+	_RADIO_STATS_SCAN_START,
+	_RADIO_STATS_SCAN_STOP,
+	_RADIO_STATS_SCAN_RANGE_START,
+	_RADIO_STATS_SCAN_RESUME,
+	_RADIO_STATS_SCAN_INCREMENTAL_START,
+	_RADIO_STATS_SET_SCAN_THRESHOLD,
+	_RADIO_STATS_SET_PREDICTIVE_SEEK,
+	_RADIO_STATS_FOREACH_STATION,
+	_RADIO_STATS_GET_STATION_COUNT,
+	_RADIO_STATS_CLEAR_STATIONS,
+	_RADIO_STATS_SET_MUTE,
+	_RADIO_STATS_IS_MUTED,
+	_RADIO_STATS_SET_SCAN_COMPLETED_CB,
+	_RADIO_STATS_UNSET_SCAN_COMPLETED_CB,
+	_RADIO_STATS_SET_SCAN_BATCH_CB,
+	_RADIO_STATS_UNSET_SCAN_BATCH_CB,
+	_RADIO_STATS_SET_INTERRUPTED_CB,
+	_RADIO_STATS_UNSET_INTERRUPTED_CB,
+	_RADIO_STATS_SET_SIGNAL_STRENGTH_CHANGED_CB,
+	_RADIO_STATS_UNSET_SIGNAL_STRENGTH_CHANGED_CB,
+	_RADIO_STATS_DUMP_TRACE,
+	_RADIO_STATS_SET_FREQUENCY_ASYNC,
+	_RADIO_STATS_START_ASYNC,
+	_RADIO_STATS_STOP_ASYNC,
+	_RADIO_STATS_SEEK_UP_ASYNC,
+	_RADIO_STATS_SEEK_DOWN_ASYNC,
+	_RADIO_STATS_SET_EVENT_CONTEXT,
+	_RADIO_STATS_GET_EVENT_FD,
+	_RADIO_STATS_READ_EVENTS,
+	_RADIO_STATS_ADD_SCAN_UPDATED_CB,
+	_RADIO_STATS_ADD_SCAN_COMPLETED_CB,
+	_RADIO_STATS_ADD_INTERRUPTED_CB,
+	_RADIO_STATS_REMOVE_CB,
+	_RADIO_STATS_SET_IDLE_TIMEOUT,
+	_RADIO_STATS_GET_STATUS,
+	_RADIO_STATS_SET_ALTERNATE_FREQUENCIES,
+	_RADIO_STATS_SET_ALTERNATE_FREQUENCY_CB,
+	_RADIO_STATS_UNSET_ALTERNATE_FREQUENCY_CB,
+	_RADIO_STATS_PCM_TAP_START,
+	_RADIO_STATS_PCM_TAP_STOP,
+	_RADIO_STATS_PCM_TAP_GET_FD,
+	_RADIO_STATS_PCM_READER_CREATE,
+	_RADIO_STATS_TIMESHIFT_START,
+	_RADIO_STATS_TIMESHIFT_STOP,
+	_RADIO_STATS_TIMESHIFT_PAUSE,
+	_RADIO_STATS_TIMESHIFT_RESUME,
+	_RADIO_STATS_TIMESHIFT_SEEK,
+	_RADIO_STATS_TIMESHIFT_GET_POSITION,
+	_RADIO_STATS_TIMESHIFT_READ,
+	_RADIO_STATS_RECORDING_START,
+	_RADIO_STATS_RECORDING_STOP,
+	_RADIO_STATS_RECORDING_GET_STATUS,
+	_RADIO_STATS_SET_RDS_CHANGED_CB,
+	_RADIO_STATS_UNSET_RDS_CHANGED_CB,
+	_RADIO_STATS_GET_RDS_INFO,
+	_RADIO_STATS_LEVEL_METER_START,
+	_RADIO_STATS_LEVEL_METER_STOP,
+	_RADIO_STATS_LEVEL_METER_GET,
+	_RADIO_STATS_MESSAGE_SCAN_INFO,
+	_RADIO_STATS_MESSAGE_SCAN_START,
+	_RADIO_STATS_MESSAGE_SCAN_STOP,
+	_RADIO_STATS_MESSAGE_SCAN_FINISH,
+	_RADIO_STATS_MESSAGE_SEEK_START,
+	_RADIO_STATS_MESSAGE_SEEK_FINISH,
+	_RADIO_STATS_MESSAGE_STATE_CHANGED,
+	_RADIO_STATS_MESSAGE_STATE_INTERRUPTED,
+	_RADIO_STATS_MESSAGE_ERROR,
+	_RADIO_STATS_MESSAGE_OTHER,
+	_RADIO_STATS_DEVICE_RESUME,		/* realization of a device suspended by the idle policy */
+	_RADIO_STATS_DEVICE_AF_WINDOW,	/* tuner time spent on an alternate frequency window */
+	_RADIO_STATS_NUM
+}_radio_stats_e;
+
+/* bucket i counts the latencies below 2^i ns and not below 2^(i-1) ns, the last one everything above */
+#define _RADIO_STATS_BUCKETS	48
+
+typedef enum {
+	_RADIO_STATS_ERROR_INVALID_PARAMETER,
+	_RADIO_STATS_ERROR_INVALID_OPERATION,
+	_RADIO_STATS_ERROR_INVALID_STATE,
+	_RADIO_STATS_ERROR_OUT_OF_MEMORY,
+	_RADIO_STATS_ERROR_SOUND_POLICY,
+	_RADIO_STATS_ERROR_OTHER,
+	_RADIO_STATS_ERROR_NUM
+}_radio_stats_error_e;
+
+/* Process-wide counters of one entry point, only updated with relaxed atomic operations */
+typedef struct {
+	uint64_t total_ns;
+	uint64_t max_ns;
+	uint64_t errors[_RADIO_STATS_ERROR_NUM];
+	uint64_t buckets[_RADIO_STATS_BUCKETS];
+}_radio_stats_counter_s;
+
+uint64_t _radio_stats_now(void);
+
+/* Counts one call of id which started at start_ns (see _radio_stats_now()) and returned error */
+void _radio_stats_record(_radio_stats_e id, uint64_t start_ns, int error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_STATS_PRIVATE_H__
@@ -0,0 +1,103 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_TIMESHIFT_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_TIMESHIFT_PRIVATE_H__
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <radio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _RADIO_TIMESHIFT_MAGIC			0x52545331	/* "RTS1", first word of the file */
+#define _RADIO_TIMESHIFT_SECONDS_MAX	(4 * 3600)
+#define _RADIO_TIMESHIFT_GRANULE_NS		1000000000ULL	/* time covered by one index entry */
+/* frames written to the file at once, a multiple of the page size whatever the number of channels */
+#define _RADIO_TIMESHIFT_BATCH_FRAMES	16384
+
+/* Entry of the index, for the granule of time (timestamp / _RADIO_TIMESHIFT_GRANULE_NS) */
+typedef struct {
+	uint64_t tag;				/* granule + 1, 0 when unused */
+	uint64_t position;			/* first frame captured in the granule, counted since the start */
+	uint64_t timestamp;			/* monotonic (ns) capture time of that frame */
+}_radio_timeshift_index_s;
+
+/* First page of the file, followed by the index and the frames, each page aligned */
+typedef struct {
+	uint32_t magic;
+	uint32_t sample_rate;
+	uint32_t channels;
+	uint32_t index_count;
+	uint64_t index_offset;		/* bytes */
+	uint64_t data_offset;		/* bytes */
+	uint64_t capacity;			/* frames of the data area, a multiple of _RADIO_TIMESHIFT_BATCH_FRAMES */
+	uint64_t written;			/* frames written since the start, frame n is at n % capacity */
+}_radio_timeshift_file_s;
+
+/*
+* Time-shift buffer, fed by a reader of the audio tap on its own thread.
+* The frames are staged in memory and copied to the mapped file one batch at a time, so every page of the file
+* is dirtied once per pass over the ring. The index maps a capture time to a position in constant time : one entry
+* per granule of time, kept in a ring of index_count entries.
+*/
+typedef struct {
+	pthread_mutex_t lock;		/* protects the mapping, the positions and the index */
+	pthread_t thread;
+	bool running;
+	bool quit;					/* atomic */
+	radio_pcm_reader_h reader;
+	int fd;						/* -1 when stopped */
+	size_t size;
+	char *map;
+	_radio_timeshift_file_s *file;
+	_radio_timeshift_index_s *index;
+	int16_t *data;
+	int channels;
+	int sample_rate;
+	uint64_t capacity;
+	int16_t *staging;			/* the next batch */
+	uint64_t staged;			/* frames in staging */
+	uint64_t last_granule;		/* granule of the last indexed frame */
+	uint64_t live_timestamp;	/* capture time of the frame at file->written */
+	uint64_t play;				/* next frame returned by radio_timeshift_read() */
+	bool paused;
+}_radio_timeshift_s;
+
+void _radio_timeshift_init(_radio_timeshift_s *ts);
+
+void _radio_timeshift_deinit(_radio_timeshift_s *ts);
+
+/* Creates the file and starts reading the tap with reader, which belongs to the time-shift once it succeeded */
+int _radio_timeshift_start(_radio_timeshift_s *ts, radio_pcm_reader_h reader, const char *path, int seconds);
+
+void _radio_timeshift_stop(_radio_timeshift_s *ts);
+
+int _radio_timeshift_pause(_radio_timeshift_s *ts, bool paused);
+
+int _radio_timeshift_seek(_radio_timeshift_s *ts, int delay_ms);
+
+int _radio_timeshift_get_position(_radio_timeshift_s *ts, int *delay_ms, int *buffered_ms);
+
+int _radio_timeshift_read(_radio_timeshift_s *ts, short *frames, int frame_count, int *read_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_TIMESHIFT_PRIVATE_H__
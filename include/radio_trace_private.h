@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_TRACE_PRIVATE_H__
+#define	__TIZEN_MEDIA_RADIO_TRACE_PRIVATE_H__
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* must be a power of two */
+#define _RADIO_TRACE_ENTRIES	256
+
+typedef enum {
+	_RADIO_TRACE_MESSAGE,			/* args : MM_MESSAGE_* type, frequency, state or code carried by the message */
+	_RADIO_TRACE_STATE,				/* args : previous and new radio_state_e */
+	_RADIO_TRACE_SET_CALLBACK,		/* args : _radio_event_e */
+	_RADIO_TRACE_UNSET_CALLBACK,	/* args : _radio_event_e */
+	_RADIO_TRACE_ERROR,				/* args : backend error code, converted radio_error_e */
+	_RADIO_TRACE_SUSPEND,			/* args : idle timeout (ms) */
+	_RADIO_TRACE_RESUME,			/* args : radio_error_e, latency (us) */
+	_RADIO_TRACE_AF_WINDOW,			/* args : alternate frequency, its signal strength or INT32_MIN when not measured */
+	_RADIO_TRACE_RDS,				/* args : frequency, radio_rds_field_e which changed */
+}_radio_trace_event_e;
+
+typedef struct {
+	uint32_t seq;			/* position of the entry + 1 once it is complete, 0 while it is written */
+	uint32_t event;
+	uint64_t timestamp;		/* monotonic (ns) */
+	int32_t args[2];
+}_radio_trace_entry_s;
+
+/*
+* Binary trace of the recent events of a handle.
+* Writers from any thread claim a position with one atomic increment, the oldest entries are overwritten.
+*/
+typedef struct {
+	uint32_t head;			/* next position */
+	_radio_trace_entry_s entries[_RADIO_TRACE_ENTRIES];
+}_radio_trace_s;
+
+void _radio_trace_write(_radio_trace_s *trace, uint64_t timestamp, _radio_trace_event_e event, int arg0, int arg1);
+
+/* Writes the complete entries, oldest first, decoded as one line of text each. Returns the number of entries written or -1. */
+int _radio_trace_dump(_radio_trace_s *trace, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_TRACE_PRIVATE_H__
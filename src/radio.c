@@ -19,8 +19,13 @@
 #include <string.h>
 #include <mm_types.h>
 #include <radio_private.h>
+#include <radio_handle_private.h>
+#include <radio_stats_private.h>
 #include <dlog.h>
 #include <glib.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
 
 
 #ifdef LOG_TAG
@@ -31,22 +36,101 @@
 /*
 * Internal Macros
 */
+#define RADIO_SCAN_THRESHOLD	25
+
+/* longest wait for the result of a seek queued by radio_seek_up_async() */
+#define RADIO_COMMAND_SEEK_TIMEOUT_MS	10000
+
+/* shortest idle timeout accepted by radio_set_idle_timeout() */
+#define RADIO_IDLE_TIMEOUT_MIN_MS	100
+
+/* a resume slower than this is reported, see _RADIO_STATS_DEVICE_RESUME for the distribution */
+#define RADIO_RESUME_TARGET_MS	50
+
+/* alternate frequency monitor : shortest period between two windows, quiet time after a change, windows to confirm */
+#define RADIO_AF_INTERVAL_MIN_MS	500
+#define RADIO_AF_QUIET_MS			1000
+#define RADIO_AF_CONFIRMATIONS		2
+
+/* audio tap : wait before reading the tuner again after a failed read */
+#define RADIO_PCM_RETRY_MS		10
+
+/* RDS decoder : blocks read at once (a group), wait before reading the tuner again after a failed read */
+#define RADIO_RDS_READ_BLOCKS	4
+#define RADIO_RDS_RETRY_MS		100
+
+/* band swept by the tuner's own scan */
+#define RADIO_NATIVE_BAND_MIN	87500
+#define RADIO_NATIVE_BAND_MAX	108000
+
 #define RADIO_CHECK_CONDITION(condition,error,msg)	\
 		if(condition) {} else \
 		{ LOGE("[%s] %s(0x%08x)",(char*)__FUNCTION__, msg,error); return error;}; \
 
 #define RADIO_INSTANCE_CHECK(radio)	\
-	RADIO_CHECK_CONDITION(radio != NULL, RADIO_ERROR_INVALID_PARAMETER,"RADIO_ERROR_INVALID_PARAMETER")
+	RADIO_CHECK_CONDITION(_radio_handle_get(radio) != NULL, RADIO_ERROR_INVALID_PARAMETER,"RADIO_ERROR_INVALID_PARAMETER")
 	
 #define RADIO_STATE_CHECK(radio,expected_state)	\
-	RADIO_CHECK_CONDITION(radio->state == expected_state,RADIO_ERROR_INVALID_STATE,"RADIO_ERROR_INVALID_STATE")
+	RADIO_CHECK_CONDITION(__radio_get_cached_state(radio) == expected_state,RADIO_ERROR_INVALID_STATE,"RADIO_ERROR_INVALID_STATE")
 
 #define RADIO_NULL_ARG_CHECK(arg)	\
 	RADIO_CHECK_CONDITION(arg != NULL,RADIO_ERROR_INVALID_PARAMETER,"RADIO_ERROR_INVALID_PARAMETER")
 
+/*
+* Logs of the event path : every message, callback registration and state change is recorded in the handle's
+* binary trace (see radio_dump_trace()). They are only formatted to dlog in builds with RADIO_HOT_PATH_LOG.
+*/
+#ifdef RADIO_HOT_PATH_LOG
+#define RADIO_HOT_LOGI(fmt, ...)	LOGI(fmt, ##__VA_ARGS__)
+#else
+#define RADIO_HOT_LOGI(fmt, ...)	do {} while(0)
+#endif
+
+#define RADIO_STATS_RETURN(id, call)	\
+	do { uint64_t __start = _radio_stats_now(); int __ret = (call); _radio_stats_record(id, __start, __ret); return __ret; } while(0)
+
+#define RADIO_REALIZED_CHECK(radio)	\
+	RADIO_CHECK_CONDITION(_RADIO_ATOMIC_GET(radio->realize_status) == _RADIO_REALIZE_DONE,RADIO_ERROR_INVALID_STATE,"RADIO_ERROR_INVALID_STATE")
+
+/*
+* Band plans, indexed by radio_region_e
+*/
+static const _radio_band_plan_s __band_plans[] = {
+	{ RADIO_REGION_EUROPE,	87500,	108000,	100 },
+	{ RADIO_REGION_US,		87500,	108000,	200 },
+	{ RADIO_REGION_JAPAN,	76000,	95000,	100 },
+	{ RADIO_REGION_OIRT,	65800,	74000,	50 },
+};
+
+#define RADIO_REGION_NUM	(int)(sizeof(__band_plans) / sizeof(__band_plans[0]))
+
 /*
 * Internal Implementation
 */
+/* radio_s::band is replaced by radio_set_region() while the other threads read it, the plans themselves never change */
+static const _radio_band_plan_s *__radio_get_band(radio_s *handle)
+{
+	return _RADIO_ATOMIC_GET(handle->band);
+}
+
+static bool __radio_band_contains(const _radio_band_plan_s *band, int frequency)
+{
+	return frequency >= band->min && frequency <= band->max && (frequency - band->min) % band->spacing == 0;
+}
+
+/* Starts the spectrum map of the current band over, seeded with the stations kept from the previous sessions */
+static void __radio_spectrum_reset(radio_s *handle)
+{
+	const _radio_band_plan_s *band = __radio_get_band(handle);
+	radio_station_s stations[_RADIO_STATION_CACHE_MAX];
+	int count = _radio_station_cache_copy(&handle->stations, stations, _RADIO_STATION_CACHE_MAX);
+	int i;
+
+	_radio_spectrum_init(&handle->spectrum, band->min, band->max, band->spacing);
+	for(i = 0; i < count; i++)
+		_radio_spectrum_set(&handle->spectrum, stations[i].frequency, stations[i].rssi);
+}
+
 static int __convert_error_code(int code, char *func_name)
 {
 	int ret = RADIO_ERROR_NONE;
@@ -86,7 +170,8 @@ static int __convert_error_code(int code, char *func_name)
 			ret= RADIO_ERROR_INVALID_OPERATION;
 			msg = "RADIO_ERROR_INVALID_OPERATION";
 	} 
-	LOGE("[%s] %s(0x%08x) : core fw error(0x%x)",func_name,msg, ret, code);
+	if(ret != RADIO_ERROR_NONE)
+		LOGE("[%s] %s(0x%08x) : core fw error(0x%x)",func_name,msg, ret, code);
 	return ret;	
 }
 
@@ -111,415 +196,3564 @@ static radio_state_e __convert_radio_state(MMRadioStateType state)
 	return converted_state;
 }
 
-static int __set_callback(_radio_event_e type, radio_h radio, void* callback, void *user_data)
+/*
+* The state, frequency and mute status are mirrored in radio_s so that getters never call into the backend.
+* Messages from the backend are authoritative for the state : a setter only applies the state it expects
+* when no state change was reported while its backend call was running.
+*/
+static radio_state_e __radio_get_cached_state(radio_s *handle)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	RADIO_NULL_ARG_CHECK(callback);
-	radio_s * handle = (radio_s *) radio; 
-	handle->user_cb[type] = callback;
-	handle->user_data[type] = user_data;
-	LOGI("[%s] Event type : %d ",__FUNCTION__, type);
-	return RADIO_ERROR_NONE; 
+	return _RADIO_STATE_WORD_STATE(_RADIO_ATOMIC_GET(handle->state_word));
 }
 
-static int __unset_callback(_radio_event_e type, radio_h radio)
+/* Wakes the signal strength sampler up so that it follows the state. A quick stop and start still restarts the reference. */
+static void __radio_sampler_notify(radio_s *handle)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio; 
-	handle->user_cb[type] = NULL;
-	handle->user_data[type] = NULL;
-	LOGI("[%s] Event type : %d ",__FUNCTION__, type);
-	return RADIO_ERROR_NONE; 
+	if(!_RADIO_ATOMIC_GET(handle->sampler.thread_started))
+		return;
+	pthread_mutex_lock(&handle->sampler.lock);
+	handle->sampler.restart = TRUE;
+	pthread_cond_signal(&handle->sampler.cond);
+	pthread_mutex_unlock(&handle->sampler.lock);
 }
 
-static int __msg_callback(int message, void *param, void *user_data)
+static void __radio_af_notify(radio_s *handle)
 {
-	radio_s * handle = (radio_s*)user_data;
-	MMMessageParamType *msg = (MMMessageParamType*)param;
-	LOGI("[%s] Got message type : 0x%x" ,__FUNCTION__, message);
-	switch(message)
+	if(!_RADIO_ATOMIC_GET(handle->af.thread_started))
+		return;
+	pthread_mutex_lock(&handle->af.lock);
+	pthread_cond_signal(&handle->af.cond);
+	pthread_mutex_unlock(&handle->af.lock);
+}
+
+static void __radio_rds_notify(radio_s *handle)
+{
+	if(!_RADIO_ATOMIC_GET(handle->rds.thread_started))
+		return;
+	pthread_mutex_lock(&handle->rds.lock);
+	pthread_cond_signal(&handle->rds.cond);
+	pthread_mutex_unlock(&handle->rds.lock);
+}
+
+static void __radio_pcm_tap_notify(radio_s *handle)
+{
+	if(!_RADIO_ATOMIC_GET(handle->tap.thread_started))
+		return;
+	pthread_mutex_lock(&handle->tap.lock);
+	pthread_cond_signal(&handle->tap.cond);
+	pthread_mutex_unlock(&handle->tap.lock);
+}
+
+/* Records an event for radio_read_events() once radio_get_event_fd() was called */
+static void __radio_post_event(radio_s *handle, radio_event_e type, int value)
+{
+	if(_RADIO_ATOMIC_GET(handle->events.fd) >= 0)
+		_radio_event_ring_post(&handle->events, type, value, _radio_stats_now());
+}
+
+/* Seqlock writer side : waits for the other writers, the sequence number stays odd until __radio_seq_write_end() */
+static uint32_t __radio_seq_write_begin(uint32_t *seq)
+{
+	uint32_t value = __atomic_load_n(seq, __ATOMIC_RELAXED);
+	do {
+		while(value & 1)
+			value = __atomic_load_n(seq, __ATOMIC_RELAXED);
+	} while(!__atomic_compare_exchange_n(seq, &value, value + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	return value;
+}
+
+static void __radio_seq_write_end(uint32_t *seq, uint32_t value)
+{
+	__atomic_store_n(seq, value + 2, __ATOMIC_RELEASE);
+}
+
+/*
+* Status snapshot, see radio_get_status().
+* Every write of a value of the snapshot goes through the status seqlock.
+*/
+static void __radio_set_cached_frequency(radio_s *handle, int frequency)
+{
+	uint32_t seq = __radio_seq_write_begin(&handle->status.seq);
+	__atomic_store_n(&handle->frequency, frequency, __ATOMIC_RELEASE);
+	__radio_seq_write_end(&handle->status.seq, seq);
+}
+
+static void __radio_set_cached_mute(radio_s *handle, bool muted)
+{
+	uint32_t seq = __radio_seq_write_begin(&handle->status.seq);
+	__atomic_store_n(&handle->mute, muted, __ATOMIC_RELEASE);
+	__radio_seq_write_end(&handle->status.seq, seq);
+}
+
+static void __radio_status_scan_info(radio_s *handle, int frequency)
+{
+	uint32_t seq = __radio_seq_write_begin(&handle->status.seq);
+	__atomic_store_n(&handle->status.scan_frequency, frequency, __ATOMIC_RELAXED);
+	__atomic_store_n(&handle->status.scan_station_count, handle->status.scan_station_count + 1, __ATOMIC_RELAXED);
+	__radio_seq_write_end(&handle->status.seq, seq);
+}
+
+static void __radio_status_interrupted(radio_s *handle, radio_interrupted_code_e code)
+{
+	uint32_t seq = __radio_seq_write_begin(&handle->status.seq);
+	__atomic_store_n(&handle->status.interrupted_code, code, __ATOMIC_RELAXED);
+	__atomic_store_n(&handle->status.interrupted, TRUE, __ATOMIC_RELAXED);
+	__radio_seq_write_end(&handle->status.seq, seq);
+}
+
+/* Called inside a status update : a new scan starts its progress from zero */
+static void __radio_status_state(radio_s *handle, radio_state_e previous, radio_state_e state)
+{
+	if(state == RADIO_STATE_SCANNING && previous != RADIO_STATE_SCANNING)
 	{
-		case MM_MESSAGE_RADIO_SCAN_INFO: 
-			if( handle->user_cb[_RADIO_EVENT_TYPE_SCAN_INFO] )
-			{
-				((radio_scan_updated_cb)handle->user_cb[_RADIO_EVENT_TYPE_SCAN_INFO])(msg->radio_scan.frequency,handle->user_data[_RADIO_EVENT_TYPE_SCAN_INFO]);
-			}	
-			break;	
-		case MM_MESSAGE_RADIO_SCAN_STOP: 
-			if( handle->user_cb[_RADIO_EVENT_TYPE_SCAN_STOP] )
-			{
-				((radio_scan_stopped_cb)handle->user_cb[_RADIO_EVENT_TYPE_SCAN_STOP])(handle->user_data[_RADIO_EVENT_TYPE_SCAN_STOP]);
-			}
+		__atomic_store_n(&handle->status.scan_frequency, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&handle->status.scan_station_count, 0, __ATOMIC_RELAXED);
+	}
+}
+
+/* Restarts the idle period of the device, see radio_set_idle_timeout() */
+static void __radio_touch(radio_s *handle)
+{
+	_RADIO_ATOMIC_SET(handle->last_activity, _radio_stats_now());
+}
+
+static void __radio_on_state_changed(radio_s *handle, radio_state_e previous, radio_state_e state)
+{
+	__radio_touch(handle);
+	_radio_trace_write(&handle->trace, _radio_stats_now(), _RADIO_TRACE_STATE, previous, state);
+	__radio_post_event(handle, RADIO_EVENT_STATE_CHANGED, state);
+	__radio_sampler_notify(handle);
+	__radio_af_notify(handle);
+	__radio_rds_notify(handle);
+	__radio_pcm_tap_notify(handle);
+}
+
+static void __radio_set_state_from_backend(radio_s *handle, radio_state_e state)
+{
+	uint32_t seq = __radio_seq_write_begin(&handle->status.seq);
+	uint64_t word = _RADIO_ATOMIC_GET(handle->state_word);
+	while(!__atomic_compare_exchange_n(&handle->state_word, &word, _RADIO_STATE_WORD(_RADIO_STATE_WORD_SEQ(word) + 1, state),
+		false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+	__radio_status_state(handle, _RADIO_STATE_WORD_STATE(word), state);
+	__radio_seq_write_end(&handle->status.seq, seq);
+	if(_RADIO_STATE_WORD_STATE(word) != state)
+		__radio_on_state_changed(handle, _RADIO_STATE_WORD_STATE(word), state);
+}
+
+static void __radio_set_state_if_unchanged(radio_s *handle, uint64_t word, radio_state_e state)
+{
+	uint32_t seq = __radio_seq_write_begin(&handle->status.seq);
+	bool changed = __atomic_compare_exchange_n(&handle->state_word, &word, _RADIO_STATE_WORD(_RADIO_STATE_WORD_SEQ(word), state),
+		false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	if(changed)
+		__radio_status_state(handle, _RADIO_STATE_WORD_STATE(word), state);
+	__radio_seq_write_end(&handle->status.seq, seq);
+	if(changed && _RADIO_STATE_WORD_STATE(word) != state)
+	{
+		__radio_on_state_changed(handle, _RADIO_STATE_WORD_STATE(word), state);
+	}
+}
+
+/*
+* Callback table.
+* Registration may race with event delivery from the backend's thread. Writers serialize on the slot's sequence
+* number and readers retry until they read a pair which was not being rewritten, so a callback is never called
+* with the user data of another registration. A callback may still run once right after it is unset.
+*/
+static void __radio_publish_callback(_radio_callback_slot_s *slot, const void *callback, void *user_data)
+{
+	uint32_t seq = __radio_seq_write_begin(&slot->seq);
+	__atomic_store_n(&slot->callback, callback, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->user_data, user_data, __ATOMIC_RELAXED);
+	__radio_seq_write_end(&slot->seq, seq);
+}
+
+static const void *__radio_get_callback(radio_s *handle, _radio_event_e type, void **user_data)
+{
+	_radio_callback_slot_s *slot = &handle->user_cb[type];
+	const void *callback;
+	uint32_t seq;
+
+	while(1)
+	{
+		seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		if(seq & 1)
+			continue;
+		callback = __atomic_load_n(&slot->callback, __ATOMIC_RELAXED);
+		*user_data = __atomic_load_n(&slot->user_data, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq)
+			return callback;
+	}
+}
+
+/*
+* Event context.
+* Once radio_set_event_context() is called, the events are queued with the callback and user data of the time of
+* the event and the callbacks are invoked on the thread of the context. Replacing or unsetting a callback drops its
+* queued events. Without a context, the callbacks are invoked directly on the thread of the event.
+*/
+static const _radio_dispatch_event_e __dispatch_events[_RADIO_EVENT_TYPE_NUM] = {
+	[_RADIO_EVENT_TYPE_SCAN_INFO] = _RADIO_DISPATCH_SCAN_INFO,
+	[_RADIO_EVENT_TYPE_SCAN_STOP] = _RADIO_DISPATCH_SCAN_STOP,
+	[_RADIO_EVENT_TYPE_SCAN_FINISH] = _RADIO_DISPATCH_SCAN_FINISH,
+	[_RADIO_EVENT_TYPE_SEEK_FINISH] = _RADIO_DISPATCH_SEEK_FINISH,
+	[_RADIO_EVENT_TYPE_INTERRUPT] = _RADIO_DISPATCH_INTERRUPT,
+	[_RADIO_EVENT_TYPE_SCAN_BATCH] = _RADIO_DISPATCH_SCAN_BATCH,
+};
+
+static void __radio_dispatch_handler(const _radio_dispatch_entry_s *entry, const radio_station_s *stations)
+{
+	switch(entry->event)
+	{
+		case _RADIO_DISPATCH_SCAN_INFO:
+			((radio_scan_updated_cb)entry->callback)(entry->args[0], entry->user_data);
 			break;
-		case MM_MESSAGE_RADIO_SCAN_FINISH:
-			if( handle->user_cb[_RADIO_EVENT_TYPE_SCAN_FINISH] )
-			{
-				((radio_scan_completed_cb)handle->user_cb[_RADIO_EVENT_TYPE_SCAN_FINISH])(handle->user_data[_RADIO_EVENT_TYPE_SCAN_FINISH]);
-			}
+		case _RADIO_DISPATCH_SCAN_STOP:
+			((radio_scan_stopped_cb)entry->callback)(entry->user_data);
 			break;
-		case MM_MESSAGE_RADIO_SEEK_FINISH: 
-			if( handle->user_cb[_RADIO_EVENT_TYPE_SEEK_FINISH] )
-			{
-				((radio_seek_completed_cb)handle->user_cb[_RADIO_EVENT_TYPE_SEEK_FINISH])(msg->radio_scan.frequency, handle->user_data[_RADIO_EVENT_TYPE_SEEK_FINISH]);
-			}	
+		case _RADIO_DISPATCH_SCAN_FINISH:
+			((radio_scan_completed_cb)entry->callback)(entry->user_data);
 			break;
-		case MM_MESSAGE_STATE_INTERRUPTED: 
-			if( handle->user_cb[_RADIO_EVENT_TYPE_INTERRUPT] )
-			{
-				((radio_interrupted_cb)handle->user_cb[_RADIO_EVENT_TYPE_INTERRUPT])(msg->code,handle->user_data[_RADIO_EVENT_TYPE_INTERRUPT]);
-			}
+		case _RADIO_DISPATCH_SEEK_FINISH:
+			((radio_seek_completed_cb)entry->callback)(entry->args[0], entry->user_data);
 			break;
-		case  MM_MESSAGE_ERROR: 
-				__convert_error_code(msg->code,(char*)__FUNCTION__);
+		case _RADIO_DISPATCH_INTERRUPT:
+			((radio_interrupted_cb)entry->callback)(entry->args[0], entry->user_data);
 			break;
-		case MM_MESSAGE_RADIO_SCAN_START: 
-			LOGI("[%s] Scan Started");
+		case _RADIO_DISPATCH_SCAN_BATCH:
+			((radio_scan_batch_cb)entry->callback)(stations, entry->station_count, entry->user_data);
 			break;
-		case  MM_MESSAGE_STATE_CHANGED:	
-			handle->state = __convert_radio_state(msg->state.current);
-			LOGI("[%s] State Changed --- from : %d , to : %d" ,__FUNCTION__,  __convert_radio_state(msg->state.previous), handle->state);
+		case _RADIO_DISPATCH_SIGNAL_STRENGTH:
+			((radio_signal_strength_changed_cb)entry->callback)(entry->args[0], entry->args[1], entry->user_data);
+			break;
+		case _RADIO_DISPATCH_COMMAND:
+			((radio_command_completed_cb)entry->callback)(entry->args[0], entry->args[1], entry->args[2], entry->user_data);
+			break;
+		case _RADIO_DISPATCH_READY:
+			((radio_ready_cb)entry->callback)(entry->args[0], entry->user_data);
+			break;
+		case _RADIO_DISPATCH_ALTERNATE_FREQUENCY:
+			((radio_alternate_frequency_cb)entry->callback)(entry->args[0], entry->args[1], entry->args[2], entry->user_data);
+			break;
+		case _RADIO_DISPATCH_RDS:
+			((radio_rds_changed_cb)entry->callback)(entry->args[0], entry->args[1], entry->user_data);
+			break;
+		case _RADIO_DISPATCH_LEVEL:
+			((radio_level_cb)entry->callback)(entry->args[0], entry->args[1], entry->args[2], entry->user_data);
 			break;
-		case MM_MESSAGE_RADIO_SEEK_START:
-			LOGI("[%s] Seek Started", __FUNCTION__);
-			break;	
 		default:
 			break;
 	}
-	return 1;
 }
 
-
-/*
-* Public Implementation
-*/
-int radio_create(radio_h *radio)
+/* Queues an event on the context. Returns FALSE when there is no context and the callback is to be invoked directly. */
+static bool __radio_dispatch(radio_s *handle, _radio_dispatch_event_e event, const void *callback, void *user_data,
+	int arg0, int arg1, int arg2, bool coalesce)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle;
-	handle = (radio_s*)malloc( sizeof(radio_s));
-	if (handle != NULL)
-		memset(handle, 0 , sizeof(radio_s));
-	else
-	{
-		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x)" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY);
-		return RADIO_ERROR_OUT_OF_MEMORY;
-	}
-	int ret = mm_radio_create(&handle->mm_handle);
-	if( ret != MM_ERROR_NONE)
-	{
-		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
-		free(handle);
-		handle=NULL;
-		return RADIO_ERROR_INVALID_OPERATION;
-	}
-	else
+	_radio_dispatch_entry_s entry;
+	bool queued = FALSE;
+
+	if(_RADIO_ATOMIC_GET(handle->dispatch) == NULL)
+		return FALSE;
+	entry.event = event;
+	entry.callback = callback;
+	entry.user_data = user_data;
+	entry.args[0] = arg0;
+	entry.args[1] = arg1;
+	entry.args[2] = arg2;
+	entry.station_count = 0;
+	entry.coalesce = coalesce;
+
+	pthread_mutex_lock(&handle->dispatch_lock);
+	if(handle->dispatch != NULL)
 	{
-		*radio = (radio_h)handle;
-		
-		ret = mm_radio_set_message_callback(handle->mm_handle, __msg_callback, (void*)handle);
-		if(ret != MM_ERROR_NONE)
-		{
-			LOGW("[%s] Failed to set message callback function (0x%x)" ,__FUNCTION__, ret);
-		}
-		ret = mm_radio_realize(handle->mm_handle);
-		if(ret != MM_ERROR_NONE)
-		{
-			return __convert_error_code(ret,(char*)__FUNCTION__);
-		}
-		handle->state = RADIO_STATE_READY;
-		handle->mute = FALSE;
-		return RADIO_ERROR_NONE;
+		_radio_dispatch_push(handle->dispatch, &entry);
+		queued = TRUE;
 	}
+	pthread_mutex_unlock(&handle->dispatch_lock);
+	return queued;
 }
 
-int radio_destroy(radio_h radio)
+static bool __radio_dispatch_stations(radio_s *handle, const void *callback, void *user_data, const radio_station_s *stations, int count)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
+	bool queued = FALSE;
 
-	int ret;
-	ret = mm_radio_unrealize(handle->mm_handle);
-	if ( ret!= MM_ERROR_NONE)
-	{
-		LOGW("[%s] Failed to unrealize (0x%x)" ,__FUNCTION__, ret);
-	}
-	
-	ret = mm_radio_destroy(handle->mm_handle);
-	if (ret!= MM_ERROR_NONE)
-	{
-		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION (0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
-		return RADIO_ERROR_INVALID_OPERATION;
-	}
-	else
+	if(_RADIO_ATOMIC_GET(handle->dispatch) == NULL)
+		return FALSE;
+	pthread_mutex_lock(&handle->dispatch_lock);
+	if(handle->dispatch != NULL)
 	{
-		free(handle);
-		handle= NULL;
-		return RADIO_ERROR_NONE;
+		_radio_dispatch_push_stations(handle->dispatch, callback, user_data, stations, count);
+		queued = TRUE;
 	}
+	pthread_mutex_unlock(&handle->dispatch_lock);
+	return queued;
+}
+
+static void __radio_dispatch_purge(radio_s *handle, _radio_dispatch_event_e event, const void *callback, void *user_data)
+{
+	if(_RADIO_ATOMIC_GET(handle->dispatch) == NULL)
+		return;
+	pthread_mutex_lock(&handle->dispatch_lock);
+	if(handle->dispatch != NULL)
+		_radio_dispatch_purge(handle->dispatch, event, callback, user_data);
+	pthread_mutex_unlock(&handle->dispatch_lock);
 }
 
-int  radio_get_state(radio_h radio, radio_state_e *state)
+static int __set_callback(_radio_event_e type, radio_h radio, void* callback, void *user_data)
 {
 	RADIO_INSTANCE_CHECK(radio);
-	RADIO_NULL_ARG_CHECK(state);
-	radio_s * handle = (radio_s *) radio;
-	MMRadioStateType currentStat = MM_RADIO_STATE_NULL;
-	int ret = mm_radio_get_state(handle->mm_handle, &currentStat);
-	if(ret != MM_ERROR_NONE)
-	{
-		*state = handle->state;
-		return __convert_error_code(ret,(char*)__FUNCTION__);
-	}
-	else
-	{
-		handle->state  = __convert_radio_state(currentStat);
-		*state = handle->state;
-		return RADIO_ERROR_NONE;
-	}
+	RADIO_NULL_ARG_CHECK(callback);
+	radio_s * handle = _radio_handle_get(radio); 
+	void *previous_data;
+	const void *previous = __radio_get_callback(handle, type, &previous_data);
+	__radio_publish_callback(&handle->user_cb[type], callback, user_data);
+	if(previous != NULL && (previous != callback || previous_data != user_data))
+		__radio_dispatch_purge(handle, __dispatch_events[type], previous, previous_data);
+	_radio_trace_write(&handle->trace, _radio_stats_now(), _RADIO_TRACE_SET_CALLBACK, type, 0);
+	RADIO_HOT_LOGI("[%s] Event type : %d ",__FUNCTION__, type);
+	return RADIO_ERROR_NONE; 
 }
 
-int radio_start(radio_h radio)
+static int __unset_callback(_radio_event_e type, radio_h radio)
 {
 	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
-	RADIO_STATE_CHECK(handle,RADIO_STATE_READY);  
+	radio_s * handle = _radio_handle_get(radio); 
+	void *previous_data;
+	const void *previous = __radio_get_callback(handle, type, &previous_data);
+	__radio_publish_callback(&handle->user_cb[type], NULL, NULL);
+	if(previous != NULL)
+		__radio_dispatch_purge(handle, __dispatch_events[type], previous, previous_data);
+	_radio_trace_write(&handle->trace, _radio_stats_now(), _RADIO_TRACE_UNSET_CALLBACK, type, 0);
+	RADIO_HOT_LOGI("[%s] Event type : %d ",__FUNCTION__, type);
+	return RADIO_ERROR_NONE; 
+}
 
-	int ret = mm_radio_start(handle->mm_handle);
-	if(ret != MM_ERROR_NONE)
-	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
-	}
-	else
+/*
+* Listeners.
+* Events iterate the published listener array without a lock. An event counts itself in the readers of the array,
+* then checks that the array is still published : a writer only refills an array which is neither published nor read.
+* The arrays are preallocated in the handle, so adding and removing a listener never allocates.
+* Without listeners, an event costs a single extra load.
+*/
+/* Called with listener_lock held. Returns an array which no event can read, NULL when they are all in use. */
+static _radio_listener_array_s *__radio_listeners_spare(radio_s *handle)
+{
+	int i, type;
+
+	for(i = 0; i < _RADIO_LISTENER_ARRAYS; i++)
 	{
-		handle->state = RADIO_STATE_PLAYING;
-		return RADIO_ERROR_NONE;
+		_radio_listener_array_s *array = &handle->listener_pool[i];
+		for(type = 0; type < _RADIO_EVENT_TYPE_NUM; type++)
+		{
+			if(handle->listeners[type] == array)
+				break;
+		}
+		if(type == _RADIO_EVENT_TYPE_NUM && __atomic_load_n(&array->readers, __ATOMIC_SEQ_CST) == 0)
+			return array;
 	}
+	LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x) : %d listener arrays in use" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY, _RADIO_LISTENER_ARRAYS);
+	return NULL;
 }
 
-int radio_stop(radio_h radio)
+static int __radio_add_listener(radio_h radio, _radio_event_e type, const void *callback, void *user_data, int *id)
 {
 	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
-	RADIO_STATE_CHECK(handle,RADIO_STATE_PLAYING);  
-	
-	int ret = mm_radio_stop(handle->mm_handle);
-	if(ret != MM_ERROR_NONE)
+	RADIO_NULL_ARG_CHECK(callback);
+	RADIO_NULL_ARG_CHECK(id);
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_listener_array_s *previous, *array;
+	int count;
+
+	pthread_mutex_lock(&handle->listener_lock);
+	previous = handle->listeners[type];
+	count = previous ? previous->count : 0;
+	if(count == _RADIO_LISTENER_MAX)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		pthread_mutex_unlock(&handle->listener_lock);
+		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x) : %d listeners already" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY, count);
+		return RADIO_ERROR_OUT_OF_MEMORY;
 	}
-	else
+	array = __radio_listeners_spare(handle);
+	if(array == NULL)
 	{
-		handle->state = RADIO_STATE_READY;
-		return RADIO_ERROR_NONE;
+		pthread_mutex_unlock(&handle->listener_lock);
+		return RADIO_ERROR_OUT_OF_MEMORY;
 	}
+	if(count > 0)
+		memcpy(array->listeners, previous->listeners, sizeof(_radio_listener_s) * count);
+	array->count = count + 1;
+	array->listeners[count].id = ++handle->listener_next_id;
+	array->listeners[count].callback = callback;
+	array->listeners[count].user_data = user_data;
+	*id = array->listeners[count].id;
+	__atomic_store_n(&handle->listeners[type], array, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&handle->listener_lock);
+
+	_radio_trace_write(&handle->trace, _radio_stats_now(), _RADIO_TRACE_SET_CALLBACK, type, *id);
+	return RADIO_ERROR_NONE;
 }
 
-int radio_seek_up(radio_h radio,radio_seek_completed_cb callback, void *user_data )
+static int __radio_remove_listener(radio_h radio, int id)
 {
 	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
-	RADIO_STATE_CHECK(handle,RADIO_STATE_PLAYING);
-	
-	if(callback!=NULL)
-	{
-		__set_callback(_RADIO_EVENT_TYPE_SEEK_FINISH,radio,callback,user_data);
-	}
-	else
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_listener_array_s *previous, *array = NULL;
+	_radio_listener_s removed;
+	int type, i, index = -1;
+
+	pthread_mutex_lock(&handle->listener_lock);
+	for(type = 0; type < _RADIO_EVENT_TYPE_NUM && index < 0; type++)
 	{
-		__unset_callback(_RADIO_EVENT_TYPE_SEEK_FINISH,radio);
+		previous = handle->listeners[type];
+		for(i = 0; previous != NULL && i < previous->count; i++)
+		{
+			if(previous->listeners[i].id == id)
+			{
+				index = i;
+				break;
+			}
+		}
 	}
-	
-	int ret = mm_radio_seek(handle->mm_handle, MM_RADIO_SEEK_UP);
-	if(ret != MM_ERROR_NONE)
+	if(index < 0)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		pthread_mutex_unlock(&handle->listener_lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Unknown listener %d" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, id);
+		return RADIO_ERROR_INVALID_PARAMETER;
 	}
-	else
+	type--;
+	removed = previous->listeners[index];
+	if(previous->count > 1)
 	{
-		return RADIO_ERROR_NONE;
+		array = __radio_listeners_spare(handle);
+		if(array == NULL)
+		{
+			pthread_mutex_unlock(&handle->listener_lock);
+			return RADIO_ERROR_OUT_OF_MEMORY;
+		}
+		memcpy(array->listeners, previous->listeners, sizeof(_radio_listener_s) * index);
+		memcpy(array->listeners + index, previous->listeners + index + 1, sizeof(_radio_listener_s) * (previous->count - index - 1));
+		array->count = previous->count - 1;
 	}
+	__atomic_store_n(&handle->listeners[type], array, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&handle->listener_lock);
+
+	__radio_dispatch_purge(handle, __dispatch_events[type], removed.callback, removed.user_data);
+	_radio_trace_write(&handle->trace, _radio_stats_now(), _RADIO_TRACE_UNSET_CALLBACK, type, id);
+	return RADIO_ERROR_NONE;
 }
 
-int radio_seek_down(radio_h radio,radio_seek_completed_cb callback, void *user_data )
+static void __radio_notify_listeners(radio_s *handle, _radio_event_e type, int value)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
-	RADIO_STATE_CHECK(handle,RADIO_STATE_PLAYING);
-	
-	if(callback!=NULL)
+	_radio_listener_array_s *array;
+	const _radio_listener_s *listener;
+	int i;
+
+	array = __atomic_load_n(&handle->listeners[type], __ATOMIC_RELAXED);
+	while(array != NULL)
 	{
-		__set_callback(_RADIO_EVENT_TYPE_SEEK_FINISH,radio,callback,user_data);
+		__atomic_add_fetch(&array->readers, 1, __ATOMIC_SEQ_CST);
+		if(__atomic_load_n(&handle->listeners[type], __ATOMIC_SEQ_CST) == array)
+			break;
+		/* replaced meanwhile, a writer may be refilling it */
+		__atomic_sub_fetch(&array->readers, 1, __ATOMIC_SEQ_CST);
+		array = __atomic_load_n(&handle->listeners[type], __ATOMIC_SEQ_CST);
 	}
-	else
+	if(array == NULL)
+		return;
+	for(i = 0; i < array->count; i++)
 	{
-		__unset_callback(_RADIO_EVENT_TYPE_SEEK_FINISH,radio);
+		listener = &array->listeners[i];
+		if(__radio_dispatch(handle, __dispatch_events[type], listener->callback, listener->user_data, value, 0, 0, FALSE))
+			continue;
+		switch(type)
+		{
+			case _RADIO_EVENT_TYPE_SCAN_INFO:
+				((radio_scan_updated_cb)listener->callback)(value, listener->user_data);
+				break;
+			case _RADIO_EVENT_TYPE_SCAN_FINISH:
+				((radio_scan_completed_cb)listener->callback)(listener->user_data);
+				break;
+			case _RADIO_EVENT_TYPE_INTERRUPT:
+				((radio_interrupted_cb)listener->callback)(value, listener->user_data);
+				break;
+			default:
+				break;
+		}
 	}
-	
-	int ret = mm_radio_seek(handle->mm_handle, MM_RADIO_SEEK_DOWN);
-	if(ret != MM_ERROR_NONE)
+	__atomic_sub_fetch(&array->readers, 1, __ATOMIC_SEQ_CST);
+}
+
+/* Best effort : the station is still recorded when the tuner cannot report its signal strength */
+static int __radio_read_rssi(radio_s *handle)
+{
+	int rssi = 0;
+	if(handle->backend->get_signal_strength(handle->mm_handle, &rssi) != MM_ERROR_NONE)
+		rssi = 0;
+	return rssi;
+}
+
+/*
+* Batched scan results.
+* Stations are appended to the preallocated radio_s::batch and delivered together by count, by age or at the end of the scan,
+* from a copy taken under its lock.
+*/
+static void __radio_deadline(struct timespec *deadline, int timeout_ms)
+{
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += timeout_ms / 1000;
+	deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+	if(deadline->tv_nsec >= 1000000000L)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000L;
 	}
-	else
+}
+
+static int64_t __radio_now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Moves the pending stations to stations, with batch->lock held. Returns their number. */
+static int __radio_batch_take(_radio_scan_batch_s *batch, radio_station_s *stations)
+{
+	int count = batch->count;
+
+	memcpy(stations, batch->stations, sizeof(radio_station_s) * count);
+	batch->count = 0;
+	return count;
+}
+
+/* Delivered without batch->lock held, the callback may stop the scan */
+static void __radio_batch_deliver(radio_s *handle, const radio_station_s *stations, int count)
+{
+	void *user_data;
+	radio_scan_batch_cb callback;
+
+	if(count == 0)
+		return;
+	callback = (radio_scan_batch_cb)__radio_get_callback(handle, _RADIO_EVENT_TYPE_SCAN_BATCH, &user_data);
+	if( callback && !__radio_dispatch_stations(handle, callback, user_data, stations, count))
 	{
-		return RADIO_ERROR_NONE;
+		callback(stations, count, user_data);
 	}
 }
 
-int radio_set_frequency(radio_h radio, int frequency)
+static bool __radio_batch_expired(_radio_scan_batch_s *batch)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	if(frequency < 87500 || frequency > 108000)
+	int max_latency_ms = _RADIO_ATOMIC_GET(batch->max_latency_ms);
+
+	return batch->count > 0 && max_latency_ms > 0 && __radio_now_ms() - batch->first_ms >= max_latency_ms;
+}
+
+static void __radio_batch_flush(radio_s *handle)
+{
+	_radio_scan_batch_s *batch = &handle->batch;
+	radio_station_s stations[_RADIO_STATION_CACHE_MAX];
+	int count;
+
+	pthread_mutex_lock(&batch->lock);
+	count = __radio_batch_take(batch, stations);
+	pthread_mutex_unlock(&batch->lock);
+	__radio_batch_deliver(handle, stations, count);
+}
+
+/* Flushes the pending stations once the oldest of them is too old */
+static void __radio_batch_poll(radio_s *handle)
+{
+	_radio_scan_batch_s *batch = &handle->batch;
+	radio_station_s stations[_RADIO_STATION_CACHE_MAX];
+	int count = 0;
+
+	pthread_mutex_lock(&batch->lock);
+	if(__radio_batch_expired(batch))
+		count = __radio_batch_take(batch, stations);
+	pthread_mutex_unlock(&batch->lock);
+	__radio_batch_deliver(handle, stations, count);
+}
+
+static void __radio_batch_add(radio_s *handle, int frequency, int rssi, time_t timestamp)
+{
+	_radio_scan_batch_s *batch = &handle->batch;
+	radio_station_s stations[_RADIO_STATION_CACHE_MAX];
+	int max_count = _RADIO_ATOMIC_GET(batch->max_count);
+	int count = 0;
+	void *user_data;
+
+	if(__radio_get_callback(handle, _RADIO_EVENT_TYPE_SCAN_BATCH, &user_data) == NULL)
+		return;
+	if(max_count <= 0 || max_count > _RADIO_STATION_CACHE_MAX)
+		max_count = _RADIO_STATION_CACHE_MAX;
+
+	pthread_mutex_lock(&batch->lock);
+	if(batch->count == 0)
+		batch->first_ms = __radio_now_ms();
+	batch->stations[batch->count].frequency = frequency;
+	batch->stations[batch->count].rssi = rssi;
+	batch->stations[batch->count].timestamp = timestamp;
+	batch->count++;
+	if(batch->count >= max_count || __radio_batch_expired(batch))
+		count = __radio_batch_take(batch, stations);
+	pthread_mutex_unlock(&batch->lock);
+	__radio_batch_deliver(handle, stations, count);
+}
+
+static void __radio_on_scan_info(radio_s *handle, int frequency, int rssi)
+{
+	void *user_data;
+	radio_scan_updated_cb callback = (radio_scan_updated_cb)__radio_get_callback(handle, _RADIO_EVENT_TYPE_SCAN_INFO, &user_data);
+	time_t now = time(NULL);
+	_radio_station_cache_update(&handle->stations, frequency, rssi, now);
+	_radio_spectrum_set(&handle->spectrum, frequency, rssi);
+	__radio_status_scan_info(handle, frequency);
+	__radio_post_event(handle, RADIO_EVENT_SCAN_INFO, frequency);
+	__radio_notify_listeners(handle, _RADIO_EVENT_TYPE_SCAN_INFO, frequency);
+	/* batched before the user callback, which may stop the scan or destroy the handle */
+	__radio_batch_add(handle, frequency, rssi, now);
+	if( callback && !__radio_dispatch(handle, _RADIO_DISPATCH_SCAN_INFO, callback, user_data, frequency, 0, 0, FALSE))
 	{
-		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Out of range (87500 ~ 108000)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
-		return RADIO_ERROR_INVALID_PARAMETER;
+		callback(frequency, user_data);
 	}
-	int freq= frequency;
-	radio_s * handle = (radio_s *) radio;
-	int ret = mm_radio_set_frequency(handle->mm_handle, freq);
-	if(ret != MM_ERROR_NONE)
+}
+
+static void __radio_on_scan_stop(radio_s *handle)
+{
+	void *user_data;
+	radio_scan_stopped_cb callback;
+	__radio_batch_flush(handle);
+	callback = (radio_scan_stopped_cb)__radio_get_callback(handle, _RADIO_EVENT_TYPE_SCAN_STOP, &user_data);
+	_radio_station_cache_sync(&handle->stations);
+	__radio_post_event(handle, RADIO_EVENT_SCAN_STOP, 0);
+	if( callback && !__radio_dispatch(handle, _RADIO_DISPATCH_SCAN_STOP, callback, user_data, 0, 0, 0, FALSE))
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		callback(user_data);
 	}
-	else
+}
+
+static void __radio_on_scan_finish(radio_s *handle)
+{
+	void *user_data;
+	radio_scan_completed_cb callback;
+	__radio_batch_flush(handle);
+	callback = (radio_scan_completed_cb)__radio_get_callback(handle, _RADIO_EVENT_TYPE_SCAN_FINISH, &user_data);
+	_radio_station_cache_sync(&handle->stations);
+	__radio_post_event(handle, RADIO_EVENT_SCAN_FINISH, 0);
+	__radio_notify_listeners(handle, _RADIO_EVENT_TYPE_SCAN_FINISH, 0);
+	if( callback && !__radio_dispatch(handle, _RADIO_DISPATCH_SCAN_FINISH, callback, user_data, 0, 0, 0, FALSE))
 	{
-		return RADIO_ERROR_NONE;
+		callback(user_data);
 	}
 }
 
-int radio_get_frequency(radio_h radio, int *frequency)
+/* The value carried by a message, recorded in the trace */
+static int __radio_message_value(int message, MMMessageParamType *msg)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
-
-	int freq;
-	int ret = mm_radio_get_frequency(handle->mm_handle, &freq);
-	if(ret != MM_ERROR_NONE)
+	switch(message)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		case MM_MESSAGE_RADIO_SCAN_INFO:
+		case MM_MESSAGE_RADIO_SEEK_FINISH:
+			return msg->radio_scan.frequency;
+		case MM_MESSAGE_STATE_CHANGED:
+			return msg->state.current;
+		case MM_MESSAGE_STATE_INTERRUPTED:
+		case MM_MESSAGE_ERROR:
+			return msg->code;
+		default:
+			return 0;
 	}
-	else
+}
+
+static int __msg_callback(int message, void *param, void *user_data)
+{
+	radio_s * handle = (radio_s*)user_data;
+	MMMessageParamType *msg = (MMMessageParamType*)param;
+	void *cb_data;
+	uint64_t start = _radio_stats_now();
+	_radio_stats_e stats = _RADIO_STATS_MESSAGE_OTHER;
+	int error = RADIO_ERROR_NONE;
+	/* the callbacks may destroy the handle, nothing is recorded in it after the switch */
+	_radio_trace_write(&handle->trace, start, _RADIO_TRACE_MESSAGE, message, __radio_message_value(message, msg));
+	RADIO_HOT_LOGI("[%s] Got message type : 0x%x" ,__FUNCTION__, message);
+	switch(message)
 	{
-		*frequency = freq; 
-		return RADIO_ERROR_NONE;
+		case MM_MESSAGE_RADIO_SCAN_INFO: 
+			stats = _RADIO_STATS_MESSAGE_SCAN_INFO;
+			/* a stopped hardware scan is resumed by software after the last station it reported */
+			_RADIO_ATOMIC_SET(handle->sweep.next, msg->radio_scan.frequency + handle->sweep.step);
+			/* the tuner's scan is not aware of the channel raster of the region */
+			if(__radio_band_contains(__radio_get_band(handle), msg->radio_scan.frequency))
+				__radio_on_scan_info(handle, msg->radio_scan.frequency, __radio_read_rssi(handle));
+			break;	
+		case MM_MESSAGE_RADIO_SCAN_STOP: 
+			stats = _RADIO_STATS_MESSAGE_SCAN_STOP;
+			_RADIO_ATOMIC_SET(handle->sweep.resumable, TRUE);
+			__radio_on_scan_stop(handle);
+			break;
+		case MM_MESSAGE_RADIO_SCAN_FINISH:
+			stats = _RADIO_STATS_MESSAGE_SCAN_FINISH;
+			_RADIO_ATOMIC_SET(handle->sweep.resumable, FALSE);
+			/* the tuner's own scan only runs on its native band, the start time was published before it started */
+			_radio_station_cache_prune(&handle->stations, RADIO_NATIVE_BAND_MIN, RADIO_NATIVE_BAND_MAX,
+				_RADIO_ATOMIC_GET(handle->sweep.start_time));
+			__radio_on_scan_finish(handle);
+			break;
+		case MM_MESSAGE_RADIO_SEEK_FINISH: 
+			stats = _RADIO_STATS_MESSAGE_SEEK_FINISH;
+			__radio_set_cached_frequency(handle, msg->radio_scan.frequency);
+			__radio_post_event(handle, RADIO_EVENT_SEEK_FINISH, msg->radio_scan.frequency);
+			{
+				radio_seek_completed_cb callback = (radio_seek_completed_cb)__radio_get_callback(handle, _RADIO_EVENT_TYPE_SEEK_FINISH, &cb_data);
+				/* the command queue waits for its own seeks */
+				if( callback && (_RADIO_ATOMIC_GET(handle->commands.seeking)
+					|| !__radio_dispatch(handle, _RADIO_DISPATCH_SEEK_FINISH, callback, cb_data, msg->radio_scan.frequency, 0, 0, FALSE)))
+				{
+					callback(msg->radio_scan.frequency, cb_data);
+				}
+			}
+			break;
+		case MM_MESSAGE_STATE_INTERRUPTED: 
+			stats = _RADIO_STATS_MESSAGE_STATE_INTERRUPTED;
+			/* a scan may end here without SCAN_STOP, its stations are delivered before the next scan starts */
+			__radio_batch_flush(handle);
+			__radio_status_interrupted(handle, msg->code);
+			__radio_post_event(handle, RADIO_EVENT_INTERRUPTED, msg->code);
+			__radio_notify_listeners(handle, _RADIO_EVENT_TYPE_INTERRUPT, msg->code);
+			{
+				radio_interrupted_cb callback = (radio_interrupted_cb)__radio_get_callback(handle, _RADIO_EVENT_TYPE_INTERRUPT, &cb_data);
+				if( callback && !__radio_dispatch(handle, _RADIO_DISPATCH_INTERRUPT, callback, cb_data, msg->code, 0, 0, FALSE))
+				{
+					callback(msg->code, cb_data);
+				}
+			}
+			break;
+		case  MM_MESSAGE_ERROR: 
+			stats = _RADIO_STATS_MESSAGE_ERROR;
+			error = __convert_error_code(msg->code,(char*)__FUNCTION__);
+			_radio_trace_write(&handle->trace, start, _RADIO_TRACE_ERROR, msg->code, error);
+			__radio_post_event(handle, RADIO_EVENT_ERROR, error);
+			break;
+		case MM_MESSAGE_RADIO_SCAN_START: 
+			stats = _RADIO_STATS_MESSAGE_SCAN_START;
+			__radio_post_event(handle, RADIO_EVENT_SCAN_START, 0);
+			RADIO_HOT_LOGI("[%s] Scan Started", __FUNCTION__);
+			break;
+		case  MM_MESSAGE_STATE_CHANGED:	
+			stats = _RADIO_STATS_MESSAGE_STATE_CHANGED;
+			__radio_set_state_from_backend(handle, __convert_radio_state(msg->state.current));
+			RADIO_HOT_LOGI("[%s] State Changed --- from : %d , to : %d" ,__FUNCTION__,  __convert_radio_state(msg->state.previous), __convert_radio_state(msg->state.current));
+			break;
+		case MM_MESSAGE_RADIO_SEEK_START:
+			stats = _RADIO_STATS_MESSAGE_SEEK_START;
+			__radio_post_event(handle, RADIO_EVENT_SEEK_START, 0);
+			RADIO_HOT_LOGI("[%s] Seek Started", __FUNCTION__);
+			break;	
+		default:
+			break;
 	}
-}	
+	_radio_stats_record(stats, start, error);
+	return 1;
+}
 
-int radio_get_signal_strength(radio_h radio, int *strength)
+
+/*
+* Device realization.
+* radio_create() realizes the device right away, radio_create_async() on a worker thread and radio_create_lazy()
+* on the first radio_start() or radio_scan_start(). Until then, frequency and mute changes are only cached
+* and they are applied right after the device is realized.
+*/
+static int __radio_alloc(radio_s **out)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
+	radio_s * handle;
+	handle = _radio_handle_acquire();
+	if (handle == NULL)
+	{
+		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x)" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY);
+		return RADIO_ERROR_OUT_OF_MEMORY;
+	}
+	handle->backend = _radio_backend_get_default();
+	int ret = handle->backend->create(&handle->mm_handle);
+	if( ret != MM_ERROR_NONE)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		_radio_handle_release(handle);
+		handle=NULL;
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	pthread_mutex_init(&handle->realize_lock, NULL);
+	pthread_cond_init(&handle->realize_cond, NULL);
+	pthread_mutex_init(&handle->sampler.lock, NULL);
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&handle->sampler.cond, &attr);
+	pthread_mutex_init(&handle->af.lock, NULL);
+	pthread_cond_init(&handle->af.cond, &attr);
+	pthread_mutex_init(&handle->rds.lock, NULL);
+	pthread_cond_init(&handle->rds.cond, &attr);
+	_radio_rds_cache_init(&handle->rds.cache);
+	pthread_mutex_init(&handle->tap.lock, NULL);
+	pthread_cond_init(&handle->tap.cond, &attr);
+	_radio_pcm_ring_init(&handle->tap.ring);
+	_radio_timeshift_init(&handle->timeshift);
+	_radio_recorder_init(&handle->recorder);
+	_radio_meter_init(&handle->meter);
+	pthread_mutex_init(&handle->commands.lock, NULL);
+	pthread_mutex_init(&handle->dispatch_lock, NULL);
+	pthread_mutex_init(&handle->listener_lock, NULL);
+	pthread_mutex_init(&handle->batch.lock, NULL);
+	_radio_event_ring_init(&handle->events);
+	pthread_cond_init(&handle->commands.cond, &attr);
+	pthread_condattr_destroy(&attr);
+	_RADIO_ATOMIC_SET(handle->realize_status, _RADIO_REALIZE_NONE);
+	handle->state_word = _RADIO_STATE_WORD(0, RADIO_STATE_READY);
+	handle->mute = FALSE;
+	handle->scan_threshold = RADIO_SCAN_THRESHOLD;
+	_RADIO_ATOMIC_SET(handle->band, &__band_plans[RADIO_REGION_EUROPE]);
+	_radio_station_cache_open(&handle->stations, handle->band->min, handle->band->max, handle->band->spacing);
+	__radio_spectrum_reset(handle);
+	handle->predictive_seek = TRUE;
 
-	int _strength;
-	int ret = mm_radio_get_signal_strength(handle->mm_handle, &_strength);
+	ret = handle->backend->set_message_callback(handle->mm_handle, __msg_callback, (void*)handle);
 	if(ret != MM_ERROR_NONE)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		LOGW("[%s] Failed to set message callback function (0x%x)" ,__FUNCTION__, ret);
 	}
-	else
+	*out = handle;
+	return RADIO_ERROR_NONE;
+}
+
+static void __radio_free(radio_s *handle)
+{
+	_radio_handle_invalidate(handle);
+	_radio_station_cache_close(&handle->stations);
+	pthread_cond_destroy(&handle->commands.cond);
+	pthread_mutex_destroy(&handle->commands.lock);
+	pthread_mutex_destroy(&handle->dispatch_lock);
+	pthread_mutex_destroy(&handle->listener_lock);
+	pthread_mutex_destroy(&handle->batch.lock);
+	_radio_event_ring_close(&handle->events);
+	_radio_meter_deinit(&handle->meter);
+	_radio_recorder_deinit(&handle->recorder);
+	_radio_timeshift_deinit(&handle->timeshift);
+	pthread_cond_destroy(&handle->tap.cond);
+	pthread_mutex_destroy(&handle->tap.lock);
+	_radio_rds_cache_deinit(&handle->rds.cache);
+	pthread_cond_destroy(&handle->rds.cond);
+	pthread_mutex_destroy(&handle->rds.lock);
+	pthread_cond_destroy(&handle->af.cond);
+	pthread_mutex_destroy(&handle->af.lock);
+	pthread_cond_destroy(&handle->sampler.cond);
+	pthread_mutex_destroy(&handle->sampler.lock);
+	pthread_cond_destroy(&handle->realize_cond);
+	pthread_mutex_destroy(&handle->realize_lock);
+	_radio_handle_release(handle);
+}
+
+/* Gives up a handle which was never returned to the application */
+static void __radio_discard(radio_s *handle)
+{
+	int ret = handle->backend->destroy(handle->mm_handle);
+	if(ret != MM_ERROR_NONE)
 	{
-		*strength = _strength;
-		return RADIO_ERROR_NONE;
+		LOGW("[%s] Failed to destroy the device (0x%x)" ,__FUNCTION__, ret);
 	}
+	__radio_free(handle);
 }
 
-int radio_scan_start(radio_h radio, radio_scan_updated_cb callback, void *user_data)
+/*
+* On failure realize_status becomes failed_status : _RADIO_REALIZE_FAILED for radio_create(), which discards the handle,
+* otherwise the status the device was realized from, so that the next call which needs the device tries again.
+*/
+static int __radio_realize(radio_s *handle, _radio_realize_e failed_status)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
-	RADIO_STATE_CHECK(handle,RADIO_STATE_READY);  
-
-	if(callback!=NULL)
+	uint64_t state_word = _RADIO_ATOMIC_GET(handle->state_word);
+	int ret = handle->backend->realize(handle->mm_handle);
+	if(ret != MM_ERROR_NONE)
 	{
-		__set_callback(_RADIO_EVENT_TYPE_SCAN_INFO,radio,callback,user_data);
+		ret = __convert_error_code(ret,(char*)__FUNCTION__);
+		pthread_mutex_lock(&handle->realize_lock);
+		handle->realize_error = ret;
+		_RADIO_ATOMIC_SET(handle->realize_status, failed_status);
+		pthread_cond_broadcast(&handle->realize_cond);
+		pthread_mutex_unlock(&handle->realize_lock);
+		return ret;
 	}
-	else
+	__radio_set_state_if_unchanged(handle, state_word, RADIO_STATE_READY);
+
+	pthread_mutex_lock(&handle->realize_lock);
+	bool frequency_known = FALSE;
+	if(handle->pending_frequency)
 	{
-		__unset_callback(_RADIO_EVENT_TYPE_SCAN_INFO,radio);
+		ret = handle->backend->set_frequency(handle->mm_handle, _RADIO_ATOMIC_GET(handle->frequency));
+		if(ret != MM_ERROR_NONE)
+		{
+			LOGW("[%s] Failed to apply the cached frequency (0x%x)" ,__FUNCTION__, ret);
+		}
+		frequency_known = (ret == MM_ERROR_NONE);
 	}
-	
-	int ret = mm_radio_scan_start(handle->mm_handle);
-	if(ret != MM_ERROR_NONE)
+	if(handle->pending_mute)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		ret = handle->backend->set_mute(handle->mm_handle, _RADIO_ATOMIC_GET(handle->mute));
+		if(ret != MM_ERROR_NONE)
+		{
+			LOGW("[%s] Failed to apply the cached mute status (0x%x)" ,__FUNCTION__, ret);
+		}
 	}
-	else
+	int freq;
+	if(!frequency_known && handle->backend->get_frequency(handle->mm_handle, &freq) == MM_ERROR_NONE)
+		__radio_set_cached_frequency(handle, freq);
+	handle->pending_frequency = FALSE;
+	handle->pending_mute = FALSE;
+	__radio_touch(handle);
+	_RADIO_ATOMIC_SET(handle->realize_status, _RADIO_REALIZE_DONE);
+	pthread_cond_broadcast(&handle->realize_cond);
+	pthread_mutex_unlock(&handle->realize_lock);
+
+	/* the command worker times the idle period of a realized device only */
+	if(_RADIO_ATOMIC_GET(handle->idle_timeout_ms) > 0)
 	{
-		handle->state = RADIO_STATE_SCANNING;
-		return RADIO_ERROR_NONE;
+		pthread_mutex_lock(&handle->commands.lock);
+		pthread_cond_signal(&handle->commands.cond);
+		pthread_mutex_unlock(&handle->commands.lock);
 	}
+	return RADIO_ERROR_NONE;
 }
 
-int radio_scan_stop(radio_h radio, radio_scan_stopped_cb callback, void *user_data)
+/* Realizes again a device suspended by the idle policy, the cached frequency and mute status are applied in the same step */
+static int __radio_resume(radio_s *handle)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
-	RADIO_STATE_CHECK(handle,RADIO_STATE_SCANNING);  
+	uint64_t start = _radio_stats_now();
+	int ret = __radio_realize(handle, _RADIO_REALIZE_SUSPENDED);
+	uint64_t elapsed = _radio_stats_now() - start;
 
-	if(callback!=NULL)
+	_radio_stats_record(_RADIO_STATS_DEVICE_RESUME, start, ret);
+	_radio_trace_write(&handle->trace, start + elapsed, _RADIO_TRACE_RESUME, ret, (int32_t)(elapsed / 1000));
+	if(elapsed > RADIO_RESUME_TARGET_MS * 1000000ULL)
 	{
-		__set_callback(_RADIO_EVENT_TYPE_SCAN_STOP,radio,callback,user_data);
+		LOGW("[%s] Resumed in %llu ms, above the %d ms target" ,__FUNCTION__, (unsigned long long)(elapsed / 1000000), RADIO_RESUME_TARGET_MS);
 	}
-	else
+	return ret;
+}
+
+static void *__radio_realize_thread(void *data)
+{
+	radio_s * handle = (radio_s *)data;
+	/* the error goes to the ready callback, the device is then realized again like a lazy one */
+	int ret = __radio_realize(handle, _RADIO_REALIZE_NONE);
+	LOGI("[%s] Realized (0x%08x)" ,__FUNCTION__, ret);
+	if(handle->ready_cb && !__radio_dispatch(handle, _RADIO_DISPATCH_READY, handle->ready_cb, handle->ready_user_data, ret, 0, 0, FALSE))
 	{
-		__unset_callback(_RADIO_EVENT_TYPE_SCAN_STOP,radio);
+		handle->ready_cb(ret, handle->ready_user_data);
 	}
-	
-	int ret = mm_radio_scan_stop(handle->mm_handle);
-	if(ret != MM_ERROR_NONE)
+	return NULL;
+}
+
+/*
+* Realizes a lazily created device or a suspended one, or waits for the realize thread of an asynchronously created one.
+*/
+static int __radio_ensure_realized(radio_s *handle)
+{
+	__radio_touch(handle);
+	pthread_mutex_lock(&handle->realize_lock);
+	_radio_realize_e status;
+	while((status = _RADIO_ATOMIC_GET(handle->realize_status)) == _RADIO_REALIZE_PENDING)
+		pthread_cond_wait(&handle->realize_cond, &handle->realize_lock);
+	if(status == _RADIO_REALIZE_NONE || status == _RADIO_REALIZE_SUSPENDED)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		_RADIO_ATOMIC_SET(handle->realize_status, _RADIO_REALIZE_PENDING);
+		pthread_mutex_unlock(&handle->realize_lock);
+		return (status == _RADIO_REALIZE_SUSPENDED) ? __radio_resume(handle) : __radio_realize(handle, _RADIO_REALIZE_NONE);
 	}
-	else
-	{
-		handle->state = RADIO_STATE_READY;
+	int ret = (status == _RADIO_REALIZE_DONE) ? RADIO_ERROR_NONE : handle->realize_error;
+	pthread_mutex_unlock(&handle->realize_lock);
+	return ret;
+}
+
+/*
+* Called with realize_lock held. Returns true when the device is not realized yet :
+* the caller then only updates the cached value and marks it as pending.
+* A device which failed to realize is not deferred, the caller reports its error with __radio_realize_failed().
+*/
+static bool __radio_is_deferred(radio_s *handle)
+{
+	_radio_realize_e status = _RADIO_ATOMIC_GET(handle->realize_status);
+	return status == _RADIO_REALIZE_NONE || status == _RADIO_REALIZE_PENDING || status == _RADIO_REALIZE_SUSPENDED;
+}
+
+/* Called with realize_lock held. Returns the error of a failed realize, RADIO_ERROR_NONE otherwise. */
+static int __radio_realize_failed(radio_s *handle)
+{
+	if(_RADIO_ATOMIC_GET(handle->realize_status) != _RADIO_REALIZE_FAILED)
 		return RADIO_ERROR_NONE;
-	}
+	LOGE("[%s] The device failed to realize (0x%08x)" ,__FUNCTION__, handle->realize_error);
+	return handle->realize_error;
 }
 
+/*
+* Software scan.
+* The tuner is moved channel by channel and a station is reported when its signal strength reaches
+* radio_s::scan_threshold. It runs on its own thread and reports through the same callbacks as the hardware scan.
+*/
+static void *__radio_sweep_thread(void *data)
+{
+	radio_s * handle = (radio_s *)data;
+	_radio_sweep_s *sweep = &handle->sweep;
+	bool completed = TRUE;
+	int frequency, rssi, next;
 
-int radio_set_mute(radio_h radio, bool muted)
+	/* what an interrupted scan left behind is delivered first */
+	__radio_batch_flush(handle);
+	while(1)
+	{
+		if(_RADIO_ATOMIC_GET(sweep->cancel))
+		{
+			completed = FALSE;
+			break;
+		}
+		next = _RADIO_ATOMIC_GET(sweep->next);
+		if(sweep->mode == _RADIO_SWEEP_RANGE)
+		{
+			if(next > sweep->end)
+				break;
+			frequency = next;
+			_RADIO_ATOMIC_SET(sweep->next, next + sweep->step);
+		}
+		else
+		{
+			if(next >= sweep->count)
+				break;
+			frequency = sweep->channels[next];
+			_RADIO_ATOMIC_SET(sweep->next, next + 1);
+		}
+		if(handle->backend->set_frequency(handle->mm_handle, frequency) != MM_ERROR_NONE
+			|| handle->backend->get_signal_strength(handle->mm_handle, &rssi) != MM_ERROR_NONE)
+		{
+			continue;
+		}
+		if(rssi >= _RADIO_ATOMIC_GET(handle->scan_threshold))
+			__radio_on_scan_info(handle, frequency, rssi);
+		else
+		{
+			_radio_spectrum_set(&handle->spectrum, frequency, rssi);
+			__radio_batch_poll(handle);
+		}
+	}
+
+	if(sweep->tuned != 0 && handle->backend->set_frequency(handle->mm_handle, sweep->tuned) == MM_ERROR_NONE)
+		__radio_set_cached_frequency(handle, sweep->tuned);
+	_RADIO_ATOMIC_SET(sweep->resumable, !completed);
+	if(completed)
+		_radio_station_cache_prune(&handle->stations, sweep->start, sweep->end, _RADIO_ATOMIC_GET(sweep->start_time));
+	_RADIO_ATOMIC_SET(sweep->running, FALSE);
+	__radio_set_state_from_backend(handle, RADIO_STATE_READY);
+
+	/* nothing may touch the sweep after this point, the callback can start the next one */
+	if(completed)
+		__radio_on_scan_finish(handle);
+	else
+		__radio_on_scan_stop(handle);
+	return NULL;
+}
+
+static void __radio_sweep_join(radio_s *handle)
 {
-	RADIO_INSTANCE_CHECK(radio);
-	radio_s * handle = (radio_s *) radio;
+	if(!handle->sweep.thread_started)
+		return;
+	if(pthread_equal(pthread_self(), handle->sweep.thread))
+		pthread_detach(handle->sweep.thread);
+	else
+		pthread_join(handle->sweep.thread, NULL);
+	handle->sweep.thread_started = FALSE;
+}
 
-	int ret = mm_radio_set_mute(handle->mm_handle, muted);
-	if(ret != MM_ERROR_NONE)
+/* Starts the sweep prepared in handle->sweep */
+static int __radio_sweep_start(radio_s *handle, bool resume, radio_scan_updated_cb callback, void *user_data)
+{
+	if(callback!=NULL)
 	{
-		return __convert_error_code(ret,(char*)__FUNCTION__);
+		__set_callback(_RADIO_EVENT_TYPE_SCAN_INFO,handle->self,callback,user_data);
 	}
 	else
 	{
-		handle->mute = muted;
-		return RADIO_ERROR_NONE;
+		__unset_callback(_RADIO_EVENT_TYPE_SCAN_INFO,handle->self);
 	}
-}
 
-int radio_is_muted(radio_h radio, bool *muted)
-{
-	RADIO_INSTANCE_CHECK(radio);
-	RADIO_NULL_ARG_CHECK(muted);
-	radio_s * handle = (radio_s *) radio;
-	*muted = handle->mute;
+	if(!resume)
+		_RADIO_ATOMIC_SET(handle->sweep.start_time, (int64_t)time(NULL));
+	handle->sweep.tuned = _RADIO_ATOMIC_GET(handle->frequency);
+	handle->sweep.cancel = FALSE;
+	_RADIO_ATOMIC_SET(handle->sweep.resumable, FALSE);
+	_RADIO_ATOMIC_SET(handle->sweep.running, TRUE);
+	__radio_set_state_from_backend(handle, RADIO_STATE_SCANNING);
+
+	if(pthread_create(&handle->sweep.thread, NULL, __radio_sweep_thread, handle) != 0)
+	{
+		_RADIO_ATOMIC_SET(handle->sweep.running, FALSE);
+		__radio_set_state_from_backend(handle, RADIO_STATE_READY);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create scan thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	handle->sweep.thread_started = TRUE;
 	return RADIO_ERROR_NONE;
 }
 
-int radio_set_scan_completed_cb(radio_h radio, radio_scan_completed_cb callback, void *user_data)
+/* Stops a running sweep. The stop is reported through radio_scan_stopped_cb() by the sweep thread. */
+static void __radio_sweep_stop(radio_s *handle)
 {
-	return __set_callback(_RADIO_EVENT_TYPE_SCAN_FINISH,radio,callback,user_data);
+	_RADIO_ATOMIC_SET(handle->sweep.cancel, TRUE);
+	__radio_sweep_join(handle);
 }
 
-int radio_unset_scan_completed_cb(radio_h radio)
+/*
+* Signal strength sampler.
+* A single thread per handle reads the signal strength every radio_s::sampler.interval_ms while the radio is playing
+* and reports threshold crossings and changes larger than the delta. Each sample also refreshes the spectrum map.
+*/
+static void *__radio_sampler_thread(void *data)
 {
-	return __unset_callback(_RADIO_EVENT_TYPE_SCAN_FINISH,radio);
+	radio_s * handle = (radio_s *)data;
+	_radio_sampler_s *sampler = &handle->sampler;
+	uint32_t generation;
+	bool reference = FALSE;
+	bool below = FALSE;
+	int reported = 0;
+
+	pthread_mutex_lock(&sampler->lock);
+	generation = sampler->generation;
+	while(sampler->generation == generation)
+	{
+		radio_signal_strength_changed_cb callback;
+		radio_signal_strength_event_e event;
+		void *user_data;
+		struct timespec deadline;
+		int threshold, hysteresis, delta, rssi, frequency;
+		bool fire = FALSE;
+
+		if(sampler->restart || __radio_get_cached_state(handle) != RADIO_STATE_PLAYING)
+		{
+			reference = FALSE;
+			sampler->restart = FALSE;
+		}
+		if(__radio_get_cached_state(handle) != RADIO_STATE_PLAYING)
+		{
+			pthread_cond_wait(&sampler->cond, &sampler->lock);
+			continue;
+		}
+		/* the first sample is taken as soon as the radio plays */
+		if(reference)
+		{
+			__radio_deadline(&deadline, sampler->interval_ms);
+			if(pthread_cond_timedwait(&sampler->cond, &sampler->lock, &deadline) != ETIMEDOUT)
+				continue;
+			if(sampler->generation != generation || sampler->restart || __radio_get_cached_state(handle) != RADIO_STATE_PLAYING)
+				continue;
+		}
+		callback = sampler->callback;
+		user_data = sampler->user_data;
+		threshold = sampler->threshold;
+		hysteresis = sampler->hysteresis;
+		delta = sampler->delta;
+		pthread_mutex_unlock(&sampler->lock);
+
+		if(handle->backend->get_signal_strength(handle->mm_handle, &rssi) == MM_ERROR_NONE)
+		{
+			frequency = _RADIO_ATOMIC_GET(handle->frequency);
+			_radio_spectrum_set(&handle->spectrum, frequency, rssi);
+			_radio_station_cache_refresh(&handle->stations, frequency, rssi, time(NULL));
+
+			if(!reference)
+			{
+				reference = TRUE;
+				below = (rssi < threshold);
+				event = below ? RADIO_SIGNAL_STRENGTH_BELOW_THRESHOLD : RADIO_SIGNAL_STRENGTH_ABOVE_THRESHOLD;
+				fire = TRUE;
+			}
+			else if(!below && rssi < threshold)
+			{
+				below = TRUE;
+				event = RADIO_SIGNAL_STRENGTH_BELOW_THRESHOLD;
+				fire = TRUE;
+			}
+			else if(below && rssi >= threshold + hysteresis)
+			{
+				below = FALSE;
+				event = RADIO_SIGNAL_STRENGTH_ABOVE_THRESHOLD;
+				fire = TRUE;
+			}
+			else if(delta > 0 && abs(rssi - reported) >= delta)
+			{
+				event = RADIO_SIGNAL_STRENGTH_CHANGED;
+				fire = TRUE;
+			}
+			/* only the latest of several pending changes matters */
+			if(fire)
+			{
+				reported = rssi;
+				if(!__radio_dispatch(handle, _RADIO_DISPATCH_SIGNAL_STRENGTH, callback, user_data, rssi, event, 0, event == RADIO_SIGNAL_STRENGTH_CHANGED))
+					callback(rssi, event, user_data);
+			}
+		}
+		pthread_mutex_lock(&sampler->lock);
+	}
+	pthread_mutex_unlock(&sampler->lock);
+	return NULL;
 }
 
-int radio_set_interrupted_cb(radio_h radio, radio_interrupted_cb callback, void *user_data)
+/* Makes the sampler thread exit. Called from the sampler's own callback, the thread is left to exit by itself. */
+static void __radio_sampler_stop(radio_s *handle)
 {
-	return __set_callback(_RADIO_EVENT_TYPE_INTERRUPT,radio,callback,user_data);
-}
+	_radio_sampler_s *sampler = &handle->sampler;
+	radio_signal_strength_changed_cb callback;
+	void *user_data;
+	bool started;
+	pthread_t thread;
+
+	pthread_mutex_lock(&sampler->lock);
+	started = sampler->thread_started;
+	thread = sampler->thread;
+	callback = sampler->callback;
+	user_data = sampler->user_data;
+	sampler->generation++;
+	sampler->callback = NULL;
+	_RADIO_ATOMIC_SET(sampler->thread_started, FALSE);
+	pthread_cond_signal(&sampler->cond);
+	pthread_mutex_unlock(&sampler->lock);
+
+	if(started)
+	{
+		if(pthread_equal(pthread_self(), thread))
+			pthread_detach(thread);
+		else
+			pthread_join(thread, NULL);
+	}
+	if(callback != NULL)
+		__radio_dispatch_purge(handle, _RADIO_DISPATCH_SIGNAL_STRENGTH, callback, user_data);
+}
+
+/*
+* Alternate frequency monitor.
+* Each window measures the current frequency, moves the tuner to one alternate, measures it and moves the tuner back,
+* the alternates taking turns. The next window waits long enough for the windows to stay within af.tuner_share of
+* the time. The tuner goes back to the cached frequency rather than to the measured one : a frequency set by the
+* application during the window wins.
+*/
+static bool __radio_af_window(radio_s *handle, int alternate, int *current_rssi, int *rssi)
+{
+	uint64_t start = _radio_stats_now();
+	int current = _RADIO_ATOMIC_GET(handle->frequency);
+	bool measured = FALSE;
+
+	if(current == 0 || handle->backend->get_signal_strength(handle->mm_handle, current_rssi) != MM_ERROR_NONE)
+		return FALSE;
+	_radio_spectrum_set(&handle->spectrum, current, *current_rssi);
+	if(handle->backend->set_frequency(handle->mm_handle, alternate) == MM_ERROR_NONE)
+	{
+		measured = (handle->backend->get_signal_strength(handle->mm_handle, rssi) == MM_ERROR_NONE);
+		if(handle->backend->set_frequency(handle->mm_handle, _RADIO_ATOMIC_GET(handle->frequency)) != MM_ERROR_NONE)
+		{
+			LOGW("[%s] Failed to tune back from %d kHz" ,__FUNCTION__, alternate);
+		}
+	}
+	_radio_stats_record(_RADIO_STATS_DEVICE_AF_WINDOW, start, measured ? RADIO_ERROR_NONE : RADIO_ERROR_INVALID_OPERATION);
+	_radio_trace_write(&handle->trace, _radio_stats_now(), _RADIO_TRACE_AF_WINDOW, alternate, measured ? *rssi : INT32_MIN);
+	if(measured)
+		_radio_spectrum_set(&handle->spectrum, alternate, *rssi);
+	return measured;
+}
+
+static void *__radio_af_thread(void *data)
+{
+	radio_s * handle = (radio_s *)data;
+	_radio_af_monitor_s *af = &handle->af;
+	int wait_ms = RADIO_AF_INTERVAL_MIN_MS;
+	uint32_t generation;
+
+	pthread_mutex_lock(&af->lock);
+	generation = af->generation;
+	while(af->generation == generation)
+	{
+		radio_alternate_frequency_cb callback;
+		struct timespec deadline;
+		void *user_data;
+		uint64_t start, window;
+		int64_t quiet_ms;
+		int index, alternate, current, current_rssi, rssi;
+		bool found = FALSE, switched = FALSE;
+
+		if(__radio_get_cached_state(handle) != RADIO_STATE_PLAYING || af->count == 0)
+		{
+			pthread_cond_wait(&af->cond, &af->lock);
+			continue;
+		}
+		__radio_deadline(&deadline, wait_ms);
+		if(pthread_cond_timedwait(&af->cond, &af->lock, &deadline) != ETIMEDOUT)
+			continue;
+		if(af->generation != generation || __radio_get_cached_state(handle) != RADIO_STATE_PLAYING || af->count == 0)
+			continue;
+		/* the application or the tuner has just changed something, let it settle */
+		quiet_ms = RADIO_AF_QUIET_MS - (int64_t)((_radio_stats_now() - _RADIO_ATOMIC_GET(handle->last_activity)) / 1000000);
+		if(quiet_ms > 0)
+		{
+			wait_ms = (int)quiet_ms;
+			continue;
+		}
+
+		index = af->next % af->count;
+		af->next = index + 1;
+		alternate = af->frequencies[index];
+		current = _RADIO_ATOMIC_GET(handle->frequency);
+		if(alternate == current)
+		{
+			wait_ms = 0;
+			continue;
+		}
+		pthread_mutex_unlock(&af->lock);
+
+		start = _radio_stats_now();
+		bool measured = __radio_af_window(handle, alternate, &current_rssi, &rssi);
+		window = _radio_stats_now() - start;
+
+		pthread_mutex_lock(&af->lock);
+		/* the list may have been replaced during the window */
+		if(measured && index < af->count && af->frequencies[index] == alternate)
+		{
+			af->hits[index] = (rssi >= current_rssi + af->margin) ? af->hits[index] + 1 : 0;
+			if(af->hits[index] >= RADIO_AF_CONFIRMATIONS)
+			{
+				af->hits[index] = 0;
+				found = TRUE;
+				if(af->auto_switch && __radio_get_cached_state(handle) == RADIO_STATE_PLAYING
+					&& _RADIO_ATOMIC_GET(handle->frequency) == current
+					&& handle->backend->set_frequency(handle->mm_handle, alternate) == MM_ERROR_NONE)
+				{
+					__radio_set_cached_frequency(handle, alternate);
+					__radio_touch(handle);
+					af->frequencies[index] = current;
+					switched = TRUE;
+				}
+			}
+		}
+		callback = af->callback;
+		user_data = af->user_data;
+		/* window * (100 - share) / share of tuner time on the current frequency after each window */
+		wait_ms = (int)(window * (100 - af->tuner_share) / af->tuner_share / 1000000);
+		if(wait_ms < RADIO_AF_INTERVAL_MIN_MS)
+			wait_ms = RADIO_AF_INTERVAL_MIN_MS;
+
+		if(found && callback)
+		{
+			LOGI("[%s] %d kHz (%d) beats %d kHz (%d)%s" ,__FUNCTION__, alternate, rssi, current, current_rssi, switched ? ", switched" : "");
+			pthread_mutex_unlock(&af->lock);
+			if(!__radio_dispatch(handle, _RADIO_DISPATCH_ALTERNATE_FREQUENCY, callback, user_data, alternate, rssi, switched, FALSE))
+				callback(alternate, rssi, switched, user_data);
+			pthread_mutex_lock(&af->lock);
+		}
+	}
+	pthread_mutex_unlock(&af->lock);
+	return NULL;
+}
+
+/* Makes the monitor thread exit. Called from the monitor's own callback, the thread is left to exit by itself. */
+static void __radio_af_stop(radio_s *handle)
+{
+	_radio_af_monitor_s *af = &handle->af;
+	radio_alternate_frequency_cb callback;
+	void *user_data;
+	bool started;
+	pthread_t thread;
+
+	pthread_mutex_lock(&af->lock);
+	started = af->thread_started;
+	thread = af->thread;
+	callback = af->callback;
+	user_data = af->user_data;
+	af->generation++;
+	af->callback = NULL;
+	_RADIO_ATOMIC_SET(af->thread_started, FALSE);
+	pthread_cond_signal(&af->cond);
+	pthread_mutex_unlock(&af->lock);
+
+	if(started)
+	{
+		if(pthread_equal(pthread_self(), thread))
+			pthread_detach(thread);
+		else
+			pthread_join(thread, NULL);
+	}
+	if(callback != NULL)
+		__radio_dispatch_purge(handle, _RADIO_DISPATCH_ALTERNATE_FREQUENCY, callback, user_data);
+}
+
+/*
+* RDS decoder.
+* The blocks read across a retune may come from either station : they are dropped. The decoder is moved to the new
+* frequency with the next read, which reports at once the metadata cached for it.
+*/
+static void *__radio_rds_thread(void *data)
+{
+	radio_s * handle = (radio_s *)data;
+	_radio_rds_monitor_s *rds = &handle->rds;
+	uint32_t blocks[RADIO_RDS_READ_BLOCKS];
+	radio_rds_changed_cb callback;
+	struct timespec deadline;
+	unsigned int fields;
+	void *user_data;
+	uint32_t generation;
+	int frequency, count = 0, ret;
+
+	pthread_mutex_lock(&rds->lock);
+	generation = rds->generation;
+	while(rds->generation == generation)
+	{
+		if(__radio_get_cached_state(handle) != RADIO_STATE_PLAYING)
+		{
+			pthread_cond_wait(&rds->cond, &rds->lock);
+			continue;
+		}
+		pthread_mutex_unlock(&rds->lock);
+
+		fields = 0;
+		frequency = _RADIO_ATOMIC_GET(handle->frequency);
+		ret = handle->backend->read_rds(handle->mm_handle, blocks, RADIO_RDS_READ_BLOCKS, &count);
+		if(ret == MM_ERROR_NONE && frequency != 0 && frequency == _RADIO_ATOMIC_GET(handle->frequency))
+		{
+			if(frequency != rds->decoder.frequency)
+				fields = _radio_rds_decoder_tune(&rds->decoder, &rds->cache, frequency);
+			fields |= _radio_rds_decode(&rds->decoder, &rds->cache, blocks, count);
+		}
+
+		pthread_mutex_lock(&rds->lock);
+		if(ret != MM_ERROR_NONE && rds->generation == generation)
+		{
+			if(ret != MM_ERROR_RADIO_NO_OP)
+			{
+				LOGW("[%s] Failed to read the RDS blocks (0x%x)" ,__FUNCTION__, ret);
+			}
+			__radio_deadline(&deadline, RADIO_RDS_RETRY_MS);
+			pthread_cond_timedwait(&rds->cond, &rds->lock, &deadline);
+		}
+		callback = rds->callback;
+		user_data = rds->user_data;
+		if(fields != 0 && callback != NULL && rds->generation == generation)
+		{
+			_radio_trace_write(&handle->trace, _radio_stats_now(), _RADIO_TRACE_RDS, frequency, fields);
+			pthread_mutex_unlock(&rds->lock);
+			if(!__radio_dispatch(handle, _RADIO_DISPATCH_RDS, callback, user_data, frequency, fields, 0, FALSE))
+				callback(frequency, fields, user_data);
+			pthread_mutex_lock(&rds->lock);
+		}
+	}
+	pthread_mutex_unlock(&rds->lock);
+	return NULL;
+}
+
+/* Makes the decoder thread exit. Called from the decoder's own callback, the thread is left to exit by itself. */
+static void __radio_rds_stop(radio_s *handle)
+{
+	_radio_rds_monitor_s *rds = &handle->rds;
+	radio_rds_changed_cb callback;
+	void *user_data;
+	bool started;
+	pthread_t thread;
+
+	pthread_mutex_lock(&rds->lock);
+	started = rds->thread_started;
+	thread = rds->thread;
+	callback = rds->callback;
+	user_data = rds->user_data;
+	rds->generation++;
+	rds->callback = NULL;
+	_RADIO_ATOMIC_SET(rds->thread_started, FALSE);
+	pthread_cond_signal(&rds->cond);
+	pthread_mutex_unlock(&rds->lock);
+
+	if(started)
+	{
+		if(pthread_equal(pthread_self(), thread))
+			pthread_detach(thread);
+		else
+			pthread_join(thread, NULL);
+	}
+	if(callback != NULL)
+		__radio_dispatch_purge(handle, _RADIO_DISPATCH_RDS, callback, user_data);
+}
+
+/* Level meter : a window which is still queued is replaced by the next one, the meter never waits for the application */
+static void __radio_level_notify(void *data, radio_level_cb callback, void *user_data, const radio_level_s *level)
+{
+	radio_s *handle = (radio_s *)data;
+
+	if(!__radio_dispatch(handle, _RADIO_DISPATCH_LEVEL, callback, user_data, level->peak, level->rms, level->silence_ms, TRUE))
+		callback(level->peak, level->rms, level->silence_ms, user_data);
+}
+
+/*
+* Audio tap.
+* The frames go from the tuner to the shared ring without any copy in between, and the thread never waits for the
+* readers. A failed read is retried a bit later : the state may not be mirrored yet when the tuner stops.
+*/
+static void *__radio_pcm_tap_thread(void *data)
+{
+	radio_s * handle = (radio_s *)data;
+	_radio_pcm_tap_s *tap = &handle->tap;
+	int period_frames = tap->ring.header->period_frames;
+	struct timespec deadline;
+	int16_t *frames;
+	int ret;
+
+	pthread_mutex_lock(&tap->lock);
+	while(!tap->quit)
+	{
+		if(__radio_get_cached_state(handle) != RADIO_STATE_PLAYING)
+		{
+			pthread_cond_wait(&tap->cond, &tap->lock);
+			continue;
+		}
+		pthread_mutex_unlock(&tap->lock);
+
+		frames = _radio_pcm_ring_begin(&tap->ring);
+		ret = handle->backend->read_pcm(handle->mm_handle, frames, period_frames);
+		if(ret == MM_ERROR_NONE)
+			_radio_pcm_ring_commit(&tap->ring, _radio_stats_now());
+
+		pthread_mutex_lock(&tap->lock);
+		if(ret != MM_ERROR_NONE && !tap->quit)
+		{
+			if(ret != MM_ERROR_RADIO_NO_OP)
+			{
+				LOGW("[%s] Failed to read the tuner audio (0x%x)" ,__FUNCTION__, ret);
+			}
+			__radio_deadline(&deadline, RADIO_PCM_RETRY_MS);
+			pthread_cond_timedwait(&tap->cond, &tap->lock, &deadline);
+		}
+	}
+	pthread_mutex_unlock(&tap->lock);
+	return NULL;
+}
+
+/* Called with tap.lock held, the thread is joined without it */
+static void __radio_pcm_tap_join(radio_s *handle)
+{
+	_radio_pcm_tap_s *tap = &handle->tap;
+
+	tap->quit = TRUE;
+	pthread_cond_signal(&tap->cond);
+	pthread_mutex_unlock(&tap->lock);
+	pthread_join(tap->thread, NULL);
+	pthread_mutex_lock(&tap->lock);
+	_RADIO_ATOMIC_SET(tap->thread_started, FALSE);
+	_radio_pcm_ring_close(&tap->ring);
+}
+
+static int __radio_command_start(radio_s *handle);
+
+/*
+* Predictive seek.
+* The tuner's seek sweeps the band until it locks on a carrier. When the spectrum map already knows a strong
+* enough channel in the seek direction, the tuner is moved there directly and a single signal strength read
+* confirms the station. On a miss, the original frequency is restored and the caller falls back to the tuner's seek.
+* A hit is reported like the tuner's seek, after radio_seek_up() or radio_seek_down() has returned : the command worker
+* delivers MM_MESSAGE_RADIO_SEEK_FINISH. Without a worker, the hit is given up like a miss.
+*/
+static bool __radio_seek_predicted(radio_s *handle, int direction)
+{
+	_radio_command_queue_s *queue = &handle->commands;
+	int current = _RADIO_ATOMIC_GET(handle->frequency);
+	int threshold = _RADIO_ATOMIC_GET(handle->scan_threshold);
+	int candidate, rssi;
+
+	if(!_RADIO_ATOMIC_GET(handle->predictive_seek))
+		return FALSE;
+	if(current == 0 && handle->backend->get_frequency(handle->mm_handle, &current) != MM_ERROR_NONE)
+		return FALSE;
+
+	candidate = _radio_spectrum_next(&handle->spectrum, current, direction, threshold);
+	if(candidate == 0 || candidate == current)
+		return FALSE;
+	if(handle->backend->set_frequency(handle->mm_handle, candidate) != MM_ERROR_NONE)
+		return FALSE;
+	if(handle->backend->get_signal_strength(handle->mm_handle, &rssi) != MM_ERROR_NONE || rssi < threshold)
+	{
+		LOGI("[%s] %d kHz is gone, falling back to the tuner's seek" ,__FUNCTION__, candidate);
+		_radio_spectrum_set(&handle->spectrum, candidate, 0);
+		handle->backend->set_frequency(handle->mm_handle, current);
+		return FALSE;
+	}
+
+	_radio_spectrum_set(&handle->spectrum, candidate, rssi);
+	_radio_station_cache_refresh(&handle->stations, candidate, rssi, time(NULL));
+
+	pthread_mutex_lock(&queue->lock);
+	if(__radio_command_start(handle) == RADIO_ERROR_NONE)
+	{
+		queue->predicted_frequency = candidate;
+		pthread_cond_signal(&queue->cond);
+		pthread_mutex_unlock(&queue->lock);
+		return TRUE;
+	}
+	pthread_mutex_unlock(&queue->lock);
+	/* the result must not reach the callback before the seek has returned, the tuner's seek reports it instead */
+	LOGW("[%s] No command worker to report %d kHz, falling back to the tuner's seek" ,__FUNCTION__, candidate);
+	handle->backend->set_frequency(handle->mm_handle, current);
+	return FALSE;
+}
+
+/* Called by the command worker with the queue lock held, reports the station found by a predictive seek */
+static void __radio_seek_predicted_finish(radio_s *handle)
+{
+	_radio_command_queue_s *queue = &handle->commands;
+	MMMessageParamType msg;
+
+	if(queue->predicted_frequency == 0)
+		return;
+	memset(&msg, 0, sizeof(msg));
+	msg.radio_scan.frequency = queue->predicted_frequency;
+	queue->predicted_frequency = 0;
+	pthread_mutex_unlock(&queue->lock);
+	__msg_callback(MM_MESSAGE_RADIO_SEEK_FINISH, &msg, handle);
+	pthread_mutex_lock(&queue->lock);
+}
+
+/*
+* Command queue.
+* The asynchronous functions queue their command and return. A worker thread runs the commands one by one through
+* the public functions, so a slow tuner only ever blocks the worker. A frequency change queued while the previous
+* frequency change still waits replaces it : a burst of changes while the user turns a dial costs a single retune.
+*/
+/* Reports the oldest replaced frequency change, called by the worker with the queue lock held */
+static void __radio_command_report_cancelled(radio_s *handle)
+{
+	_radio_command_queue_s *queue = &handle->commands;
+	_radio_command_s command = queue->cancelled[queue->cancelled_head];
+	int frequency = _RADIO_ATOMIC_GET(handle->frequency);
+
+	queue->cancelled_head = (queue->cancelled_head + 1) % _RADIO_COMMAND_QUEUE_MAX;
+	queue->cancelled_count--;
+	pthread_mutex_unlock(&queue->lock);
+	if(!__radio_dispatch(handle, _RADIO_DISPATCH_COMMAND, command.callback, command.user_data, command.command, RADIO_ERROR_CANCELLED, frequency, FALSE))
+		command.callback(command.command, RADIO_ERROR_CANCELLED, frequency, command.user_data);
+	pthread_mutex_lock(&queue->lock);
+}
+
+static void __radio_command_seek_cb(int frequency, void *user_data)
+{
+	_radio_command_queue_s *queue = &((radio_s *)user_data)->commands;
+
+	pthread_mutex_lock(&queue->lock);
+	queue->seek_frequency = frequency;
+	_RADIO_ATOMIC_SET(queue->seeking, FALSE);
+	pthread_cond_signal(&queue->cond);
+	pthread_mutex_unlock(&queue->lock);
+}
+
+/*
+* Idle policy.
+* The command worker, started by radio_set_idle_timeout(), also times the idle period of a realized device.
+* A device left in RADIO_STATE_READY for radio_s::idle_timeout_ms is unrealized, while the mm handle is kept :
+* __radio_ensure_realized() realizes it again and __radio_realize() restores the cached frequency and mute status.
+*/
+static bool __radio_suspend(radio_s *handle, int timeout_ms)
+{
+	bool suspended = FALSE;
+	int ret = MM_ERROR_NONE;
+
+	pthread_mutex_lock(&handle->realize_lock);
+	if(_RADIO_ATOMIC_GET(handle->realize_status) == _RADIO_REALIZE_DONE && __radio_get_cached_state(handle) == RADIO_STATE_READY
+		&& !_RADIO_ATOMIC_GET(handle->sweep.running)
+		&& _radio_stats_now() - _RADIO_ATOMIC_GET(handle->last_activity) >= timeout_ms * 1000000ULL)
+	{
+		ret = handle->backend->unrealize(handle->mm_handle);
+		if(ret == MM_ERROR_NONE)
+		{
+			handle->pending_frequency = (_RADIO_ATOMIC_GET(handle->frequency) != 0);
+			handle->pending_mute = TRUE;
+			_RADIO_ATOMIC_SET(handle->realize_status, _RADIO_REALIZE_SUSPENDED);
+			suspended = TRUE;
+		}
+	}
+	pthread_mutex_unlock(&handle->realize_lock);
+
+	if(suspended)
+	{
+		_radio_trace_write(&handle->trace, _radio_stats_now(), _RADIO_TRACE_SUSPEND, timeout_ms, 0);
+		LOGI("[%s] Device suspended after %d ms idle" ,__FUNCTION__, timeout_ms);
+	}
+	else
+	{
+		if(ret != MM_ERROR_NONE)
+			LOGW("[%s] Failed to unrealize (0x%x)" ,__FUNCTION__, ret);
+		/* busy or in use meanwhile : a new idle period starts */
+		__radio_touch(handle);
+	}
+	return suspended;
+}
+
+/* Called by the command worker with the queue lock held when no command is queued */
+static void __radio_idle_wait(radio_s *handle)
+{
+	_radio_command_queue_s *queue = &handle->commands;
+	int timeout_ms = _RADIO_ATOMIC_GET(handle->idle_timeout_ms);
+	struct timespec deadline;
+	int64_t idle_ms;
+
+	if(timeout_ms == 0 || _RADIO_ATOMIC_GET(handle->realize_status) != _RADIO_REALIZE_DONE)
+	{
+		pthread_cond_wait(&queue->cond, &queue->lock);
+		return;
+	}
+	idle_ms = (int64_t)((_radio_stats_now() - _RADIO_ATOMIC_GET(handle->last_activity)) / 1000000);
+	if(idle_ms < timeout_ms)
+	{
+		__radio_deadline(&deadline, timeout_ms - idle_ms);
+		pthread_cond_timedwait(&queue->cond, &queue->lock, &deadline);
+		return;
+	}
+	pthread_mutex_unlock(&queue->lock);
+	__radio_suspend(handle, timeout_ms);
+	pthread_mutex_lock(&queue->lock);
+}
+
+static int __radio_command_run(radio_s *handle, const _radio_command_s *command)
+{
+	switch(command->command)
+	{
+		case RADIO_COMMAND_SET_FREQUENCY:
+			return radio_set_frequency(handle->self, command->frequency);
+		case RADIO_COMMAND_START:
+			return radio_start(handle->self);
+		case RADIO_COMMAND_STOP:
+			return radio_stop(handle->self);
+		case RADIO_COMMAND_SEEK_UP:
+			return radio_seek_up(handle->self, __radio_command_seek_cb, handle);
+		case RADIO_COMMAND_SEEK_DOWN:
+			return radio_seek_down(handle->self, __radio_command_seek_cb, handle);
+		default:
+			return RADIO_ERROR_INVALID_PARAMETER;
+	}
+}
+
+static void *__radio_command_thread(void *data)
+{
+	radio_s * handle = (radio_s *)data;
+	_radio_command_queue_s *queue = &handle->commands;
+	_radio_command_s command;
+	struct timespec deadline;
+	int ret, frequency;
+
+	pthread_mutex_lock(&queue->lock);
+	while(!queue->quit)
+	{
+		if(queue->predicted_frequency != 0)
+		{
+			__radio_seek_predicted_finish(handle);
+			continue;
+		}
+		/* the replaced frequency changes are reported before the command which replaced them runs */
+		if(queue->cancelled_count > 0)
+		{
+			__radio_command_report_cancelled(handle);
+			continue;
+		}
+		if(queue->count == 0)
+		{
+			__radio_idle_wait(handle);
+			continue;
+		}
+		command = queue->commands[queue->head];
+		queue->head = (queue->head + 1) % _RADIO_COMMAND_QUEUE_MAX;
+		queue->count--;
+		_RADIO_ATOMIC_SET(queue->seeking, (command.command == RADIO_COMMAND_SEEK_UP || command.command == RADIO_COMMAND_SEEK_DOWN));
+		pthread_mutex_unlock(&queue->lock);
+
+		ret = __radio_command_run(handle, &command);
+		frequency = _RADIO_ATOMIC_GET(handle->frequency);
+
+		pthread_mutex_lock(&queue->lock);
+		/* the next command runs once the seek has found its station */
+		if(queue->seeking && ret == RADIO_ERROR_NONE)
+		{
+			__radio_deadline(&deadline, RADIO_COMMAND_SEEK_TIMEOUT_MS);
+			while(queue->seeking && !queue->quit)
+			{
+				/* a seek of the worker itself may have been predicted */
+				if(queue->predicted_frequency != 0)
+				{
+					__radio_seek_predicted_finish(handle);
+					continue;
+				}
+				if(queue->cancelled_count > 0)
+				{
+					__radio_command_report_cancelled(handle);
+					continue;
+				}
+				if(pthread_cond_timedwait(&queue->cond, &queue->lock, &deadline) == ETIMEDOUT)
+				{
+					LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : No seek result after %d ms" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, RADIO_COMMAND_SEEK_TIMEOUT_MS);
+					ret = RADIO_ERROR_INVALID_OPERATION;
+					break;
+				}
+			}
+			if(ret == RADIO_ERROR_NONE)
+				frequency = queue->seek_frequency;
+		}
+		_RADIO_ATOMIC_SET(queue->seeking, FALSE);
+		if(queue->quit)
+			break;
+		if(command.callback)
+		{
+			pthread_mutex_unlock(&queue->lock);
+			if(!__radio_dispatch(handle, _RADIO_DISPATCH_COMMAND, command.callback, command.user_data, command.command, ret, frequency, FALSE))
+				command.callback(command.command, ret, frequency, command.user_data);
+			pthread_mutex_lock(&queue->lock);
+		}
+	}
+	pthread_mutex_unlock(&queue->lock);
+	return NULL;
+}
+
+/* Starts the worker unless it runs already, called with the queue lock held */
+static int __radio_command_start(radio_s *handle)
+{
+	_radio_command_queue_s *queue = &handle->commands;
+
+	if(queue->thread_started)
+		return RADIO_ERROR_NONE;
+	if(pthread_create(&queue->thread, NULL, __radio_command_thread, handle) != 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create command thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	queue->thread_started = TRUE;
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_command_push(radio_s *handle, radio_command_e command, int frequency, radio_command_completed_cb callback, void *user_data)
+{
+	_radio_command_queue_s *queue = &handle->commands;
+	_radio_command_s *tail = NULL;
+
+	pthread_mutex_lock(&queue->lock);
+	if(__radio_command_start(handle) != RADIO_ERROR_NONE)
+	{
+		pthread_mutex_unlock(&queue->lock);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	if(queue->count > 0)
+		tail = &queue->commands[(queue->head + queue->count - 1) % _RADIO_COMMAND_QUEUE_MAX];
+
+	/* a replaced command with a callback waits in cancelled for its report, it is queued behind when cancelled is full */
+	if(command == RADIO_COMMAND_SET_FREQUENCY && tail != NULL && tail->command == RADIO_COMMAND_SET_FREQUENCY
+		&& (tail->callback == NULL || queue->cancelled_count < _RADIO_COMMAND_QUEUE_MAX))
+	{
+		RADIO_HOT_LOGI("[%s] %d kHz replaces %d kHz" ,__FUNCTION__, frequency, tail->frequency);
+		if(tail->callback != NULL)
+		{
+			queue->cancelled[(queue->cancelled_head + queue->cancelled_count) % _RADIO_COMMAND_QUEUE_MAX] = *tail;
+			queue->cancelled_count++;
+		}
+	}
+	else if(queue->count == _RADIO_COMMAND_QUEUE_MAX)
+	{
+		pthread_mutex_unlock(&queue->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : %d commands already queued" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, _RADIO_COMMAND_QUEUE_MAX);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	else
+	{
+		tail = &queue->commands[(queue->head + queue->count) % _RADIO_COMMAND_QUEUE_MAX];
+		queue->count++;
+	}
+	tail->command = command;
+	tail->frequency = frequency;
+	tail->callback = callback;
+	tail->user_data = user_data;
+	pthread_cond_signal(&queue->cond);
+	pthread_mutex_unlock(&queue->lock);
+	return RADIO_ERROR_NONE;
+}
+
+/* Drops the queued commands and joins the worker once the running command has returned. */
+static void __radio_command_stop(radio_s *handle)
+{
+	_radio_command_queue_s *queue = &handle->commands;
+	bool started;
+
+	pthread_mutex_lock(&queue->lock);
+	started = queue->thread_started;
+	queue->quit = TRUE;
+	queue->count = 0;
+	queue->cancelled_count = 0;
+	queue->thread_started = FALSE;
+	pthread_cond_signal(&queue->cond);
+	pthread_mutex_unlock(&queue->lock);
+
+	if(started)
+		pthread_join(queue->thread, NULL);
+}
+
+/*
+* Public Implementation
+*/
+static int __radio_set_event_context(radio_h radio, GMainContext *context)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	GSource *source = NULL;
+	GSource *previous;
+
+	if(context != NULL)
+		source = _radio_dispatch_create(context, __radio_dispatch_handler);
+	pthread_mutex_lock(&handle->dispatch_lock);
+	previous = handle->dispatch;
+	_RADIO_ATOMIC_SET(handle->dispatch, source);
+	pthread_mutex_unlock(&handle->dispatch_lock);
+	if(previous != NULL)
+		_radio_dispatch_destroy(previous);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_create(radio_h *radio)
+{
+	RADIO_NULL_ARG_CHECK(radio);
+	radio_s * handle;
+	int ret = __radio_alloc(&handle);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+	*radio = handle->self;
+	ret = __radio_realize(handle, _RADIO_REALIZE_FAILED);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		/* nothing is left for radio_destroy(), the slot is free for the next handle */
+		__radio_discard(handle);
+		*radio = NULL;
+	}
+	return ret;
+}
+
+static int __radio_create_async(radio_h *radio, radio_ready_cb callback, void *user_data)
+{
+	RADIO_NULL_ARG_CHECK(radio);
+	radio_s * handle;
+	int ret = __radio_alloc(&handle);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+	handle->ready_cb = callback;
+	handle->ready_user_data = user_data;
+	_RADIO_ATOMIC_SET(handle->realize_status, _RADIO_REALIZE_PENDING);
+	if(pthread_create(&handle->realize_thread, NULL, __radio_realize_thread, handle) != 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create realize thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		__radio_discard(handle);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	handle->realize_thread_started = TRUE;
+	*radio = handle->self;
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_create_lazy(radio_h *radio)
+{
+	RADIO_NULL_ARG_CHECK(radio);
+	radio_s * handle;
+	int ret = __radio_alloc(&handle);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+	*radio = handle->self;
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_destroy(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+
+	int ret;
+	__radio_command_stop(handle);
+	__radio_sampler_stop(handle);
+	__radio_af_stop(handle);
+	__radio_rds_stop(handle);
+	_radio_timeshift_stop(&handle->timeshift);
+	_radio_recorder_stop(&handle->recorder);
+	_radio_meter_stop(&handle->meter);
+	pthread_mutex_lock(&handle->tap.lock);
+	if(handle->tap.thread_started)
+		__radio_pcm_tap_join(handle);
+	pthread_mutex_unlock(&handle->tap.lock);
+	if(_RADIO_ATOMIC_GET(handle->sweep.running))
+		_RADIO_ATOMIC_SET(handle->sweep.cancel, TRUE);
+	__radio_sweep_join(handle);
+	if(handle->realize_thread_started)
+	{
+		pthread_join(handle->realize_thread, NULL);
+		handle->realize_thread_started = FALSE;
+	}
+	__radio_set_event_context(radio, NULL);
+	if(_RADIO_ATOMIC_GET(handle->realize_status) == _RADIO_REALIZE_DONE)
+	{
+		ret = handle->backend->unrealize(handle->mm_handle);
+		if ( ret!= MM_ERROR_NONE)
+		{
+			LOGW("[%s] Failed to unrealize (0x%x)" ,__FUNCTION__, ret);
+		}
+	}
+	
+	ret = handle->backend->destroy(handle->mm_handle);
+	if (ret!= MM_ERROR_NONE)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION (0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	else
+	{
+		__radio_free(handle);
+		handle= NULL;
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_get_state(radio_h radio, radio_state_e *state)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(state);
+	radio_s * handle = _radio_handle_get(radio);
+	*state = __radio_get_cached_state(handle);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_refresh(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	if(_RADIO_ATOMIC_GET(handle->realize_status) == _RADIO_REALIZE_SUSPENDED)
+		__radio_ensure_realized(handle);
+	RADIO_REALIZED_CHECK(handle);
+	MMRadioStateType currentStat = MM_RADIO_STATE_NULL;
+	int ret = handle->backend->get_state(handle->mm_handle, &currentStat);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	__radio_set_state_from_backend(handle, __convert_radio_state(currentStat));
+
+	int freq;
+	ret = handle->backend->get_frequency(handle->mm_handle, &freq);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	__radio_set_cached_frequency(handle, freq);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_start(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_READY);  
+
+	int ret = __radio_ensure_realized(handle);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+
+	uint64_t state_word = _RADIO_ATOMIC_GET(handle->state_word);
+	ret = handle->backend->start(handle->mm_handle);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		__radio_set_state_if_unchanged(handle, state_word, RADIO_STATE_PLAYING);
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_stop(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_PLAYING);  
+	
+	uint64_t state_word = _RADIO_ATOMIC_GET(handle->state_word);
+	int ret = handle->backend->stop(handle->mm_handle);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		__radio_set_state_if_unchanged(handle, state_word, RADIO_STATE_READY);
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_seek_up(radio_h radio,radio_seek_completed_cb callback, void *user_data )
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_PLAYING);
+	
+	if(callback!=NULL)
+	{
+		__set_callback(_RADIO_EVENT_TYPE_SEEK_FINISH,radio,callback,user_data);
+	}
+	else
+	{
+		__unset_callback(_RADIO_EVENT_TYPE_SEEK_FINISH,radio);
+	}
+	
+	if(__radio_seek_predicted(handle, 1))
+	{
+		return RADIO_ERROR_NONE;
+	}
+
+	int ret = handle->backend->seek(handle->mm_handle, MM_RADIO_SEEK_UP);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_seek_down(radio_h radio,radio_seek_completed_cb callback, void *user_data )
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_PLAYING);
+	
+	if(callback!=NULL)
+	{
+		__set_callback(_RADIO_EVENT_TYPE_SEEK_FINISH,radio,callback,user_data);
+	}
+	else
+	{
+		__unset_callback(_RADIO_EVENT_TYPE_SEEK_FINISH,radio);
+	}
+	
+	if(__radio_seek_predicted(handle, -1))
+	{
+		return RADIO_ERROR_NONE;
+	}
+
+	int ret = handle->backend->seek(handle->mm_handle, MM_RADIO_SEEK_DOWN);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_set_region(radio_h radio, radio_region_e region)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_READY);
+	RADIO_CHECK_CONDITION(region >= 0 && (int)region < RADIO_REGION_NUM, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+
+	const _radio_band_plan_s *band = &__band_plans[region];
+	if(__radio_get_band(handle) == band)
+		return RADIO_ERROR_NONE;
+
+	__radio_sweep_join(handle);
+	_RADIO_ATOMIC_SET(handle->sweep.resumable, FALSE);
+
+	/*
+	* Every band keeps its own station list. The list of the new band is mapped before it replaces the old one,
+	* which stays mapped : the other threads see one list or the other, never none.
+	*/
+	_radio_station_cache_sync(&handle->stations);
+	int ret = _radio_station_cache_open(&handle->stations, band->min, band->max, band->spacing);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+	_RADIO_ATOMIC_SET(handle->band, band);
+	__radio_spectrum_reset(handle);
+	LOGI("[%s] Region : %d (%d ~ %d, %d kHz spacing)" ,__FUNCTION__, region, band->min, band->max, band->spacing);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_get_region(radio_h radio, radio_region_e *region)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(region);
+	radio_s * handle = _radio_handle_get(radio);
+	*region = __radio_get_band(handle)->region;
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_get_frequency_range(radio_h radio, int *min_frequency, int *max_frequency)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(min_frequency);
+	RADIO_NULL_ARG_CHECK(max_frequency);
+	radio_s * handle = _radio_handle_get(radio);
+	const _radio_band_plan_s *band = __radio_get_band(handle);
+	*min_frequency = band->min;
+	*max_frequency = band->max;
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_get_channel_spacing(radio_h radio, int *spacing)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(spacing);
+	radio_s * handle = _radio_handle_get(radio);
+	*spacing = __radio_get_band(handle)->spacing;
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_frequency(radio_h radio, int frequency)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	const _radio_band_plan_s *band = __radio_get_band(handle);
+	if(!__radio_band_contains(band, frequency))
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Out of band plan (%d ~ %d, %d kHz spacing)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, band->min, band->max, band->spacing);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	int freq= frequency;
+
+	__radio_touch(handle);
+	pthread_mutex_lock(&handle->realize_lock);
+	if(__radio_is_deferred(handle))
+	{
+		bool suspended = (_RADIO_ATOMIC_GET(handle->realize_status) == _RADIO_REALIZE_SUSPENDED);
+		__radio_set_cached_frequency(handle, freq);
+		handle->pending_frequency = TRUE;
+		pthread_mutex_unlock(&handle->realize_lock);
+		/* applied by the resume itself */
+		return suspended ? __radio_ensure_realized(handle) : RADIO_ERROR_NONE;
+	}
+	int ret = __radio_realize_failed(handle);
+	pthread_mutex_unlock(&handle->realize_lock);
+	if(ret != RADIO_ERROR_NONE)
+		return ret;
+
+	ret = handle->backend->set_frequency(handle->mm_handle, freq);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		__radio_set_cached_frequency(handle, freq);
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_get_frequency(radio_h radio, int *frequency)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(frequency);
+	radio_s * handle = _radio_handle_get(radio);
+
+	int freq = _RADIO_ATOMIC_GET(handle->frequency);
+	if(freq != 0)
+	{
+		*frequency = freq;
+		return RADIO_ERROR_NONE;
+	}
+
+	RADIO_REALIZED_CHECK(handle);
+	int ret = handle->backend->get_frequency(handle->mm_handle, &freq);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		__radio_set_cached_frequency(handle, freq);
+		*frequency = freq; 
+		return RADIO_ERROR_NONE;
+	}
+}	
+
+static int __radio_get_signal_strength(radio_h radio, int *strength)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(strength);
+	radio_s * handle = _radio_handle_get(radio);
+	if(_RADIO_ATOMIC_GET(handle->realize_status) == _RADIO_REALIZE_SUSPENDED)
+		__radio_ensure_realized(handle);
+	RADIO_REALIZED_CHECK(handle);
+	__radio_touch(handle);
+
+	int _strength;
+	int ret = handle->backend->get_signal_strength(handle->mm_handle, &_strength);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		_radio_station_cache_refresh(&handle->stations, _RADIO_ATOMIC_GET(handle->frequency), _strength, time(NULL));
+		_radio_spectrum_set(&handle->spectrum, _RADIO_ATOMIC_GET(handle->frequency), _strength);
+		*strength = _strength;
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_scan_start(radio_h radio, radio_scan_updated_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_READY);  
+
+	if(callback!=NULL)
+	{
+		__set_callback(_RADIO_EVENT_TYPE_SCAN_INFO,radio,callback,user_data);
+	}
+	else
+	{
+		__unset_callback(_RADIO_EVENT_TYPE_SCAN_INFO,radio);
+	}
+	
+	int ret = __radio_ensure_realized(handle);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+
+	__radio_sweep_join(handle);
+	const _radio_band_plan_s *band = __radio_get_band(handle);
+	handle->sweep.mode = _RADIO_SWEEP_RANGE;
+	handle->sweep.start = band->min;
+	handle->sweep.end = band->max;
+	handle->sweep.step = band->spacing;
+	_RADIO_ATOMIC_SET(handle->sweep.next, band->min);
+
+	/* the tuner's own scan only covers its native band, other bands are swept on the region's raster */
+	if(band->min != RADIO_NATIVE_BAND_MIN || band->max != RADIO_NATIVE_BAND_MAX)
+	{
+		return __radio_sweep_start(handle, FALSE, callback, user_data);
+	}
+	handle->sweep.tuned = _RADIO_ATOMIC_GET(handle->frequency);
+	_RADIO_ATOMIC_SET(handle->sweep.resumable, FALSE);
+
+	uint64_t state_word = _RADIO_ATOMIC_GET(handle->state_word);
+	_RADIO_ATOMIC_SET(handle->sweep.start_time, (int64_t)time(NULL));
+	ret = handle->backend->scan_start(handle->mm_handle);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		__radio_set_state_if_unchanged(handle, state_word, RADIO_STATE_SCANNING);
+		/* the tuner moves across the band while scanning, the next radio_get_frequency() asks the backend */
+		__radio_set_cached_frequency(handle, 0);
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_scan_stop(radio_h radio, radio_scan_stopped_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_SCANNING);  
+
+	if(callback!=NULL)
+	{
+		__set_callback(_RADIO_EVENT_TYPE_SCAN_STOP,radio,callback,user_data);
+	}
+	else
+	{
+		__unset_callback(_RADIO_EVENT_TYPE_SCAN_STOP,radio);
+	}
+
+	if(_RADIO_ATOMIC_GET(handle->sweep.running))
+	{
+		__radio_sweep_stop(handle);
+		return RADIO_ERROR_NONE;
+	}
+	
+	uint64_t state_word = _RADIO_ATOMIC_GET(handle->state_word);
+	int ret = handle->backend->scan_stop(handle->mm_handle);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		__radio_set_state_if_unchanged(handle, state_word, RADIO_STATE_READY);
+		return RADIO_ERROR_NONE;
+	}
+}
+
+
+static int __radio_scan_range_start(radio_h radio, int start_frequency, int end_frequency, int step, radio_scan_updated_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_READY);
+	const _radio_band_plan_s *band = __radio_get_band(handle);
+	if(step == 0)
+		step = band->spacing;
+	if(!__radio_band_contains(band, start_frequency) || end_frequency > band->max
+		|| start_frequency > end_frequency || step < 0 || step % band->spacing != 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Invalid range (%d ~ %d, step %d)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, start_frequency, end_frequency, step);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+
+	int ret = __radio_ensure_realized(handle);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+
+	__radio_sweep_join(handle);
+	handle->sweep.mode = _RADIO_SWEEP_RANGE;
+	handle->sweep.start = start_frequency;
+	handle->sweep.end = end_frequency;
+	handle->sweep.step = step;
+	_RADIO_ATOMIC_SET(handle->sweep.next, start_frequency);
+	return __radio_sweep_start(handle, FALSE, callback, user_data);
+}
+
+static int __radio_scan_resume(radio_h radio, radio_scan_updated_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_READY);
+	RADIO_CHECK_CONDITION(_RADIO_ATOMIC_GET(handle->sweep.resumable), RADIO_ERROR_INVALID_OPERATION, "RADIO_ERROR_INVALID_OPERATION");
+
+	int ret = __radio_ensure_realized(handle);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+
+	__radio_sweep_join(handle);
+	return __radio_sweep_start(handle, TRUE, callback, user_data);
+}
+
+static int __radio_scan_incremental_start(radio_h radio, radio_scan_updated_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	RADIO_STATE_CHECK(handle,RADIO_STATE_READY);
+
+	int ret = __radio_ensure_realized(handle);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		return ret;
+	}
+
+	__radio_sweep_join(handle);
+	const _radio_band_plan_s *band = __radio_get_band(handle);
+
+	/* known stations and their neighbour channels, in ascending order and without duplicates */
+	radio_station_s stations[_RADIO_STATION_CACHE_MAX];
+	int count = _radio_station_cache_copy(&handle->stations, stations, _RADIO_STATION_CACHE_MAX);
+	int i, offset;
+	handle->sweep.count = 0;
+	for(i = 0; i < count; i++)
+	{
+		for(offset = -band->spacing; offset <= band->spacing; offset += band->spacing)
+		{
+			int frequency = stations[i].frequency + offset;
+			if(!__radio_band_contains(band, frequency))
+				continue;
+			if(handle->sweep.count > 0 && handle->sweep.channels[handle->sweep.count - 1] >= frequency)
+				continue;
+			handle->sweep.channels[handle->sweep.count++] = frequency;
+		}
+	}
+	handle->sweep.mode = _RADIO_SWEEP_LIST;
+	/* stations of the whole band that did not answer are removed */
+	handle->sweep.start = band->min;
+	handle->sweep.end = band->max;
+	_RADIO_ATOMIC_SET(handle->sweep.next, 0);
+	return __radio_sweep_start(handle, FALSE, callback, user_data);
+}
+
+static int __radio_set_scan_threshold(radio_h radio, int strength)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	_RADIO_ATOMIC_SET(handle->scan_threshold, strength);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_predictive_seek(radio_h radio, bool enable)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	_RADIO_ATOMIC_SET(handle->predictive_seek, enable);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_foreach_station(radio_h radio, radio_station_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(callback);
+	radio_s * handle = _radio_handle_get(radio);
+
+	/* iterate over a copy, the callback may trigger a scan which updates the list */
+	radio_station_s stations[_RADIO_STATION_CACHE_MAX];
+	int count = _radio_station_cache_copy(&handle->stations, stations, _RADIO_STATION_CACHE_MAX);
+	int i;
+	for(i = 0; i < count; i++)
+	{
+		if(!callback(&stations[i], user_data))
+			break;
+	}
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_get_station_count(radio_h radio, int *count)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(count);
+	radio_s * handle = _radio_handle_get(radio);
+	*count = _radio_station_cache_count(&handle->stations);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_clear_stations(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_station_cache_clear(&handle->stations);
+	_radio_station_cache_sync(&handle->stations);
+	__radio_spectrum_reset(handle);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_mute(radio_h radio, bool muted)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+
+	__radio_touch(handle);
+	pthread_mutex_lock(&handle->realize_lock);
+	if(__radio_is_deferred(handle))
+	{
+		__radio_set_cached_mute(handle, muted);
+		handle->pending_mute = TRUE;
+		pthread_mutex_unlock(&handle->realize_lock);
+		return RADIO_ERROR_NONE;
+	}
+	int ret = __radio_realize_failed(handle);
+	pthread_mutex_unlock(&handle->realize_lock);
+	if(ret != RADIO_ERROR_NONE)
+		return ret;
+
+	ret = handle->backend->set_mute(handle->mm_handle, muted);
+	if(ret != MM_ERROR_NONE)
+	{
+		return __convert_error_code(ret,(char*)__FUNCTION__);
+	}
+	else
+	{
+		__radio_set_cached_mute(handle, muted);
+		return RADIO_ERROR_NONE;
+	}
+}
+
+static int __radio_is_muted(radio_h radio, bool *muted)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(muted);
+	radio_s * handle = _radio_handle_get(radio);
+	*muted = _RADIO_ATOMIC_GET(handle->mute);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_scan_completed_cb(radio_h radio, radio_scan_completed_cb callback, void *user_data)
+{
+	return __set_callback(_RADIO_EVENT_TYPE_SCAN_FINISH,radio,callback,user_data);
+}
+
+static int __radio_unset_scan_completed_cb(radio_h radio)
+{
+	return __unset_callback(_RADIO_EVENT_TYPE_SCAN_FINISH,radio);
+}
+
+static int __radio_set_scan_batch_cb(radio_h radio, int max_count, int max_latency_ms, radio_scan_batch_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_CHECK_CONDITION(max_count >= 0 && max_latency_ms >= 0, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	_RADIO_ATOMIC_SET(handle->batch.max_count, max_count);
+	_RADIO_ATOMIC_SET(handle->batch.max_latency_ms, max_latency_ms);
+	return __set_callback(_RADIO_EVENT_TYPE_SCAN_BATCH,radio,callback,user_data);
+}
+
+static int __radio_unset_scan_batch_cb(radio_h radio)
+{
+	return __unset_callback(_RADIO_EVENT_TYPE_SCAN_BATCH,radio);
+}
+
+static int __radio_set_interrupted_cb(radio_h radio, radio_interrupted_cb callback, void *user_data)
+{
+	return __set_callback(_RADIO_EVENT_TYPE_INTERRUPT,radio,callback,user_data);
+}
+
+static int __radio_unset_interrupted_cb(radio_h radio)
+{
+	return __unset_callback(_RADIO_EVENT_TYPE_INTERRUPT,radio);
+}
+
+static int __radio_set_signal_strength_changed_cb(radio_h radio, int interval_ms, int threshold, int hysteresis, int delta,
+	radio_signal_strength_changed_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(callback);
+	RADIO_CHECK_CONDITION(interval_ms > 0 && hysteresis >= 0 && delta >= 0, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_sampler_s *sampler = &handle->sampler;
+
+	pthread_mutex_lock(&sampler->lock);
+	sampler->interval_ms = interval_ms;
+	sampler->threshold = threshold;
+	sampler->hysteresis = hysteresis;
+	sampler->delta = delta;
+	sampler->callback = callback;
+	sampler->user_data = user_data;
+	sampler->restart = TRUE;
+	if(sampler->thread_started)
+	{
+		pthread_cond_signal(&sampler->cond);
+		pthread_mutex_unlock(&sampler->lock);
+		return RADIO_ERROR_NONE;
+	}
+
+	sampler->generation++;
+	if(pthread_create(&sampler->thread, NULL, __radio_sampler_thread, handle) != 0)
+	{
+		sampler->callback = NULL;
+		pthread_mutex_unlock(&sampler->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create sampler thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	_RADIO_ATOMIC_SET(sampler->thread_started, TRUE);
+	pthread_mutex_unlock(&sampler->lock);
+	LOGI("[%s] Sampling every %d ms (threshold %d, hysteresis %d, delta %d)" ,__FUNCTION__, interval_ms, threshold, hysteresis, delta);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_unset_signal_strength_changed_cb(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	__radio_sampler_stop(handle);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_alternate_frequencies(radio_h radio, const int *frequencies, int count)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_CHECK_CONDITION(count >= 0 && count <= _RADIO_AF_MAX && (count == 0 || frequencies != NULL), RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_af_monitor_s *af = &handle->af;
+	int i;
+
+	for(i = 0; i < count; i++)
+	{
+		if(!__radio_band_contains(__radio_get_band(handle), frequencies[i]))
+		{
+			LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : %d kHz is off the band plan" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, frequencies[i]);
+			return RADIO_ERROR_INVALID_PARAMETER;
+		}
+	}
+	pthread_mutex_lock(&af->lock);
+	if(count > 0)
+		memcpy(af->frequencies, frequencies, sizeof(int) * count);
+	memset(af->hits, 0, sizeof(af->hits));
+	af->count = count;
+	af->next = 0;
+	pthread_cond_signal(&af->cond);
+	pthread_mutex_unlock(&af->lock);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_alternate_frequency_cb(radio_h radio, int margin, int tuner_share, bool auto_switch,
+	radio_alternate_frequency_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(callback);
+	RADIO_CHECK_CONDITION(margin > 0 && tuner_share >= 1 && tuner_share <= 50, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_af_monitor_s *af = &handle->af;
+
+	pthread_mutex_lock(&af->lock);
+	af->margin = margin;
+	af->tuner_share = tuner_share;
+	af->auto_switch = auto_switch;
+	af->callback = callback;
+	af->user_data = user_data;
+	memset(af->hits, 0, sizeof(af->hits));
+	if(af->thread_started)
+	{
+		pthread_cond_signal(&af->cond);
+		pthread_mutex_unlock(&af->lock);
+		return RADIO_ERROR_NONE;
+	}
+
+	af->generation++;
+	if(pthread_create(&af->thread, NULL, __radio_af_thread, handle) != 0)
+	{
+		af->callback = NULL;
+		pthread_mutex_unlock(&af->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create alternate frequency thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	_RADIO_ATOMIC_SET(af->thread_started, TRUE);
+	pthread_mutex_unlock(&af->lock);
+	LOGI("[%s] Watching alternate frequencies (margin %d, tuner share %d%%, auto switch %d)" ,__FUNCTION__, margin, tuner_share, auto_switch);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_unset_alternate_frequency_cb(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	__radio_af_stop(handle);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_rds_changed_cb(radio_h radio, radio_rds_changed_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(callback);
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_rds_monitor_s *rds = &handle->rds;
+	radio_rds_changed_cb previous;
+	void *previous_data;
+
+	if(handle->backend->read_rds == NULL)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : The %s backend does not provide RDS" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, handle->backend->name);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+
+	pthread_mutex_lock(&rds->lock);
+	previous = rds->callback;
+	previous_data = rds->user_data;
+	rds->callback = callback;
+	rds->user_data = user_data;
+	if(rds->thread_started)
+	{
+		pthread_mutex_unlock(&rds->lock);
+		if(previous != callback || previous_data != user_data)
+			__radio_dispatch_purge(handle, _RADIO_DISPATCH_RDS, previous, previous_data);
+		return RADIO_ERROR_NONE;
+	}
+
+	rds->generation++;
+	_radio_rds_decoder_init(&rds->decoder);
+	if(pthread_create(&rds->thread, NULL, __radio_rds_thread, handle) != 0)
+	{
+		rds->callback = NULL;
+		pthread_mutex_unlock(&rds->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create RDS thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	_RADIO_ATOMIC_SET(rds->thread_started, TRUE);
+	pthread_mutex_unlock(&rds->lock);
+	LOGI("[%s] Decoding RDS" ,__FUNCTION__);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_unset_rds_changed_cb(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	__radio_rds_stop(handle);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_get_rds_info(radio_h radio, int frequency, radio_rds_info_s *info)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(info);
+	RADIO_CHECK_CONDITION(frequency >= 0, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+
+	_radio_rds_cache_get(&handle->rds.cache, frequency != 0 ? frequency : _RADIO_ATOMIC_GET(handle->frequency), info);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_pcm_tap_start(radio_h radio, int period_frames, int period_count)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_CHECK_CONDITION(period_frames >= 1 && period_frames <= _RADIO_PCM_PERIOD_FRAMES_MAX, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	RADIO_CHECK_CONDITION(period_count >= 2 && period_count <= _RADIO_PCM_PERIOD_COUNT_MAX && (period_count & (period_count - 1)) == 0,
+		RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_pcm_tap_s *tap = &handle->tap;
+	int sample_rate, channels, ret;
+
+	if(handle->backend->read_pcm == NULL || handle->backend->get_pcm_format == NULL
+		|| handle->backend->get_pcm_format(handle->mm_handle, &sample_rate, &channels) != MM_ERROR_NONE
+		|| channels < 1 || channels > _RADIO_PCM_CHANNELS_MAX || sample_rate <= 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : The %s backend does not provide the audio" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, handle->backend->name);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+
+	pthread_mutex_lock(&tap->lock);
+	if(tap->thread_started)
+	{
+		pthread_mutex_unlock(&tap->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : The tap is already started" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		return RADIO_ERROR_INVALID_STATE;
+	}
+	ret = _radio_pcm_ring_open(&tap->ring, sample_rate, channels, period_frames, period_count);
+	if(ret != RADIO_ERROR_NONE)
+	{
+		pthread_mutex_unlock(&tap->lock);
+		return ret;
+	}
+	tap->quit = FALSE;
+	if(pthread_create(&tap->thread, NULL, __radio_pcm_tap_thread, handle) != 0)
+	{
+		_radio_pcm_ring_close(&tap->ring);
+		pthread_mutex_unlock(&tap->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create audio tap thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	_RADIO_ATOMIC_SET(tap->thread_started, TRUE);
+	pthread_mutex_unlock(&tap->lock);
+	LOGI("[%s] Audio tap : %d Hz, %d channels, %d periods of %d frames" ,__FUNCTION__, sample_rate, channels, period_count, period_frames);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_pcm_tap_stop(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+
+	pthread_mutex_lock(&handle->tap.lock);
+	if(handle->tap.thread_started)
+		__radio_pcm_tap_join(handle);
+	pthread_mutex_unlock(&handle->tap.lock);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_pcm_tap_get_fd(radio_h radio, int *fd)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(fd);
+	radio_s * handle = _radio_handle_get(radio);
+	int ret = RADIO_ERROR_NONE;
+
+	pthread_mutex_lock(&handle->tap.lock);
+	if(handle->tap.ring.fd < 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : The tap is not started" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		ret = RADIO_ERROR_INVALID_STATE;
+	}
+	else
+	{
+		*fd = handle->tap.ring.fd;
+	}
+	pthread_mutex_unlock(&handle->tap.lock);
+	return ret;
+}
+
+static int __radio_pcm_reader_create(radio_h radio, radio_pcm_reader_h *reader)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(reader);
+	radio_s * handle = _radio_handle_get(radio);
+	int ret;
+
+	/* the lock keeps the descriptor open until the reader has its own */
+	pthread_mutex_lock(&handle->tap.lock);
+	if(handle->tap.ring.fd < 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : The tap is not started" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		ret = RADIO_ERROR_INVALID_STATE;
+	}
+	else
+	{
+		ret = radio_pcm_reader_create_from_fd(handle->tap.ring.fd, reader);
+	}
+	pthread_mutex_unlock(&handle->tap.lock);
+	return ret;
+}
+
+static int __radio_timeshift_start(radio_h radio, const char *path, int seconds)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(path);
+	RADIO_CHECK_CONDITION(seconds >= 1 && seconds <= _RADIO_TIMESHIFT_SECONDS_MAX, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	radio_pcm_reader_h reader;
+
+	int ret = __radio_pcm_reader_create(radio, &reader);
+	if(ret != RADIO_ERROR_NONE)
+		return ret;
+	ret = _radio_timeshift_start(&handle->timeshift, reader, path, seconds);
+	if(ret != RADIO_ERROR_NONE)
+		radio_pcm_reader_destroy(reader);
+	return ret;
+}
+
+static int __radio_timeshift_stop(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_timeshift_stop(&handle->timeshift);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_timeshift_pause(radio_h radio, bool paused)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	return _radio_timeshift_pause(&handle->timeshift, paused);
+}
+
+static int __radio_timeshift_seek(radio_h radio, int delay_ms)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_CHECK_CONDITION(delay_ms >= 0, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	return _radio_timeshift_seek(&handle->timeshift, delay_ms);
+}
+
+static int __radio_timeshift_get_position(radio_h radio, int *delay_ms, int *buffered_ms)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(delay_ms);
+	RADIO_NULL_ARG_CHECK(buffered_ms);
+	radio_s * handle = _radio_handle_get(radio);
+	return _radio_timeshift_get_position(&handle->timeshift, delay_ms, buffered_ms);
+}
+
+static int __radio_timeshift_read(radio_h radio, short *frames, int frame_count, int *read_count)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(frames);
+	RADIO_NULL_ARG_CHECK(read_count);
+	RADIO_CHECK_CONDITION(frame_count > 0, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	return _radio_timeshift_read(&handle->timeshift, frames, frame_count, read_count);
+}
+
+static int __radio_recording_start(radio_h radio, const char *path, radio_recording_format_e format, int sample_rate)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(path);
+	RADIO_CHECK_CONDITION(format == RADIO_RECORDING_FORMAT_WAV_PCM || format == RADIO_RECORDING_FORMAT_WAV_IMA_ADPCM, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	RADIO_CHECK_CONDITION(sample_rate == 0 || (sample_rate >= _RADIO_RECORDER_RATE_MIN && sample_rate <= _RADIO_RECORDER_RATE_MAX), RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	radio_pcm_reader_h reader;
+
+	int ret = __radio_pcm_reader_create(radio, &reader);
+	if(ret != RADIO_ERROR_NONE)
+		return ret;
+	ret = _radio_recorder_start(&handle->recorder, reader, path, format, sample_rate);
+	if(ret != RADIO_ERROR_NONE)
+		radio_pcm_reader_destroy(reader);
+	return ret;
+}
+
+static int __radio_recording_stop(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_recorder_stop(&handle->recorder);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_recording_get_status(radio_h radio, radio_recording_status_s *status)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(status);
+	radio_s * handle = _radio_handle_get(radio);
+	return _radio_recorder_get_status(&handle->recorder, status);
+}
+
+static int __radio_level_meter_start(radio_h radio, int interval_ms, int silence_level, radio_level_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_CHECK_CONDITION(interval_ms >= _RADIO_METER_INTERVAL_MIN && interval_ms <= _RADIO_METER_INTERVAL_MAX, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	RADIO_CHECK_CONDITION(silence_level >= 0 && silence_level <= _RADIO_METER_LEVEL_MAX, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	radio_pcm_reader_h reader;
+
+	int ret = __radio_pcm_reader_create(radio, &reader);
+	if(ret != RADIO_ERROR_NONE)
+		return ret;
+	ret = _radio_meter_start(&handle->meter, reader, interval_ms, silence_level, callback, user_data, __radio_level_notify, handle);
+	if(ret != RADIO_ERROR_NONE)
+		radio_pcm_reader_destroy(reader);
+	return ret;
+}
+
+static int __radio_level_meter_stop(radio_h radio)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+
+	_radio_meter_stop(&handle->meter);
+	/* the meter is stopped, the callback of its last run cannot change under us */
+	if(handle->meter.callback != NULL)
+		__radio_dispatch_purge(handle, _RADIO_DISPATCH_LEVEL, handle->meter.callback, handle->meter.user_data);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_level_meter_get(radio_h radio, radio_level_s *level)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(level);
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_meter_get(&handle->meter, level);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_dump_trace(radio_h radio, int fd)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_CHECK_CONDITION(fd >= 0, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	if(_radio_trace_dump(&handle->trace, fd) < 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to write the trace" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_frequency_async(radio_h radio, int frequency, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	const _radio_band_plan_s *band = __radio_get_band(handle);
+	if(!__radio_band_contains(band, frequency))
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Out of band plan (%d ~ %d, %d kHz spacing)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, band->min, band->max, band->spacing);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	return __radio_command_push(handle, RADIO_COMMAND_SET_FREQUENCY, frequency, callback, user_data);
+}
+
+static int __radio_start_async(radio_h radio, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	return __radio_command_push(_radio_handle_get(radio), RADIO_COMMAND_START, 0, callback, user_data);
+}
+
+static int __radio_stop_async(radio_h radio, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	return __radio_command_push(_radio_handle_get(radio), RADIO_COMMAND_STOP, 0, callback, user_data);
+}
+
+static int __radio_seek_up_async(radio_h radio, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	return __radio_command_push(_radio_handle_get(radio), RADIO_COMMAND_SEEK_UP, 0, callback, user_data);
+}
+
+static int __radio_seek_down_async(radio_h radio, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	return __radio_command_push(_radio_handle_get(radio), RADIO_COMMAND_SEEK_DOWN, 0, callback, user_data);
+}
+
+static int __radio_get_event_fd(radio_h radio, int *fd)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(fd);
+	radio_s * handle = _radio_handle_get(radio);
+	return _radio_event_ring_open(&handle->events, fd);
+}
+
+static int __radio_read_events(radio_h radio, radio_event_s *events, int max_count, int *count)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(events);
+	RADIO_NULL_ARG_CHECK(count);
+	RADIO_CHECK_CONDITION(max_count > 0, RADIO_ERROR_INVALID_PARAMETER, "RADIO_ERROR_INVALID_PARAMETER");
+	radio_s * handle = _radio_handle_get(radio);
+	if(_RADIO_ATOMIC_GET(handle->events.fd) < 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : radio_get_event_fd() was not called" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	*count = _radio_event_ring_read(&handle->events, events, max_count);
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_set_idle_timeout(radio_h radio, int timeout_ms)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_command_queue_s *queue = &handle->commands;
+	int ret;
+
+	if(timeout_ms != 0 && timeout_ms < RADIO_IDLE_TIMEOUT_MIN_MS)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Idle timeout below %d ms" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, RADIO_IDLE_TIMEOUT_MIN_MS);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	pthread_mutex_lock(&queue->lock);
+	ret = (timeout_ms > 0) ? __radio_command_start(handle) : RADIO_ERROR_NONE;
+	if(ret == RADIO_ERROR_NONE)
+	{
+		__radio_touch(handle);
+		_RADIO_ATOMIC_SET(handle->idle_timeout_ms, timeout_ms);
+		pthread_cond_signal(&queue->cond);
+	}
+	pthread_mutex_unlock(&queue->lock);
+	return ret;
+}
+
+static int __radio_get_status(radio_h radio, radio_status_s *status)
+{
+	RADIO_INSTANCE_CHECK(radio);
+	RADIO_NULL_ARG_CHECK(status);
+	radio_s * handle = _radio_handle_get(radio);
+	_radio_status_s *snapshot = &handle->status;
+	uint32_t seq;
+	int rssi;
+
+	while(1)
+	{
+		seq = __atomic_load_n(&snapshot->seq, __ATOMIC_ACQUIRE);
+		if(seq & 1)
+			continue;
+		status->state = _RADIO_STATE_WORD_STATE(__atomic_load_n(&handle->state_word, __ATOMIC_RELAXED));
+		status->frequency = __atomic_load_n(&handle->frequency, __ATOMIC_RELAXED);
+		status->muted = __atomic_load_n(&handle->mute, __ATOMIC_RELAXED);
+		status->scan_frequency = __atomic_load_n(&snapshot->scan_frequency, __ATOMIC_RELAXED);
+		status->scan_station_count = __atomic_load_n(&snapshot->scan_station_count, __ATOMIC_RELAXED);
+		status->interrupted = __atomic_load_n(&snapshot->interrupted, __ATOMIC_RELAXED);
+		status->interrupted_code = __atomic_load_n(&snapshot->interrupted_code, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&snapshot->seq, __ATOMIC_RELAXED) == seq)
+			break;
+	}
+
+	/* the spectrum keeps the last measure of every channel, the one of the snapshot's frequency belongs to it */
+	rssi = status->frequency ? _radio_spectrum_get(&handle->spectrum, status->frequency) : _RADIO_SPECTRUM_UNKNOWN;
+	status->signal_strength = (rssi == _RADIO_SPECTRUM_UNKNOWN) ? 0 : rssi;
+	return RADIO_ERROR_NONE;
+}
+
+static int __radio_add_scan_updated_cb(radio_h radio, radio_scan_updated_cb callback, void *user_data, int *id)
+{
+	return __radio_add_listener(radio, _RADIO_EVENT_TYPE_SCAN_INFO, callback, user_data, id);
+}
+
+static int __radio_add_scan_completed_cb(radio_h radio, radio_scan_completed_cb callback, void *user_data, int *id)
+{
+	return __radio_add_listener(radio, _RADIO_EVENT_TYPE_SCAN_FINISH, callback, user_data, id);
+}
+
+static int __radio_add_interrupted_cb(radio_h radio, radio_interrupted_cb callback, void *user_data, int *id)
+{
+	return __radio_add_listener(radio, _RADIO_EVENT_TYPE_INTERRUPT, callback, user_data, id);
+}
+
+static int __radio_remove_cb(radio_h radio, int id)
+{
+	return __radio_remove_listener(radio, id);
+}
+
+/*
+* Instrumented entry points, see radio_foreach_statistics()
+*/
+int radio_create(radio_h *radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_CREATE, __radio_create(radio));
+}
+
+int radio_create_async(radio_h *radio, radio_ready_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_CREATE_ASYNC, __radio_create_async(radio, callback, user_data));
+}
+
+int radio_create_lazy(radio_h *radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_CREATE_LAZY, __radio_create_lazy(radio));
+}
+
+int radio_destroy(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_DESTROY, __radio_destroy(radio));
+}
+
+int radio_get_state(radio_h radio, radio_state_e *state)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_STATE, __radio_get_state(radio, state));
+}
+
+int radio_refresh(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_REFRESH, __radio_refresh(radio));
+}
+
+int radio_start(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_START, __radio_start(radio));
+}
+
+int radio_stop(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_STOP, __radio_stop(radio));
+}
+
+int radio_seek_up(radio_h radio,radio_seek_completed_cb callback, void *user_data )
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SEEK_UP, __radio_seek_up(radio, callback, user_data));
+}
+
+int radio_seek_down(radio_h radio,radio_seek_completed_cb callback, void *user_data )
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SEEK_DOWN, __radio_seek_down(radio, callback, user_data));
+}
+
+int radio_set_region(radio_h radio, radio_region_e region)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_REGION, __radio_set_region(radio, region));
+}
+
+int radio_get_region(radio_h radio, radio_region_e *region)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_REGION, __radio_get_region(radio, region));
+}
+
+int radio_get_frequency_range(radio_h radio, int *min_frequency, int *max_frequency)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_FREQUENCY_RANGE, __radio_get_frequency_range(radio, min_frequency, max_frequency));
+}
+
+int radio_get_channel_spacing(radio_h radio, int *spacing)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_CHANNEL_SPACING, __radio_get_channel_spacing(radio, spacing));
+}
+
+int radio_set_frequency(radio_h radio, int frequency)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_FREQUENCY, __radio_set_frequency(radio, frequency));
+}
+
+int radio_get_frequency(radio_h radio, int *frequency)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_FREQUENCY, __radio_get_frequency(radio, frequency));
+}
+
+int radio_get_signal_strength(radio_h radio, int *strength)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_SIGNAL_STRENGTH, __radio_get_signal_strength(radio, strength));
+}
+
+int radio_scan_start(radio_h radio, radio_scan_updated_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SCAN_START, __radio_scan_start(radio, callback, user_data));
+}
+
+int radio_scan_stop(radio_h radio, radio_scan_stopped_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SCAN_STOP, __radio_scan_stop(radio, callback, user_data));
+}
+
+int radio_scan_range_start(radio_h radio, int start_frequency, int end_frequency, int step, radio_scan_updated_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SCAN_RANGE_START, __radio_scan_range_start(radio, start_frequency, end_frequency, step, callback, user_data));
+}
+
+int radio_scan_resume(radio_h radio, radio_scan_updated_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SCAN_RESUME, __radio_scan_resume(radio, callback, user_data));
+}
+
+int radio_scan_incremental_start(radio_h radio, radio_scan_updated_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SCAN_INCREMENTAL_START, __radio_scan_incremental_start(radio, callback, user_data));
+}
+
+int radio_set_scan_threshold(radio_h radio, int strength)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_SCAN_THRESHOLD, __radio_set_scan_threshold(radio, strength));
+}
+
+int radio_set_predictive_seek(radio_h radio, bool enable)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_PREDICTIVE_SEEK, __radio_set_predictive_seek(radio, enable));
+}
+
+int radio_foreach_station(radio_h radio, radio_station_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_FOREACH_STATION, __radio_foreach_station(radio, callback, user_data));
+}
+
+int radio_get_station_count(radio_h radio, int *count)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_STATION_COUNT, __radio_get_station_count(radio, count));
+}
+
+int radio_clear_stations(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_CLEAR_STATIONS, __radio_clear_stations(radio));
+}
+
+int radio_set_mute(radio_h radio, bool muted)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_MUTE, __radio_set_mute(radio, muted));
+}
+
+int radio_is_muted(radio_h radio, bool *muted)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_IS_MUTED, __radio_is_muted(radio, muted));
+}
+
+int radio_set_scan_completed_cb(radio_h radio, radio_scan_completed_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_SCAN_COMPLETED_CB, __radio_set_scan_completed_cb(radio, callback, user_data));
+}
+
+int radio_unset_scan_completed_cb(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_UNSET_SCAN_COMPLETED_CB, __radio_unset_scan_completed_cb(radio));
+}
+
+int radio_set_scan_batch_cb(radio_h radio, int max_count, int max_latency_ms, radio_scan_batch_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_SCAN_BATCH_CB, __radio_set_scan_batch_cb(radio, max_count, max_latency_ms, callback, user_data));
+}
+
+int radio_unset_scan_batch_cb(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_UNSET_SCAN_BATCH_CB, __radio_unset_scan_batch_cb(radio));
+}
+
+int radio_set_interrupted_cb(radio_h radio, radio_interrupted_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_INTERRUPTED_CB, __radio_set_interrupted_cb(radio, callback, user_data));
+}
 
 int radio_unset_interrupted_cb(radio_h radio)
 {
-	return __unset_callback(_RADIO_EVENT_TYPE_INTERRUPT,radio);
+	RADIO_STATS_RETURN(_RADIO_STATS_UNSET_INTERRUPTED_CB, __radio_unset_interrupted_cb(radio));
+}
+
+int radio_set_signal_strength_changed_cb(radio_h radio, int interval_ms, int threshold, int hysteresis, int delta,
+	radio_signal_strength_changed_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_SIGNAL_STRENGTH_CHANGED_CB, __radio_set_signal_strength_changed_cb(radio, interval_ms, threshold, hysteresis, delta, callback, user_data));
+}
+
+int radio_unset_signal_strength_changed_cb(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_UNSET_SIGNAL_STRENGTH_CHANGED_CB, __radio_unset_signal_strength_changed_cb(radio));
+}
+
+int radio_dump_trace(radio_h radio, int fd)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_DUMP_TRACE, __radio_dump_trace(radio, fd));
+}
+
+int radio_set_frequency_async(radio_h radio, int frequency, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_FREQUENCY_ASYNC, __radio_set_frequency_async(radio, frequency, callback, user_data));
+}
+
+int radio_start_async(radio_h radio, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_START_ASYNC, __radio_start_async(radio, callback, user_data));
+}
+
+int radio_stop_async(radio_h radio, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_STOP_ASYNC, __radio_stop_async(radio, callback, user_data));
+}
+
+int radio_seek_up_async(radio_h radio, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SEEK_UP_ASYNC, __radio_seek_up_async(radio, callback, user_data));
+}
+
+int radio_seek_down_async(radio_h radio, radio_command_completed_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SEEK_DOWN_ASYNC, __radio_seek_down_async(radio, callback, user_data));
+}
+
+int radio_set_event_context(radio_h radio, GMainContext *context)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_EVENT_CONTEXT, __radio_set_event_context(radio, context));
+}
+
+int radio_get_event_fd(radio_h radio, int *fd)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_EVENT_FD, __radio_get_event_fd(radio, fd));
+}
+
+int radio_read_events(radio_h radio, radio_event_s *events, int max_count, int *count)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_READ_EVENTS, __radio_read_events(radio, events, max_count, count));
+}
+
+int radio_add_scan_updated_cb(radio_h radio, radio_scan_updated_cb callback, void *user_data, int *id)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_ADD_SCAN_UPDATED_CB, __radio_add_scan_updated_cb(radio, callback, user_data, id));
+}
+
+int radio_add_scan_completed_cb(radio_h radio, radio_scan_completed_cb callback, void *user_data, int *id)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_ADD_SCAN_COMPLETED_CB, __radio_add_scan_completed_cb(radio, callback, user_data, id));
+}
+
+int radio_add_interrupted_cb(radio_h radio, radio_interrupted_cb callback, void *user_data, int *id)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_ADD_INTERRUPTED_CB, __radio_add_interrupted_cb(radio, callback, user_data, id));
+}
+
+int radio_remove_cb(radio_h radio, int id)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_REMOVE_CB, __radio_remove_cb(radio, id));
+}
+
+int radio_set_idle_timeout(radio_h radio, int timeout_ms)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_IDLE_TIMEOUT, __radio_set_idle_timeout(radio, timeout_ms));
+}
+
+int radio_get_status(radio_h radio, radio_status_s *status)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_STATUS, __radio_get_status(radio, status));
+}
+
+int radio_set_alternate_frequencies(radio_h radio, const int *frequencies, int count)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_ALTERNATE_FREQUENCIES, __radio_set_alternate_frequencies(radio, frequencies, count));
+}
+
+int radio_set_alternate_frequency_cb(radio_h radio, int margin, int tuner_share, bool auto_switch,
+	radio_alternate_frequency_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_ALTERNATE_FREQUENCY_CB, __radio_set_alternate_frequency_cb(radio, margin, tuner_share, auto_switch, callback, user_data));
+}
+
+int radio_unset_alternate_frequency_cb(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_UNSET_ALTERNATE_FREQUENCY_CB, __radio_unset_alternate_frequency_cb(radio));
+}
+
+int radio_pcm_tap_start(radio_h radio, int period_frames, int period_count)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_PCM_TAP_START, __radio_pcm_tap_start(radio, period_frames, period_count));
+}
+
+int radio_pcm_tap_stop(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_PCM_TAP_STOP, __radio_pcm_tap_stop(radio));
+}
+
+int radio_pcm_tap_get_fd(radio_h radio, int *fd)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_PCM_TAP_GET_FD, __radio_pcm_tap_get_fd(radio, fd));
+}
+
+int radio_pcm_reader_create(radio_h radio, radio_pcm_reader_h *reader)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_PCM_READER_CREATE, __radio_pcm_reader_create(radio, reader));
+}
+
+int radio_timeshift_start(radio_h radio, const char *path, int seconds)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_TIMESHIFT_START, __radio_timeshift_start(radio, path, seconds));
+}
+
+int radio_timeshift_stop(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_TIMESHIFT_STOP, __radio_timeshift_stop(radio));
+}
+
+int radio_timeshift_pause(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_TIMESHIFT_PAUSE, __radio_timeshift_pause(radio, TRUE));
+}
+
+int radio_timeshift_resume(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_TIMESHIFT_RESUME, __radio_timeshift_pause(radio, FALSE));
+}
+
+int radio_timeshift_seek(radio_h radio, int delay_ms)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_TIMESHIFT_SEEK, __radio_timeshift_seek(radio, delay_ms));
+}
+
+int radio_timeshift_get_position(radio_h radio, int *delay_ms, int *buffered_ms)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_TIMESHIFT_GET_POSITION, __radio_timeshift_get_position(radio, delay_ms, buffered_ms));
+}
+
+int radio_timeshift_read(radio_h radio, short *frames, int frame_count, int *read_count)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_TIMESHIFT_READ, __radio_timeshift_read(radio, frames, frame_count, read_count));
+}
+
+int radio_recording_start(radio_h radio, const char *path, radio_recording_format_e format, int sample_rate)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_RECORDING_START, __radio_recording_start(radio, path, format, sample_rate));
+}
+
+int radio_recording_stop(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_RECORDING_STOP, __radio_recording_stop(radio));
+}
+
+int radio_recording_get_status(radio_h radio, radio_recording_status_s *status)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_RECORDING_GET_STATUS, __radio_recording_get_status(radio, status));
+}
+
+int radio_set_rds_changed_cb(radio_h radio, radio_rds_changed_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_SET_RDS_CHANGED_CB, __radio_set_rds_changed_cb(radio, callback, user_data));
+}
+
+int radio_unset_rds_changed_cb(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_UNSET_RDS_CHANGED_CB, __radio_unset_rds_changed_cb(radio));
+}
+
+int radio_get_rds_info(radio_h radio, int frequency, radio_rds_info_s *info)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_GET_RDS_INFO, __radio_get_rds_info(radio, frequency, info));
+}
+
+int radio_level_meter_start(radio_h radio, int interval_ms, int silence_level, radio_level_cb callback, void *user_data)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_LEVEL_METER_START, __radio_level_meter_start(radio, interval_ms, silence_level, callback, user_data));
+}
+
+int radio_level_meter_stop(radio_h radio)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_LEVEL_METER_STOP, __radio_level_meter_stop(radio));
+}
+
+int radio_level_meter_get(radio_h radio, radio_level_s *level)
+{
+	RADIO_STATS_RETURN(_RADIO_STATS_LEVEL_METER_GET, __radio_level_meter_get(radio, level));
 }
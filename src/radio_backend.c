@@ -0,0 +1,75 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <radio.h>
+#include <radio_backend_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+const _radio_backend_s _radio_backend_mm = {
+	.name = "mm-radio",
+	.create = mm_radio_create,
+	.destroy = mm_radio_destroy,
+	.realize = mm_radio_realize,
+	.unrealize = mm_radio_unrealize,
+	.set_message_callback = mm_radio_set_message_callback,
+	.get_state = mm_radio_get_state,
+	.start = mm_radio_start,
+	.stop = mm_radio_stop,
+	.seek = mm_radio_seek,
+	.set_frequency = mm_radio_set_frequency,
+	.get_frequency = mm_radio_get_frequency,
+	.scan_start = mm_radio_scan_start,
+	.scan_stop = mm_radio_scan_stop,
+	.set_mute = mm_radio_set_mute,
+	.get_signal_strength = mm_radio_get_signal_strength,
+	/* mm-radio routes the audio to the sound server itself, it is not exposed */
+	.get_pcm_format = NULL,
+	.read_pcm = NULL,
+	/* nor are the RDS blocks */
+	.read_rds = NULL,
+};
+
+#ifdef RADIO_BACKEND_MOCK
+static const _radio_backend_s *g_default_backend = &_radio_backend_mm;
+
+int _radio_backend_set_default(const _radio_backend_s *backend)
+{
+	if(backend == NULL)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	__atomic_store_n(&g_default_backend, backend, __ATOMIC_RELEASE);
+	LOGI("[%s] Default backend : %s",__FUNCTION__, backend->name);
+	return RADIO_ERROR_NONE;
+}
+
+const _radio_backend_s *_radio_backend_get_default(void)
+{
+	return __atomic_load_n(&g_default_backend, __ATOMIC_ACQUIRE);
+}
+#else
+const _radio_backend_s *_radio_backend_get_default(void)
+{
+	return &_radio_backend_mm;
+}
+#endif
@@ -0,0 +1,228 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <string.h>
+#include <pthread.h>
+#include <radio_dispatch_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+#define RADIO_DISPATCH_MASK			(_RADIO_DISPATCH_ENTRIES - 1)
+#define RADIO_DISPATCH_STATION_MASK	(_RADIO_DISPATCH_STATIONS - 1)
+
+typedef struct {
+	GSource source;
+	pthread_mutex_t lock;
+	_radio_dispatch_handler handler;
+	uint32_t head;				/* oldest entry */
+	uint32_t count;
+	uint32_t dropped;			/* entries lost to a full queue since the last dispatch */
+	_radio_dispatch_entry_s entries[_RADIO_DISPATCH_ENTRIES];
+	uint32_t station_head;
+	uint32_t station_count;
+	radio_station_s stations[_RADIO_DISPATCH_STATIONS];
+	radio_station_s batch[_RADIO_STATION_CACHE_MAX];	/* stations of the entry being dispatched */
+}_radio_dispatch_source_s;
+
+static gboolean __dispatch_prepare(GSource *source, gint *timeout)
+{
+	_radio_dispatch_source_s *dispatch = (_radio_dispatch_source_s *)source;
+	*timeout = -1;
+	return __atomic_load_n(&dispatch->count, __ATOMIC_ACQUIRE) > 0;
+}
+
+static gboolean __dispatch_check(GSource *source)
+{
+	_radio_dispatch_source_s *dispatch = (_radio_dispatch_source_s *)source;
+	return __atomic_load_n(&dispatch->count, __ATOMIC_ACQUIRE) > 0;
+}
+
+/* Dispatches the entries queued so far, the ones queued by the callbacks wait for the next iteration */
+static gboolean __dispatch_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
+{
+	_radio_dispatch_source_s *dispatch = (_radio_dispatch_source_s *)source;
+	_radio_dispatch_entry_s entry;
+	uint32_t budget, dropped, i;
+
+	pthread_mutex_lock(&dispatch->lock);
+	budget = dispatch->count;
+	dropped = dispatch->dropped;
+	dispatch->dropped = 0;
+	pthread_mutex_unlock(&dispatch->lock);
+	if(dropped > 0)
+	{
+		LOGW("[%s] %u events dropped, the context does not keep up" ,__FUNCTION__, dropped);
+	}
+
+	while(budget-- > 0 && !g_source_is_destroyed(source))
+	{
+		pthread_mutex_lock(&dispatch->lock);
+		if(dispatch->count == 0)
+		{
+			pthread_mutex_unlock(&dispatch->lock);
+			break;
+		}
+		entry = dispatch->entries[dispatch->head];
+		dispatch->head = (dispatch->head + 1) & RADIO_DISPATCH_MASK;
+		__atomic_store_n(&dispatch->count, dispatch->count - 1, __ATOMIC_RELEASE);
+		for(i = 0; i < (uint32_t)entry.station_count; i++)
+			dispatch->batch[i] = dispatch->stations[(dispatch->station_head + i) & RADIO_DISPATCH_STATION_MASK];
+		dispatch->station_head = (dispatch->station_head + entry.station_count) & RADIO_DISPATCH_STATION_MASK;
+		dispatch->station_count -= entry.station_count;
+		pthread_mutex_unlock(&dispatch->lock);
+
+		if(entry.event != _RADIO_DISPATCH_NONE)
+			dispatch->handler(&entry, dispatch->batch);
+	}
+	return G_SOURCE_CONTINUE;
+}
+
+static void __dispatch_finalize(GSource *source)
+{
+	_radio_dispatch_source_s *dispatch = (_radio_dispatch_source_s *)source;
+	pthread_mutex_destroy(&dispatch->lock);
+}
+
+static GSourceFuncs __dispatch_funcs = {
+	__dispatch_prepare,
+	__dispatch_check,
+	__dispatch_dispatch,
+	__dispatch_finalize,
+};
+
+/* Queues a new entry, called with the lock held */
+static _radio_dispatch_entry_s *__dispatch_append(_radio_dispatch_source_s *dispatch)
+{
+	_radio_dispatch_entry_s *entry;
+
+	if(dispatch->count == _RADIO_DISPATCH_ENTRIES)
+	{
+		dispatch->dropped++;
+		return NULL;
+	}
+	entry = &dispatch->entries[(dispatch->head + dispatch->count) & RADIO_DISPATCH_MASK];
+	__atomic_store_n(&dispatch->count, dispatch->count + 1, __ATOMIC_RELEASE);
+	if(dispatch->count == 1)
+		g_main_context_wakeup(g_source_get_context(&dispatch->source));
+	return entry;
+}
+
+static _radio_dispatch_entry_s *__dispatch_tail(_radio_dispatch_source_s *dispatch)
+{
+	if(dispatch->count == 0)
+		return NULL;
+	return &dispatch->entries[(dispatch->head + dispatch->count - 1) & RADIO_DISPATCH_MASK];
+}
+
+GSource *_radio_dispatch_create(GMainContext *context, _radio_dispatch_handler handler)
+{
+	GSource *source = g_source_new(&__dispatch_funcs, sizeof(_radio_dispatch_source_s));
+	_radio_dispatch_source_s *dispatch = (_radio_dispatch_source_s *)source;
+
+	pthread_mutex_init(&dispatch->lock, NULL);
+	dispatch->handler = handler;
+	g_source_attach(source, context);
+	return source;
+}
+
+void _radio_dispatch_destroy(GSource *source)
+{
+	g_source_destroy(source);
+	g_source_unref(source);
+}
+
+bool _radio_dispatch_push(GSource *source, const _radio_dispatch_entry_s *entry)
+{
+	_radio_dispatch_source_s *dispatch = (_radio_dispatch_source_s *)source;
+	_radio_dispatch_entry_s *slot;
+
+	pthread_mutex_lock(&dispatch->lock);
+	slot = __dispatch_tail(dispatch);
+	if(entry->coalesce && slot != NULL && slot->coalesce && slot->event == entry->event
+		&& slot->callback == entry->callback && slot->user_data == entry->user_data)
+	{
+		memcpy(slot->args, entry->args, sizeof(slot->args));
+		pthread_mutex_unlock(&dispatch->lock);
+		return true;
+	}
+	slot = __dispatch_append(dispatch);
+	if(slot != NULL)
+	{
+		*slot = *entry;
+		slot->station_count = 0;
+	}
+	pthread_mutex_unlock(&dispatch->lock);
+	return slot != NULL;
+}
+
+bool _radio_dispatch_push_stations(GSource *source, const void *callback, void *user_data, const radio_station_s *stations, int count)
+{
+	_radio_dispatch_source_s *dispatch = (_radio_dispatch_source_s *)source;
+	_radio_dispatch_entry_s *slot;
+	int i;
+
+	pthread_mutex_lock(&dispatch->lock);
+	if(dispatch->station_count + count > _RADIO_DISPATCH_STATIONS)
+	{
+		dispatch->dropped++;
+		pthread_mutex_unlock(&dispatch->lock);
+		return false;
+	}
+	slot = __dispatch_tail(dispatch);
+	if(slot == NULL || slot->event != _RADIO_DISPATCH_SCAN_BATCH || slot->callback != callback || slot->user_data != user_data
+		|| slot->station_count + count > _RADIO_STATION_CACHE_MAX)
+	{
+		slot = __dispatch_append(dispatch);
+		if(slot == NULL)
+		{
+			pthread_mutex_unlock(&dispatch->lock);
+			return false;
+		}
+		memset(slot, 0, sizeof(*slot));
+		slot->event = _RADIO_DISPATCH_SCAN_BATCH;
+		slot->callback = callback;
+		slot->user_data = user_data;
+	}
+	for(i = 0; i < count; i++)
+		dispatch->stations[(dispatch->station_head + dispatch->station_count + i) & RADIO_DISPATCH_STATION_MASK] = stations[i];
+	dispatch->station_count += count;
+	slot->station_count += count;
+	pthread_mutex_unlock(&dispatch->lock);
+	return true;
+}
+
+void _radio_dispatch_purge(GSource *source, _radio_dispatch_event_e event, const void *callback, void *user_data)
+{
+	_radio_dispatch_source_s *dispatch = (_radio_dispatch_source_s *)source;
+	_radio_dispatch_entry_s *entry;
+	uint32_t i;
+
+	pthread_mutex_lock(&dispatch->lock);
+	for(i = 0; i < dispatch->count; i++)
+	{
+		entry = &dispatch->entries[(dispatch->head + i) & RADIO_DISPATCH_MASK];
+		if(entry->event == event && entry->callback == callback && entry->user_data == user_data)
+		{
+			entry->event = _RADIO_DISPATCH_NONE;
+			entry->coalesce = false;
+		}
+	}
+	pthread_mutex_unlock(&dispatch->lock);
+}
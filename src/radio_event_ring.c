@@ -0,0 +1,175 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <radio_event_ring_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+#define RADIO_EVENT_RING_MASK	(_RADIO_EVENT_RING_ENTRIES - 1)
+
+/* Makes the eventfd readable, unless it already is */
+static void __event_ring_signal(_radio_event_ring_s *ring, int fd)
+{
+	uint64_t one = 1;
+
+	if(__atomic_exchange_n(&ring->signaled, 1, __ATOMIC_SEQ_CST))
+		return;
+	while(write(fd, &one, sizeof(one)) < 0 && errno == EINTR)
+		;
+}
+
+void _radio_event_ring_init(_radio_event_ring_s *ring)
+{
+	int i;
+
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = -1;
+	for(i = 0; i < _RADIO_EVENT_RING_ENTRIES; i++)
+		ring->cells[i].seq = i;
+}
+
+int _radio_event_ring_open(_radio_event_ring_s *ring, int *fd)
+{
+	int expected = -1;
+	int created;
+
+	*fd = __atomic_load_n(&ring->fd, __ATOMIC_ACQUIRE);
+	if(*fd >= 0)
+		return RADIO_ERROR_NONE;
+
+	created = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(created < 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create eventfd (%d)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, errno);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	if(!__atomic_compare_exchange_n(&ring->fd, &expected, created, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+	{
+		/* opened by another thread in the meantime */
+		close(created);
+		created = expected;
+	}
+	*fd = created;
+	return RADIO_ERROR_NONE;
+}
+
+void _radio_event_ring_close(_radio_event_ring_s *ring)
+{
+	int fd = __atomic_exchange_n(&ring->fd, -1, __ATOMIC_ACQ_REL);
+	if(fd >= 0)
+		close(fd);
+}
+
+void _radio_event_ring_post(_radio_event_ring_s *ring, radio_event_e type, int value, uint64_t timestamp)
+{
+	int fd = __atomic_load_n(&ring->fd, __ATOMIC_ACQUIRE);
+	_radio_event_cell_s *cell;
+	uint32_t pos, seq;
+
+	if(fd < 0)
+		return;
+	pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	while(1)
+	{
+		cell = &ring->cells[pos & RADIO_EVENT_RING_MASK];
+		seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		if(seq == pos)
+		{
+			if(__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		}
+		else if((int32_t)(seq - pos) < 0)
+		{
+			/* full, the reader has been woken up already */
+			__atomic_add_fetch(&ring->overflow, 1, __ATOMIC_RELAXED);
+			return;
+		}
+		else
+		{
+			pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+		}
+	}
+	cell->event.type = type;
+	cell->event.value = value;
+	cell->event.timestamp = timestamp;
+	__atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+	__event_ring_signal(ring, fd);
+}
+
+int _radio_event_ring_read(_radio_event_ring_s *ring, radio_event_s *events, int max_count)
+{
+	int fd = __atomic_load_n(&ring->fd, __ATOMIC_ACQUIRE);
+	_radio_event_cell_s *cell;
+	struct timespec ts;
+	uint32_t pos, seq, overflow;
+	uint64_t value;
+	int count = 0;
+
+	if(fd < 0)
+		return 0;
+	/* events posted from now on make the descriptor readable again */
+	while(read(fd, &value, sizeof(value)) < 0 && errno == EINTR)
+		;
+	__atomic_store_n(&ring->signaled, 0, __ATOMIC_SEQ_CST);
+
+	overflow = __atomic_exchange_n(&ring->overflow, 0, __ATOMIC_RELAXED);
+	if(overflow > 0 && max_count > 0)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		events[count].type = RADIO_EVENT_OVERFLOW;
+		events[count].value = overflow;
+		events[count].timestamp = (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+		count++;
+	}
+
+	pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	while(count < max_count)
+	{
+		cell = &ring->cells[pos & RADIO_EVENT_RING_MASK];
+		seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		if(seq == pos + 1)
+		{
+			if(__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				events[count++] = cell->event;
+				__atomic_store_n(&cell->seq, pos + _RADIO_EVENT_RING_ENTRIES, __ATOMIC_RELEASE);
+				pos++;
+			}
+		}
+		else if((int32_t)(seq - (pos + 1)) < 0)
+		{
+			break;
+		}
+		else
+		{
+			pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+		}
+	}
+
+	/* events left behind keep the descriptor readable */
+	if(__atomic_load_n(&ring->head, __ATOMIC_RELAXED) != __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE))
+		__event_ring_signal(ring, fd);
+	return count;
+}
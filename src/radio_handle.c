@@ -0,0 +1,107 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+#include <radio_handle_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+#define RADIO_HANDLE_INDEX_BITS	8
+#define RADIO_HANDLE_INDEX_MASK	((1u << RADIO_HANDLE_INDEX_BITS) - 1)
+
+typedef struct {
+	uint32_t generation;	/* odd while the handle is alive */
+	bool used;				/* reserved, from _radio_handle_acquire() to _radio_handle_release() */
+	radio_s handle;
+}_radio_handle_slot_s;
+
+static _radio_handle_slot_s __slots[_RADIO_HANDLE_MAX];
+static pthread_mutex_t __slots_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* index + 1 so that no token is NULL, the generation is truncated to the remaining bits */
+static radio_h __handle_token(uint32_t index, uint32_t generation)
+{
+	return (radio_h)(((uintptr_t)generation << RADIO_HANDLE_INDEX_BITS) | (index + 1));
+}
+
+static _radio_handle_slot_s *__handle_slot(radio_s *handle)
+{
+	return (_radio_handle_slot_s *)((char *)handle - offsetof(_radio_handle_slot_s, handle));
+}
+
+radio_s *_radio_handle_acquire(void)
+{
+	_radio_handle_slot_s *slot = NULL;
+	uint32_t i;
+
+	pthread_mutex_lock(&__slots_lock);
+	for(i = 0; i < _RADIO_HANDLE_MAX; i++)
+	{
+		if(!__slots[i].used)
+		{
+			slot = &__slots[i];
+			break;
+		}
+	}
+	if(slot == NULL)
+	{
+		pthread_mutex_unlock(&__slots_lock);
+		LOGE("[%s] All the %d radio handles are in use" ,__FUNCTION__, _RADIO_HANDLE_MAX);
+		return NULL;
+	}
+	slot->used = true;
+	memset(&slot->handle, 0, sizeof(radio_s));
+	slot->handle.self = __handle_token(i, slot->generation + 1);
+	__atomic_store_n(&slot->generation, slot->generation + 1, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&__slots_lock);
+	return &slot->handle;
+}
+
+void _radio_handle_invalidate(radio_s *handle)
+{
+	_radio_handle_slot_s *slot = __handle_slot(handle);
+	if(__atomic_load_n(&slot->generation, __ATOMIC_RELAXED) & 1)
+		__atomic_add_fetch(&slot->generation, 1, __ATOMIC_RELEASE);
+}
+
+void _radio_handle_release(radio_s *handle)
+{
+	_radio_handle_slot_s *slot = __handle_slot(handle);
+
+	_radio_handle_invalidate(handle);
+	pthread_mutex_lock(&__slots_lock);
+	slot->used = false;
+	pthread_mutex_unlock(&__slots_lock);
+}
+
+radio_s *_radio_handle_get(radio_h radio)
+{
+	uint32_t index = ((uintptr_t)radio & RADIO_HANDLE_INDEX_MASK) - 1;
+	uint32_t generation;
+
+	if(index >= _RADIO_HANDLE_MAX)
+		return NULL;
+	generation = __atomic_load_n(&__slots[index].generation, __ATOMIC_ACQUIRE);
+	if(!(generation & 1) || __handle_token(index, generation) != radio)
+		return NULL;
+	return &__slots[index].handle;
+}
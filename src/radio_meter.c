@@ -0,0 +1,385 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <string.h>
+#include <radio_meter_private.h>
+#include <dlog.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RADIO_METER_NEON
+#endif
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+/* time the thread waits for a period before it looks at quit again */
+#define RADIO_METER_POLL_MS		100
+
+static int __meter_magnitude(int16_t sample)
+{
+	int magnitude = sample < 0 ? -sample : sample;
+	return magnitude > _RADIO_METER_LEVEL_MAX ? _RADIO_METER_LEVEL_MAX : magnitude;
+}
+
+/* Index of the last sample of samples[0, count) above level, -1 when there is none */
+static int __meter_last_loud_scalar(const int16_t *samples, int count, int level)
+{
+	while(--count >= 0)
+	{
+		if(__meter_magnitude(samples[count]) > level)
+			break;
+	}
+	return count;
+}
+
+void _radio_meter_scan_scalar(const int16_t *samples, int count, int silence_level, _radio_meter_block_s *block)
+{
+	uint64_t energy = 0;
+	int peak = 0;
+	int i, magnitude;
+
+	for(i = 0; i < count; i++)
+	{
+		magnitude = __meter_magnitude(samples[i]);
+		if(magnitude > peak)
+			peak = magnitude;
+		energy += (uint32_t)(magnitude * magnitude);
+	}
+	block->peak = peak;
+	block->energy = energy;
+	block->silent_tail = count - 1 - __meter_last_loud_scalar(samples, count, silence_level);
+}
+
+#if defined(__SSE2__)
+/*
+* 8 samples a step. The magnitude saturates, so that the products of a pair of them add up below 2^31 and the sums
+* of _mm_madd_epi16() can be widened to 64 bits as they are.
+*/
+void _radio_meter_scan(const int16_t *samples, int count, int silence_level, _radio_meter_block_s *block)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i level = _mm_set1_epi16((int16_t)silence_level);
+	__m128i peak = zero, energy = zero;
+	__m128i value, magnitude, squares;
+	int16_t lanes[8];
+	int vectors = count & ~7;
+	int i, mask, last, sample_magnitude;
+
+	for(i = 0; i < vectors; i += 8)
+	{
+		value = _mm_loadu_si128((const __m128i *)(samples + i));
+		magnitude = _mm_max_epi16(value, _mm_subs_epi16(zero, value));
+		peak = _mm_max_epi16(peak, magnitude);
+		squares = _mm_madd_epi16(magnitude, magnitude);
+		energy = _mm_add_epi64(energy, _mm_unpacklo_epi32(squares, zero));
+		energy = _mm_add_epi64(energy, _mm_unpackhi_epi32(squares, zero));
+	}
+	peak = _mm_max_epi16(peak, _mm_srli_si128(peak, 8));
+	peak = _mm_max_epi16(peak, _mm_srli_si128(peak, 4));
+	peak = _mm_max_epi16(peak, _mm_srli_si128(peak, 2));
+	energy = _mm_add_epi64(energy, _mm_srli_si128(energy, 8));
+	_mm_storeu_si128((__m128i *)lanes, peak);
+	block->peak = lanes[0];
+	_mm_storel_epi64((__m128i *)&block->energy, energy);
+	for(; i < count; i++)
+	{
+		sample_magnitude = __meter_magnitude(samples[i]);
+		if(sample_magnitude > block->peak)
+			block->peak = sample_magnitude;
+		block->energy += (uint32_t)(sample_magnitude * sample_magnitude);
+	}
+
+	/* the silence at the end, from the end : it stops at the first loud step */
+	last = __meter_last_loud_scalar(samples + vectors, count - vectors, silence_level);
+	if(last >= 0)
+	{
+		block->silent_tail = count - 1 - (vectors + last);
+		return;
+	}
+	for(i = vectors - 8; i >= 0; i -= 8)
+	{
+		value = _mm_loadu_si128((const __m128i *)(samples + i));
+		magnitude = _mm_max_epi16(value, _mm_subs_epi16(zero, value));
+		mask = _mm_movemask_epi8(_mm_cmpgt_epi16(magnitude, level));
+		if(mask != 0)
+		{
+			/* two bits of the mask per sample */
+			block->silent_tail = count - 1 - (i + (31 - __builtin_clz(mask)) / 2);
+			return;
+		}
+	}
+	block->silent_tail = count;
+}
+#elif defined(RADIO_METER_NEON)
+/* 8 samples a step, the squares of the saturated magnitudes are widened to 64 bits by the pairwise additions */
+void _radio_meter_scan(const int16_t *samples, int count, int silence_level, _radio_meter_block_s *block)
+{
+	const int16x8_t level = vdupq_n_s16((int16_t)silence_level);
+	int16x8_t peak = vdupq_n_s16(0);
+	uint64x2_t energy = vdupq_n_u64(0);
+	int16x8_t magnitude;
+	int16x4_t peak4;
+	uint16x8_t loud;
+	uint16x4_t loud4;
+	int vectors = count & ~7;
+	int i, lane, last, sample_magnitude;
+
+	for(i = 0; i < vectors; i += 8)
+	{
+		magnitude = vqabsq_s16(vld1q_s16(samples + i));
+		peak = vmaxq_s16(peak, magnitude);
+		energy = vpadalq_u32(energy, vreinterpretq_u32_s32(vmull_s16(vget_low_s16(magnitude), vget_low_s16(magnitude))));
+		energy = vpadalq_u32(energy, vreinterpretq_u32_s32(vmull_s16(vget_high_s16(magnitude), vget_high_s16(magnitude))));
+	}
+	peak4 = vmax_s16(vget_low_s16(peak), vget_high_s16(peak));
+	peak4 = vpmax_s16(peak4, peak4);
+	peak4 = vpmax_s16(peak4, peak4);
+	block->peak = vget_lane_s16(peak4, 0);
+	block->energy = vgetq_lane_u64(energy, 0) + vgetq_lane_u64(energy, 1);
+	for(; i < count; i++)
+	{
+		sample_magnitude = __meter_magnitude(samples[i]);
+		if(sample_magnitude > block->peak)
+			block->peak = sample_magnitude;
+		block->energy += (uint32_t)(sample_magnitude * sample_magnitude);
+	}
+
+	/* the silence at the end, from the end : it stops at the first loud step */
+	last = __meter_last_loud_scalar(samples + vectors, count - vectors, silence_level);
+	if(last >= 0)
+	{
+		block->silent_tail = count - 1 - (vectors + last);
+		return;
+	}
+	for(i = vectors - 8; i >= 0; i -= 8)
+	{
+		magnitude = vqabsq_s16(vld1q_s16(samples + i));
+		loud = vcgtq_s16(magnitude, level);
+		loud4 = vorr_u16(vget_low_u16(loud), vget_high_u16(loud));
+		if(vget_lane_u64(vreinterpret_u64_u16(loud4), 0) != 0)
+		{
+			for(lane = 7; __meter_magnitude(samples[i + lane]) <= silence_level; lane--)
+				;
+			block->silent_tail = count - 1 - (i + lane);
+			return;
+		}
+	}
+	block->silent_tail = count;
+}
+#else
+void _radio_meter_scan(const int16_t *samples, int count, int silence_level, _radio_meter_block_s *block)
+{
+	_radio_meter_scan_scalar(samples, count, silence_level, block);
+}
+#endif
+
+static unsigned int __meter_sqrt(uint64_t value)
+{
+	uint64_t root = 0, bit = 1ULL << 62;
+
+	while(bit > value)
+		bit >>= 2;
+	while(bit != 0)
+	{
+		if(value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (unsigned int)root;
+}
+
+/* Single writer : the thread while it runs, start and stop otherwise */
+static void __meter_publish(_radio_meter_s *meter, const radio_level_s *level)
+{
+	uint32_t seq = meter->seq;
+
+	__atomic_store_n(&meter->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&meter->level.running, level->running, __ATOMIC_RELAXED);
+	__atomic_store_n(&meter->level.peak, level->peak, __ATOMIC_RELAXED);
+	__atomic_store_n(&meter->level.rms, level->rms, __ATOMIC_RELAXED);
+	__atomic_store_n(&meter->level.silence_ms, level->silence_ms, __ATOMIC_RELAXED);
+	__atomic_store_n(&meter->level.windows, level->windows, __ATOMIC_RELAXED);
+	__atomic_store_n(&meter->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static void __meter_add(_radio_meter_s *meter, const _radio_meter_block_s *block, int frame_count)
+{
+	int samples = frame_count * meter->channels;
+	radio_level_s level;
+
+	if(block->peak > meter->peak)
+		meter->peak = block->peak;
+	meter->energy += block->energy;
+	if(block->silent_tail == samples)
+		meter->silent_samples += samples;
+	else
+		meter->silent_samples = block->silent_tail;
+	meter->frames += frame_count;
+	if(meter->frames < meter->window_frames)
+		return;
+
+	/* a period ends on a frame, so are the silent frames the silent samples of whole frames */
+	level.running = true;
+	level.peak = meter->peak;
+	level.rms = __meter_sqrt(meter->energy / ((uint64_t)meter->frames * meter->channels));
+	level.silence_ms = (int)(meter->silent_samples / meter->channels * 1000 / meter->sample_rate);
+	level.windows = meter->level.windows + 1;
+	__meter_publish(meter, &level);
+	meter->frames = 0;
+	meter->peak = 0;
+	meter->energy = 0;
+	if(meter->callback != NULL)
+		meter->notify(meter->notify_data, meter->callback, meter->user_data, &level);
+}
+
+static void *__meter_thread(void *data)
+{
+	_radio_meter_s *meter = (_radio_meter_s *)data;
+	_radio_meter_block_s block;
+	radio_pcm_period_s period;
+	bool overrun;
+	int ret;
+
+	while(!__atomic_load_n(&meter->quit, __ATOMIC_ACQUIRE))
+	{
+		ret = radio_pcm_reader_acquire(meter->reader, RADIO_METER_POLL_MS, &period);
+		if(ret == RADIO_ERROR_INVALID_OPERATION)
+			continue;
+		if(ret != RADIO_ERROR_NONE)
+		{
+			LOGW("[%s] The audio tap was stopped, the level meter ends" ,__FUNCTION__);
+			break;
+		}
+		_radio_meter_scan(period.frames, period.frame_count * meter->channels, meter->silence_level, &block);
+		radio_pcm_reader_release(meter->reader, &overrun);
+		/* the frames were overwritten while they were measured */
+		if(!overrun)
+			__meter_add(meter, &block, period.frame_count);
+	}
+	return NULL;
+}
+
+void _radio_meter_init(_radio_meter_s *meter)
+{
+	memset(meter, 0, sizeof(*meter));
+	pthread_mutex_init(&meter->lock, NULL);
+}
+
+void _radio_meter_deinit(_radio_meter_s *meter)
+{
+	_radio_meter_stop(meter);
+	pthread_mutex_destroy(&meter->lock);
+}
+
+int _radio_meter_start(_radio_meter_s *meter, radio_pcm_reader_h reader, int interval_ms, int silence_level,
+	radio_level_cb callback, void *user_data, _radio_meter_notify notify, void *notify_data)
+{
+	radio_level_s level;
+	int period_frames;
+
+	pthread_mutex_lock(&meter->lock);
+	if(meter->running)
+	{
+		pthread_mutex_unlock(&meter->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : The level meter is running" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		return RADIO_ERROR_INVALID_STATE;
+	}
+	radio_pcm_reader_get_format(reader, &meter->sample_rate, &meter->channels, &period_frames);
+	meter->reader = reader;
+	meter->callback = callback;
+	meter->user_data = user_data;
+	meter->notify = notify;
+	meter->notify_data = notify_data;
+	meter->silence_level = silence_level;
+	meter->window_frames = (int)((int64_t)meter->sample_rate * interval_ms / 1000);
+	meter->frames = 0;
+	meter->peak = 0;
+	meter->energy = 0;
+	meter->silent_samples = 0;
+	meter->quit = false;
+	memset(&level, 0, sizeof(level));
+	level.running = true;
+	__meter_publish(meter, &level);
+	if(pthread_create(&meter->thread, NULL, __meter_thread, meter) != 0)
+	{
+		level.running = false;
+		__meter_publish(meter, &level);
+		meter->reader = NULL;
+		pthread_mutex_unlock(&meter->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create the level meter thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	meter->running = true;
+	pthread_mutex_unlock(&meter->lock);
+	LOGI("[%s] Metering windows of %d frames, silence at %d" ,__FUNCTION__, meter->window_frames, silence_level);
+	return RADIO_ERROR_NONE;
+}
+
+void _radio_meter_stop(_radio_meter_s *meter)
+{
+	radio_level_s level;
+
+	pthread_mutex_lock(&meter->lock);
+	if(!meter->running)
+	{
+		pthread_mutex_unlock(&meter->lock);
+		return;
+	}
+	meter->running = false;
+	__atomic_store_n(&meter->quit, true, __ATOMIC_RELEASE);
+	pthread_join(meter->thread, NULL);
+
+	/* the last window is kept */
+	level = meter->level;
+	level.running = false;
+	__meter_publish(meter, &level);
+	radio_pcm_reader_destroy(meter->reader);
+	meter->reader = NULL;
+	pthread_mutex_unlock(&meter->lock);
+}
+
+void _radio_meter_get(_radio_meter_s *meter, radio_level_s *level)
+{
+	uint32_t seq;
+
+	while(1)
+	{
+		seq = __atomic_load_n(&meter->seq, __ATOMIC_ACQUIRE);
+		if(seq & 1)
+			continue;
+		level->running = __atomic_load_n(&meter->level.running, __ATOMIC_RELAXED);
+		level->peak = __atomic_load_n(&meter->level.peak, __ATOMIC_RELAXED);
+		level->rms = __atomic_load_n(&meter->level.rms, __ATOMIC_RELAXED);
+		level->silence_ms = __atomic_load_n(&meter->level.silence_ms, __ATOMIC_RELAXED);
+		level->windows = __atomic_load_n(&meter->level.windows, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&meter->seq, __ATOMIC_RELAXED) == seq)
+			return;
+	}
+}
@@ -0,0 +1,369 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <radio_pcm_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+#define RADIO_PCM_ALIGN(size)	(((size) + 63) & ~(size_t)63)
+
+/*
+* The readers are not counted in the statistics : radio_pcm_reader_acquire() is called once per period
+* and mostly measures how long it waits for the capture.
+*/
+struct radio_pcm_reader_s {
+	bool used;			/* reserved, from radio_pcm_reader_create_from_fd() to radio_pcm_reader_destroy() */
+	int fd;
+	size_t size;
+	_radio_pcm_header_s *header;
+	uint64_t next;		/* sequence of the next period to read */
+	bool holding;		/* the period next - 1 was acquired and not released yet */
+	int lost;			/* periods skipped since the last acquired one */
+};
+
+/* the readers of the process, so that creating one never touches the heap */
+static struct radio_pcm_reader_s __readers[_RADIO_PCM_READERS_MAX];
+static pthread_mutex_t __readers_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct radio_pcm_reader_s *__pcm_reader_acquire(void)
+{
+	struct radio_pcm_reader_s *pcm = NULL;
+	int i;
+
+	pthread_mutex_lock(&__readers_lock);
+	for(i = 0; i < _RADIO_PCM_READERS_MAX; i++)
+	{
+		if(!__readers[i].used)
+		{
+			pcm = &__readers[i];
+			memset(pcm, 0, sizeof(*pcm));
+			pcm->used = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&__readers_lock);
+	return pcm;
+}
+
+static void __pcm_reader_release(struct radio_pcm_reader_s *pcm)
+{
+	pthread_mutex_lock(&__readers_lock);
+	pcm->used = false;
+	pthread_mutex_unlock(&__readers_lock);
+}
+
+static _radio_pcm_period_s *__pcm_period(_radio_pcm_header_s *header, uint64_t seq)
+{
+	return (_radio_pcm_period_s *)((char *)header + sizeof(_radio_pcm_header_s)
+		+ (size_t)(seq & (header->period_count - 1)) * header->period_stride);
+}
+
+static size_t __pcm_size(int channels, int period_frames, int period_count, uint32_t *stride)
+{
+	*stride = RADIO_PCM_ALIGN(sizeof(_radio_pcm_period_s) + sizeof(int16_t) * channels * period_frames);
+	return sizeof(_radio_pcm_header_s) + (size_t)*stride * period_count;
+}
+
+static void __pcm_wake(_radio_pcm_header_s *header)
+{
+	__atomic_add_fetch(&header->wake, 1, __ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&header->waiters, __ATOMIC_SEQ_CST) > 0)
+		syscall(SYS_futex, &header->wake, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+void _radio_pcm_ring_init(_radio_pcm_ring_s *ring)
+{
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = -1;
+}
+
+int _radio_pcm_ring_open(_radio_pcm_ring_s *ring, int sample_rate, int channels, int period_frames, int period_count)
+{
+	static uint32_t serial;
+	_radio_pcm_header_s *header;
+	char name[64];
+	uint32_t stride;
+	size_t size = __pcm_size(channels, period_frames, period_count, &stride);
+	int fd;
+
+	/* the name only lives until shm_unlink(), the memory is reached through the descriptor */
+	snprintf(name, sizeof(name), "/radio-pcm-%d-%u", (int)getpid(), __atomic_add_fetch(&serial, 1, __ATOMIC_RELAXED));
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if(fd < 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create the shared memory (%d)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, errno);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	shm_unlink(name);
+	if(ftruncate(fd, size) != 0)
+	{
+		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x) : Failed to size the shared memory to %zu bytes (%d)" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY, size, errno);
+		close(fd);
+		return RADIO_ERROR_OUT_OF_MEMORY;
+	}
+	header = (_radio_pcm_header_s *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(header == MAP_FAILED)
+	{
+		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x) : Failed to map the shared memory (%d)" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY, errno);
+		close(fd);
+		return RADIO_ERROR_OUT_OF_MEMORY;
+	}
+
+	/* ftruncate() zeroed the memory, every period starts unwritten */
+	header->sample_rate = sample_rate;
+	header->channels = channels;
+	header->period_frames = period_frames;
+	header->period_count = period_count;
+	header->period_stride = stride;
+	__atomic_store_n(&header->magic, _RADIO_PCM_MAGIC, __ATOMIC_RELEASE);
+
+	ring->fd = fd;
+	ring->size = size;
+	ring->header = header;
+	ring->writing = 0;
+	return RADIO_ERROR_NONE;
+}
+
+void _radio_pcm_ring_close(_radio_pcm_ring_s *ring)
+{
+	if(ring->header == NULL)
+		return;
+	__atomic_store_n(&ring->header->closed, 1, __ATOMIC_RELEASE);
+	__pcm_wake(ring->header);
+	munmap(ring->header, ring->size);
+	close(ring->fd);
+	_radio_pcm_ring_init(ring);
+}
+
+int16_t *_radio_pcm_ring_begin(_radio_pcm_ring_s *ring)
+{
+	_radio_pcm_period_s *period = __pcm_period(ring->header, ring->writing);
+
+	/* readers of the sequence held so far see it change before any frame is overwritten */
+	__atomic_store_n(&period->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	return period->frames;
+}
+
+void _radio_pcm_ring_commit(_radio_pcm_ring_s *ring, uint64_t timestamp)
+{
+	_radio_pcm_period_s *period = __pcm_period(ring->header, ring->writing);
+
+	period->timestamp = timestamp;
+	__atomic_store_n(&period->seq, ring->writing + 1, __ATOMIC_RELEASE);
+	ring->writing++;
+	__atomic_store_n(&ring->header->write_seq, ring->writing, __ATOMIC_RELEASE);
+	__pcm_wake(ring->header);
+}
+
+int radio_pcm_reader_create_from_fd(int fd, radio_pcm_reader_h *reader)
+{
+	struct radio_pcm_reader_s *pcm;
+	_radio_pcm_header_s *header;
+	struct stat st;
+	uint32_t stride;
+	int dup_fd;
+
+	if(reader == NULL || fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(_radio_pcm_header_s))
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	header = (_radio_pcm_header_s *)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(header == MAP_FAILED)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Failed to map the descriptor (%d)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, errno);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	if(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != _RADIO_PCM_MAGIC
+		|| header->channels == 0 || header->period_frames == 0 || header->period_frames > _RADIO_PCM_PERIOD_FRAMES_MAX
+		|| header->period_count < 2 || header->period_count > _RADIO_PCM_PERIOD_COUNT_MAX
+		|| (header->period_count & (header->period_count - 1)) != 0
+		|| __pcm_size(header->channels, header->period_frames, header->period_count, &stride) != (size_t)st.st_size
+		|| stride != header->period_stride)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Not the descriptor of an audio tap" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		munmap(header, st.st_size);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+
+	pcm = __pcm_reader_acquire();
+	dup_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+	if(pcm == NULL || dup_fd < 0)
+	{
+		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x) : %s" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY,
+			pcm == NULL ? "All the readers are in use" : "Failed to duplicate the descriptor");
+		if(pcm != NULL)
+			__pcm_reader_release(pcm);
+		if(dup_fd >= 0)
+			close(dup_fd);
+		munmap(header, st.st_size);
+		return RADIO_ERROR_OUT_OF_MEMORY;
+	}
+	pcm->fd = dup_fd;
+	pcm->size = st.st_size;
+	pcm->header = header;
+	pcm->next = __atomic_load_n(&header->write_seq, __ATOMIC_ACQUIRE);
+	*reader = pcm;
+	return RADIO_ERROR_NONE;
+}
+
+int radio_pcm_reader_destroy(radio_pcm_reader_h reader)
+{
+	if(reader == NULL)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	munmap(reader->header, reader->size);
+	close(reader->fd);
+	__pcm_reader_release(reader);
+	return RADIO_ERROR_NONE;
+}
+
+int radio_pcm_reader_get_format(radio_pcm_reader_h reader, int *sample_rate, int *channels, int *period_frames)
+{
+	if(reader == NULL || sample_rate == NULL || channels == NULL || period_frames == NULL)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	*sample_rate = reader->header->sample_rate;
+	*channels = reader->header->channels;
+	*period_frames = reader->header->period_frames;
+	return RADIO_ERROR_NONE;
+}
+
+int radio_pcm_reader_acquire(radio_pcm_reader_h reader, int timeout_ms, radio_pcm_period_s *period)
+{
+	_radio_pcm_header_s *header;
+	_radio_pcm_period_s *slot;
+	struct timespec now, deadline, remaining;
+	uint64_t write_seq, oldest;
+	uint32_t wake;
+
+	if(reader == NULL || period == NULL)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	header = reader->header;
+	if(reader->holding)
+		radio_pcm_reader_release(reader, NULL);
+	if(timeout_ms > 0)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += timeout_ms / 1000;
+		deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+		if(deadline.tv_nsec >= 1000000000L)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+	}
+
+	while(1)
+	{
+		/* the wake count is read first, a period committed after it makes the futex wait return at once */
+		wake = __atomic_load_n(&header->wake, __ATOMIC_ACQUIRE);
+		write_seq = __atomic_load_n(&header->write_seq, __ATOMIC_ACQUIRE);
+
+		/* the slot of write_seq - period_count is the one the capture is writing */
+		oldest = write_seq >= header->period_count ? write_seq - header->period_count + 1 : 0;
+		if(reader->next < oldest)
+		{
+			reader->lost += (int)(oldest - reader->next);
+			reader->next = oldest;
+		}
+		if(reader->next < write_seq)
+		{
+			slot = __pcm_period(header, reader->next);
+			if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != reader->next + 1)
+				continue;	/* overwritten since write_seq was read, look again from the new write_seq */
+			period->sequence = reader->next;
+			period->timestamp = slot->timestamp;
+			period->frames = slot->frames;
+			period->frame_count = header->period_frames;
+			period->lost = reader->lost;
+			reader->lost = 0;
+			reader->holding = true;
+			reader->next++;
+			return RADIO_ERROR_NONE;
+		}
+		if(__atomic_load_n(&header->closed, __ATOMIC_ACQUIRE))
+			return RADIO_ERROR_INVALID_STATE;
+		if(timeout_ms == 0)
+			return RADIO_ERROR_INVALID_OPERATION;
+
+		if(timeout_ms > 0)
+		{
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			remaining.tv_sec = deadline.tv_sec - now.tv_sec;
+			remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+			if(remaining.tv_nsec < 0)
+			{
+				remaining.tv_sec--;
+				remaining.tv_nsec += 1000000000L;
+			}
+			if(remaining.tv_sec < 0)
+				return RADIO_ERROR_INVALID_OPERATION;
+		}
+		__atomic_add_fetch(&header->waiters, 1, __ATOMIC_SEQ_CST);
+		syscall(SYS_futex, &header->wake, FUTEX_WAIT, wake, timeout_ms > 0 ? &remaining : NULL, NULL, 0);
+		__atomic_sub_fetch(&header->waiters, 1, __ATOMIC_SEQ_CST);
+	}
+}
+
+int radio_pcm_reader_release(radio_pcm_reader_h reader, bool *overrun)
+{
+	_radio_pcm_period_s *slot;
+	bool overwritten;
+
+	if(reader == NULL)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	if(!reader->holding)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : No period acquired" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	/* the frames were read before the sequence is checked again */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	slot = __pcm_period(reader->header, reader->next - 1);
+	overwritten = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != reader->next;
+	reader->holding = false;
+	if(overrun)
+		*overrun = overwritten;
+	return RADIO_ERROR_NONE;
+}
@@ -0,0 +1,496 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <string.h>
+#include <radio_rds_private.h>
+
+#define RADIO_RDS_AF_FIRST_KHZ	87500	/* code n is RADIO_RDS_AF_FIRST_KHZ + n * 100 kHz */
+
+static const uint16_t __rds_offsets[_RADIO_RDS_OFFSET_NUM] = {
+	[_RADIO_RDS_OFFSET_A] = 0x0FC,
+	[_RADIO_RDS_OFFSET_B] = 0x198,
+	[_RADIO_RDS_OFFSET_C] = 0x168,
+	[_RADIO_RDS_OFFSET_C_PRIME] = 0x350,
+	[_RADIO_RDS_OFFSET_D] = 0x1B4,
+};
+
+/* position in the group of each offset, and the offset of each position (C' is tried after C) */
+static const int __rds_positions[_RADIO_RDS_OFFSET_NUM] = { 0, 1, 2, 2, 3 };
+static const _radio_rds_offset_e __rds_position_offsets[4] = {
+	_RADIO_RDS_OFFSET_A, _RADIO_RDS_OFFSET_B, _RADIO_RDS_OFFSET_C, _RADIO_RDS_OFFSET_D,
+};
+
+/*
+* The syndrome is the remainder of the block by the generator polynomial. It is linear, so it is the sum of the
+* remainders of the 3 slices of the block. A block with errors has the syndrome of its offset word plus the one of
+* the errors : g_rds_bursts maps the syndrome of every short burst back to the burst.
+*/
+static pthread_once_t g_rds_tables_once = PTHREAD_ONCE_INIT;
+static uint16_t g_rds_syndrome_low[256];	/* bits 0 to 7 */
+static uint16_t g_rds_syndrome_mid[256];	/* bits 8 to 15 */
+static uint16_t g_rds_syndrome_high[1024];	/* bits 16 to 25 */
+static uint32_t g_rds_bursts[1024];			/* 0 when no burst has the syndrome */
+
+static uint16_t __rds_remainder(uint32_t value)
+{
+	int bit;
+
+	for(bit = _RADIO_RDS_BLOCK_BITS - 1; bit >= 10; bit--)
+	{
+		if(value & (1U << bit))
+			value ^= (uint32_t)_RADIO_RDS_POLY << (bit - 10);
+	}
+	return value & 0x3FF;
+}
+
+static void __rds_tables_init(void)
+{
+	uint32_t pattern, burst;
+	uint16_t syndrome;
+	int i, length, shift;
+
+	for(i = 0; i < 256; i++)
+	{
+		g_rds_syndrome_low[i] = __rds_remainder(i);
+		g_rds_syndrome_mid[i] = __rds_remainder((uint32_t)i << 8);
+	}
+	for(i = 0; i < 1024; i++)
+		g_rds_syndrome_high[i] = __rds_remainder((uint32_t)i << 16);
+
+	/* bursts start and end with an error, any bit in between may be wrong */
+	for(length = 1; length <= _RADIO_RDS_BURST_MAX; length++)
+	{
+		for(pattern = 0; pattern < (length > 2 ? 1U << (length - 2) : 1U); pattern++)
+		{
+			burst = length == 1 ? 1 : (1U | (pattern << 1) | (1U << (length - 1)));
+			for(shift = 0; shift + length <= _RADIO_RDS_BLOCK_BITS; shift++)
+			{
+				syndrome = __rds_remainder(burst << shift);
+				if(g_rds_bursts[syndrome] == 0)
+					g_rds_bursts[syndrome] = burst << shift;
+			}
+		}
+	}
+}
+
+uint16_t _radio_rds_syndrome(uint32_t block)
+{
+	return g_rds_syndrome_low[block & 0xFF] ^ g_rds_syndrome_mid[(block >> 8) & 0xFF] ^ g_rds_syndrome_high[(block >> 16) & 0x3FF];
+}
+
+uint16_t _radio_rds_offset(_radio_rds_offset_e offset)
+{
+	return __rds_offsets[offset];
+}
+
+static int __rds_offset_of(uint16_t syndrome)
+{
+	int offset;
+
+	for(offset = 0; offset < _RADIO_RDS_OFFSET_NUM; offset++)
+	{
+		if(__rds_offsets[offset] == syndrome)
+			return offset;
+	}
+	return -1;
+}
+
+static char __rds_char(uint8_t c)
+{
+	if(c < 0x20)
+		return ' ';
+	return c < 0x7F ? (char)c : '?';
+}
+
+static void __rds_station_reset(_radio_rds_station_s *station, int frequency)
+{
+	memset(station, 0, sizeof(*station));
+	station->frequency = frequency;
+	station->rt_flag = -1;
+}
+
+/* Called with the cache lock held */
+static _radio_rds_station_s *__rds_cache_find(_radio_rds_cache_s *cache, int frequency)
+{
+	int i;
+
+	for(i = 0; i < _RADIO_RDS_CACHE_MAX; i++)
+	{
+		if(cache->stations[i].frequency == frequency)
+			return &cache->stations[i];
+	}
+	return NULL;
+}
+
+/* Called with the cache lock held, takes a free slot or the station heard the longest time ago */
+static _radio_rds_station_s *__rds_cache_add(_radio_rds_cache_s *cache, int frequency)
+{
+	_radio_rds_station_s *station = &cache->stations[0];
+	int i;
+
+	for(i = 0; i < _RADIO_RDS_CACHE_MAX && station->frequency != 0; i++)
+	{
+		if(cache->stations[i].frequency == 0 || cache->stations[i].used < station->used)
+			station = &cache->stations[i];
+	}
+	__rds_station_reset(station, frequency);
+	station->used = ++cache->tick;
+	return station;
+}
+
+/* AF method A : a code announcing the size of the list, then the frequencies, two codes per group */
+static unsigned int __rds_af_code(_radio_rds_station_s *station, uint8_t code)
+{
+	int i;
+
+	if(station->af_skip)
+	{
+		station->af_skip = false;
+		if(station->af_expected > 0)
+			station->af_expected--;
+	}
+	else if(code >= 224 && code <= 249)
+	{
+		station->af_expected = code - 224;
+		station->af_count = 0;
+		return 0;
+	}
+	else if(code == 250)
+	{
+		station->af_skip = true;
+		return 0;
+	}
+	else if(code >= 1 && code <= 204 && station->af_expected > 0)
+	{
+		for(i = 0; i < station->af_count; i++)
+		{
+			if(station->af[i] == RADIO_RDS_AF_FIRST_KHZ + code * 100)
+				return 0;
+		}
+		if(station->af_count < RADIO_RDS_AF_MAX)
+			station->af[station->af_count++] = RADIO_RDS_AF_FIRST_KHZ + code * 100;
+	}
+	else
+	{
+		return 0;
+	}
+
+	if(station->af_expected == 0 || (station->af_count < station->af_expected && station->af_count < RADIO_RDS_AF_MAX))
+		return 0;
+	station->af_expected = 0;
+	if((station->info.fields & RADIO_RDS_FIELD_AF) && station->info.af_count == station->af_count
+		&& memcmp(station->info.af, station->af, sizeof(int) * station->af_count) == 0)
+		return 0;
+	station->info.af_count = station->af_count;
+	memcpy(station->info.af, station->af, sizeof(int) * station->af_count);
+	station->info.fields |= RADIO_RDS_FIELD_AF;
+	return RADIO_RDS_FIELD_AF;
+}
+
+/* Groups 0A and 0B : 2 characters of the program service name, 0A also carries 2 AF codes */
+static unsigned int __rds_group_0(_radio_rds_station_s *station, const uint16_t *group, uint8_t valid, bool version_b)
+{
+	unsigned int changed = 0;
+	int segment = group[1] & 0x3;
+	uint8_t bit = 1 << segment;
+	char c0, c1;
+
+	if(!version_b && (valid & 0x4))
+	{
+		changed |= __rds_af_code(station, group[2] >> 8);
+		changed |= __rds_af_code(station, group[2] & 0xFF);
+	}
+	if(!(valid & 0x8))
+		return changed;
+
+	c0 = __rds_char(group[3] >> 8);
+	c1 = __rds_char(group[3] & 0xFF);
+	if((station->ps_seen & bit) && station->ps[segment * 2] == c0 && station->ps[segment * 2 + 1] == c1)
+	{
+		station->ps_confirmed |= bit;
+	}
+	else
+	{
+		station->ps[segment * 2] = c0;
+		station->ps[segment * 2 + 1] = c1;
+		station->ps_seen |= bit;
+		station->ps_confirmed &= ~bit;
+	}
+	if(station->ps_confirmed != 0xF
+		|| ((station->info.fields & RADIO_RDS_FIELD_PS) && memcmp(station->info.ps, station->ps, RADIO_RDS_PS_LENGTH) == 0))
+		return changed;
+	memcpy(station->info.ps, station->ps, RADIO_RDS_PS_LENGTH);
+	station->info.ps[RADIO_RDS_PS_LENGTH] = '\0';
+	station->info.fields |= RADIO_RDS_FIELD_PS;
+	return changed | RADIO_RDS_FIELD_PS;
+}
+
+/* Groups 2A and 2B : 4 or 2 characters of the RadioText, a new text starts when the A/B flag toggles */
+static unsigned int __rds_group_2(_radio_rds_station_s *station, const uint16_t *group, uint8_t valid, bool version_b)
+{
+	int width = version_b ? 2 : 4;
+	int segment = group[1] & 0xF;
+	int flag = ((group[1] >> 4) & 1) | (version_b << 1);
+	uint8_t chars[4];
+	uint16_t needed;
+	int i, length;
+
+	if(version_b)
+	{
+		if(!(valid & 0x8))
+			return 0;
+		chars[0] = group[3] >> 8;
+		chars[1] = group[3] & 0xFF;
+	}
+	else
+	{
+		if((valid & 0xC) != 0xC)
+			return 0;
+		chars[0] = group[2] >> 8;
+		chars[1] = group[2] & 0xFF;
+		chars[2] = group[3] >> 8;
+		chars[3] = group[3] & 0xFF;
+	}
+	if(flag != station->rt_flag)
+	{
+		station->rt_flag = flag;
+		station->rt_received = 0;
+		station->rt_length = width * 16;
+		memset(station->rt, ' ', sizeof(station->rt));
+	}
+	for(i = 0; i < width; i++)
+	{
+		if(chars[i] == 0x0D)
+		{
+			if(segment * width + i < station->rt_length)
+				station->rt_length = segment * width + i;
+			break;
+		}
+		station->rt[segment * width + i] = __rds_char(chars[i]);
+	}
+	station->rt_received |= 1 << segment;
+
+	needed = (uint16_t)((1U << ((station->rt_length + width - 1) / width)) - 1);
+	if((station->rt_received & needed) != needed)
+		return 0;
+	for(length = station->rt_length; length > 0 && station->rt[length - 1] == ' '; length--)
+		;
+	if((station->info.fields & RADIO_RDS_FIELD_RADIO_TEXT) && station->info.radio_text[length] == '\0'
+		&& memcmp(station->info.radio_text, station->rt, length) == 0)
+		return 0;
+	memcpy(station->info.radio_text, station->rt, length);
+	station->info.radio_text[length] = '\0';
+	station->info.fields |= RADIO_RDS_FIELD_RADIO_TEXT;
+	return RADIO_RDS_FIELD_RADIO_TEXT;
+}
+
+static unsigned int __rds_group(_radio_rds_decoder_s *decoder, _radio_rds_cache_s *cache)
+{
+	const uint16_t *group = decoder->group;
+	uint8_t valid = decoder->valid;
+	_radio_rds_station_s *station;
+	unsigned int changed = 0;
+	bool version_b = (valid & 0x2) && ((group[1] >> 11) & 1);
+	int pi = -1, pty;
+
+	decoder->groups++;
+	if(valid & 0x1)
+		pi = group[0];
+	else if(version_b && (valid & 0x4))
+		pi = group[2];	/* block C' repeats the PI code */
+	if(pi >= 0)
+	{
+		decoder->pi_confirmed = (decoder->pi_candidate == pi);
+		decoder->pi_candidate = pi;
+	}
+	if(!decoder->pi_confirmed || !(valid & 0x2))
+		return 0;
+
+	pthread_mutex_lock(&cache->lock);
+	station = decoder->station;
+	if(station == NULL)
+		station = decoder->station = __rds_cache_add(cache, decoder->frequency);
+	if((station->info.fields & RADIO_RDS_FIELD_PI) && station->info.pi != decoder->pi_candidate)
+	{
+		/* another station took the frequency */
+		changed = station->info.fields;
+		__rds_station_reset(station, decoder->frequency);
+		station->used = ++cache->tick;
+	}
+	if(!(station->info.fields & RADIO_RDS_FIELD_PI))
+	{
+		station->info.pi = decoder->pi_candidate;
+		station->info.fields |= RADIO_RDS_FIELD_PI;
+		changed |= RADIO_RDS_FIELD_PI;
+	}
+	pty = (group[1] >> 5) & 0x1F;
+	if(!(station->info.fields & RADIO_RDS_FIELD_PTY) || station->info.pty != pty)
+	{
+		station->info.pty = pty;
+		station->info.fields |= RADIO_RDS_FIELD_PTY;
+		changed |= RADIO_RDS_FIELD_PTY;
+	}
+	switch(group[1] >> 12)
+	{
+		case 0:
+			changed |= __rds_group_0(station, group, valid, version_b);
+			break;
+		case 2:
+			changed |= __rds_group_2(station, group, valid, version_b);
+			break;
+		default:
+			break;
+	}
+	pthread_mutex_unlock(&cache->lock);
+	return changed;
+}
+
+/* Returns true when block is, or was corrected into, a block of the offset */
+static bool __rds_check(uint32_t *block, uint16_t syndrome, _radio_rds_offset_e offset)
+{
+	uint32_t burst;
+
+	if(syndrome == __rds_offsets[offset])
+		return true;
+	burst = g_rds_bursts[syndrome ^ __rds_offsets[offset]];
+	if(burst == 0)
+		return false;
+	*block ^= burst;
+	return true;
+}
+
+static unsigned int __rds_block(_radio_rds_decoder_s *decoder, _radio_rds_cache_s *cache, uint32_t block)
+{
+	uint16_t syndrome = _radio_rds_syndrome(block);
+	int offset = __rds_offset_of(syndrome);
+	int position;
+	bool valid = (offset >= 0);
+
+	decoder->blocks++;
+	if(!decoder->synced)
+	{
+		if(offset >= 0 && decoder->previous >= 0 && __rds_positions[offset] == (__rds_positions[decoder->previous] + 1) % 4)
+		{
+			decoder->synced = true;
+			decoder->bad_run = 0;
+			decoder->valid = 0;
+			decoder->expected = __rds_positions[offset];
+		}
+		decoder->previous = offset;
+		if(!decoder->synced)
+			return 0;
+	}
+
+	position = decoder->expected;
+	if(offset >= 0 && __rds_positions[offset] != position)
+	{
+		/* a block was lost or inserted, follow the offset word rather than the count */
+		position = __rds_positions[offset];
+		decoder->valid = 0;
+	}
+	else if(offset < 0)
+	{
+		valid = __rds_check(&block, syndrome, __rds_position_offsets[position])
+			|| (position == 2 && __rds_check(&block, syndrome, _RADIO_RDS_OFFSET_C_PRIME));
+		if(valid)
+			decoder->corrected++;
+		else
+			decoder->uncorrectable++;
+	}
+
+	if(position == 0)
+		decoder->valid = 0;
+	if(valid)
+	{
+		decoder->bad_run = 0;
+		decoder->group[position] = (uint16_t)(block >> 10);
+		decoder->valid |= 1 << position;
+	}
+	else if(++decoder->bad_run >= _RADIO_RDS_SYNC_LOSS)
+	{
+		decoder->synced = false;
+		decoder->previous = -1;
+		return 0;
+	}
+	decoder->expected = (position + 1) % 4;
+	if(position == 3)
+		return __rds_group(decoder, cache);
+	return 0;
+}
+
+void _radio_rds_decoder_init(_radio_rds_decoder_s *decoder)
+{
+	pthread_once(&g_rds_tables_once, __rds_tables_init);
+	memset(decoder, 0, sizeof(*decoder));
+	decoder->previous = -1;
+}
+
+unsigned int _radio_rds_decoder_tune(_radio_rds_decoder_s *decoder, _radio_rds_cache_s *cache, int frequency)
+{
+	unsigned int fields = 0;
+
+	decoder->frequency = frequency;
+	decoder->synced = false;
+	decoder->previous = -1;
+	decoder->bad_run = 0;
+	decoder->valid = 0;
+	decoder->pi_candidate = 0;
+	decoder->pi_confirmed = false;
+
+	pthread_mutex_lock(&cache->lock);
+	decoder->station = __rds_cache_find(cache, frequency);
+	if(decoder->station != NULL)
+	{
+		decoder->station->used = ++cache->tick;
+		fields = decoder->station->info.fields;
+	}
+	pthread_mutex_unlock(&cache->lock);
+	return fields;
+}
+
+unsigned int _radio_rds_decode(_radio_rds_decoder_s *decoder, _radio_rds_cache_s *cache, const uint32_t *blocks, int count)
+{
+	unsigned int changed = 0;
+	int i;
+
+	for(i = 0; i < count; i++)
+		changed |= __rds_block(decoder, cache, blocks[i] & ((1U << _RADIO_RDS_BLOCK_BITS) - 1));
+	return changed;
+}
+
+void _radio_rds_cache_init(_radio_rds_cache_s *cache)
+{
+	memset(cache, 0, sizeof(*cache));
+	pthread_mutex_init(&cache->lock, NULL);
+}
+
+void _radio_rds_cache_deinit(_radio_rds_cache_s *cache)
+{
+	pthread_mutex_destroy(&cache->lock);
+}
+
+void _radio_rds_cache_get(_radio_rds_cache_s *cache, int frequency, radio_rds_info_s *info)
+{
+	_radio_rds_station_s *station;
+
+	pthread_mutex_lock(&cache->lock);
+	station = frequency != 0 ? __rds_cache_find(cache, frequency) : NULL;
+	if(station != NULL)
+		*info = station->info;
+	else
+		memset(info, 0, sizeof(*info));
+	pthread_mutex_unlock(&cache->lock);
+}
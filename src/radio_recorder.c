@@ -0,0 +1,562 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <radio_recorder_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+/* time the capture thread waits for a period before it looks at quit again */
+#define RADIO_RECORDER_POLL_MS		100
+#define RADIO_RECORDER_WAV_PCM		44	/* bytes of the header before the samples */
+#define RADIO_RECORDER_WAV_ADPCM	60
+
+static const int __adpcm_steps[89] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+	337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+static const int __adpcm_index[16] = {
+	-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+static void __put_le16(uint8_t *p, uint32_t value)
+{
+	p[0] = value & 0xff;
+	p[1] = (value >> 8) & 0xff;
+}
+
+static void __put_le32(uint8_t *p, uint32_t value)
+{
+	__put_le16(p, value & 0xffff);
+	__put_le16(p + 2, value >> 16);
+}
+
+/* WAV header, sizes included once the recording is complete */
+static int __recorder_header(_radio_recorder_s *recorder, uint8_t *header, uint32_t data_size)
+{
+	int channels = recorder->channels;
+	int rate = recorder->output_rate;
+	int size = 0;
+
+	memcpy(header, "RIFF", 4);
+	memcpy(header + 8, "WAVEfmt ", 8);
+	__put_le16(header + 22, channels);
+	__put_le32(header + 24, rate);
+	if(recorder->format == RADIO_RECORDING_FORMAT_WAV_PCM)
+	{
+		__put_le32(header + 16, 16);
+		__put_le16(header + 20, 1);
+		__put_le32(header + 28, rate * channels * 2);
+		__put_le16(header + 32, channels * 2);
+		__put_le16(header + 34, 16);
+		size = RADIO_RECORDER_WAV_PCM;
+	}
+	else
+	{
+		__put_le32(header + 16, 20);
+		__put_le16(header + 20, 0x11);
+		__put_le32(header + 28, (uint32_t)((uint64_t)rate * _RADIO_RECORDER_ADPCM_BLOCK * channels / _RADIO_RECORDER_ADPCM_SAMPLES));
+		__put_le16(header + 32, _RADIO_RECORDER_ADPCM_BLOCK * channels);
+		__put_le16(header + 34, 4);
+		__put_le16(header + 36, 2);
+		__put_le16(header + 38, _RADIO_RECORDER_ADPCM_SAMPLES);
+		memcpy(header + 40, "fact", 4);
+		__put_le32(header + 44, 4);
+		__put_le32(header + 48, (uint32_t)recorder->output_frames);
+		size = RADIO_RECORDER_WAV_ADPCM;
+	}
+	__put_le32(header + 4, size - 8 + data_size);
+	memcpy(header + size - 8, "data", 4);
+	__put_le32(header + size - 4, data_size);
+	return size;
+}
+
+/* Hands the current buffer over to the writer, called with the lock held */
+static void __recorder_queue(_radio_recorder_s *recorder)
+{
+	recorder->filled[(recorder->filled_head + recorder->filled_count) % _RADIO_RECORDER_BUFFERS] = recorder->current;
+	recorder->filled_count++;
+	if(recorder->filled_count > recorder->queue_peak)
+		recorder->queue_peak = recorder->filled_count;
+	recorder->current = NULL;
+	pthread_cond_broadcast(&recorder->cond);
+}
+
+/* Appends encoded bytes, waiting for the writer to free a buffer when all of them are full */
+static void __recorder_emit(_radio_recorder_s *recorder, const void *data, int size)
+{
+	int count;
+
+	while(size > 0)
+	{
+		if(recorder->current == NULL)
+		{
+			pthread_mutex_lock(&recorder->lock);
+			while(recorder->free_count == 0)
+				pthread_cond_wait(&recorder->cond, &recorder->lock);
+			recorder->current = recorder->free_list[--recorder->free_count];
+			pthread_mutex_unlock(&recorder->lock);
+		}
+		count = _RADIO_RECORDER_BUFFER_BYTES - recorder->current->size;
+		if(count > size)
+			count = size;
+		memcpy(recorder->current->data + recorder->current->size, data, count);
+		recorder->current->size += count;
+		data = (const uint8_t *)data + count;
+		size -= count;
+		if(recorder->current->size == _RADIO_RECORDER_BUFFER_BYTES)
+		{
+			pthread_mutex_lock(&recorder->lock);
+			__recorder_queue(recorder);
+			pthread_mutex_unlock(&recorder->lock);
+		}
+	}
+}
+
+static uint8_t __adpcm_encode(_radio_recorder_adpcm_s *state, int sample)
+{
+	int step = __adpcm_steps[state->index];
+	int diff = sample - state->predictor;
+	int delta = step >> 3;
+	uint8_t nibble = 0;
+
+	if(diff < 0)
+	{
+		nibble = 8;
+		diff = -diff;
+	}
+	if(diff >= step)
+	{
+		nibble |= 4;
+		diff -= step;
+		delta += step;
+	}
+	step >>= 1;
+	if(diff >= step)
+	{
+		nibble |= 2;
+		diff -= step;
+		delta += step;
+	}
+	step >>= 1;
+	if(diff >= step)
+	{
+		nibble |= 1;
+		delta += step;
+	}
+	state->predictor += (nibble & 8) ? -delta : delta;
+	if(state->predictor > 32767)
+		state->predictor = 32767;
+	else if(state->predictor < -32768)
+		state->predictor = -32768;
+	state->index += __adpcm_index[nibble];
+	if(state->index < 0)
+		state->index = 0;
+	else if(state->index > 88)
+		state->index = 88;
+	return nibble;
+}
+
+/* Encodes the full block : per channel a header with the first sample, then groups of 8 samples per channel */
+static void __recorder_encode_block(_radio_recorder_s *recorder)
+{
+	uint8_t out[_RADIO_RECORDER_ADPCM_BLOCK * _RADIO_PCM_CHANNELS_MAX];
+	int channels = recorder->channels;
+	const int16_t *block = recorder->block;
+	uint8_t *p = out;
+	int c, group, k;
+
+	for(c = 0; c < channels; c++)
+	{
+		recorder->adpcm[c].predictor = block[c];
+		__put_le16(p, (uint16_t)block[c]);
+		p[2] = recorder->adpcm[c].index;
+		p[3] = 0;
+		p += 4;
+	}
+	for(group = 0; group < (_RADIO_RECORDER_ADPCM_SAMPLES - 1) / 8; group++)
+	{
+		for(c = 0; c < channels; c++)
+		{
+			for(k = 0; k < 8; k += 2)
+			{
+				int frame = 1 + group * 8 + k;
+				uint8_t low = __adpcm_encode(&recorder->adpcm[c], block[frame * channels + c]);
+				uint8_t high = __adpcm_encode(&recorder->adpcm[c], block[(frame + 1) * channels + c]);
+				*p++ = low | (high << 4);
+			}
+		}
+	}
+	__recorder_emit(recorder, out, p - out);
+	recorder->block_samples = 0;
+}
+
+static void __recorder_encode(_radio_recorder_s *recorder, const int16_t *frames, int count)
+{
+	int channels = recorder->channels;
+	int n;
+
+	recorder->output_frames += count;
+	if(recorder->format == RADIO_RECORDING_FORMAT_WAV_PCM)
+	{
+		__recorder_emit(recorder, frames, sizeof(int16_t) * channels * count);
+		return;
+	}
+	while(count > 0)
+	{
+		n = _RADIO_RECORDER_ADPCM_SAMPLES - recorder->block_samples;
+		if(n > count)
+			n = count;
+		memcpy(recorder->block + recorder->block_samples * channels, frames, sizeof(int16_t) * channels * n);
+		recorder->block_samples += n;
+		frames += n * channels;
+		count -= n;
+		if(recorder->block_samples == _RADIO_RECORDER_ADPCM_SAMPLES)
+			__recorder_encode_block(recorder);
+	}
+}
+
+/* Converts a period to the output rate into recorder->work, returns the number of frames */
+static int __recorder_resample(_radio_recorder_s *recorder, const int16_t *in, int count)
+{
+	_radio_recorder_resampler_s *resampler = &recorder->resampler;
+	int channels = recorder->channels;
+	int16_t *out = recorder->work;
+	int c, produced = 0;
+
+	if(recorder->input_rate == recorder->output_rate)
+	{
+		memcpy(out, in, sizeof(int16_t) * channels * count);
+		return count;
+	}
+	if(!resampler->primed)
+	{
+		memcpy(resampler->previous, in, sizeof(int16_t) * channels);
+		resampler->primed = true;
+	}
+	/* position 0 is the previous frame, position i the frame i - 1 of this period */
+	while((resampler->position >> 32) < (uint64_t)count)
+	{
+		int i = (int)(resampler->position >> 32);
+		int64_t frac = resampler->position & 0xffffffff;
+		const int16_t *a = i == 0 ? resampler->previous : in + (i - 1) * channels;
+		const int16_t *b = in + i * channels;
+		for(c = 0; c < channels; c++)
+			out[produced * channels + c] = (int16_t)(a[c] + (((b[c] - a[c]) * frac) >> 32));
+		produced++;
+		resampler->position += resampler->step;
+	}
+	resampler->position -= (uint64_t)count << 32;
+	memcpy(resampler->previous, in + (count - 1) * channels, sizeof(int16_t) * channels);
+	return produced;
+}
+
+static void *__recorder_capture_thread(void *data)
+{
+	_radio_recorder_s *recorder = (_radio_recorder_s *)data;
+	radio_pcm_period_s period;
+	bool overrun;
+	int ret, count;
+
+	while(!__atomic_load_n(&recorder->quit, __ATOMIC_ACQUIRE))
+	{
+		ret = radio_pcm_reader_acquire(recorder->reader, RADIO_RECORDER_POLL_MS, &period);
+		if(ret == RADIO_ERROR_INVALID_OPERATION)
+			continue;
+		if(ret != RADIO_ERROR_NONE)
+		{
+			LOGW("[%s] The audio tap was stopped, the recording ends" ,__FUNCTION__);
+			break;
+		}
+		if(period.lost > 0)
+			__atomic_add_fetch(&recorder->frames_dropped, (uint64_t)period.lost * period.frame_count, __ATOMIC_RELAXED);
+		count = __recorder_resample(recorder, period.frames, period.frame_count);
+		radio_pcm_reader_release(recorder->reader, &overrun);
+		if(overrun)
+		{
+			/* the frames were overwritten while they were converted */
+			__atomic_add_fetch(&recorder->frames_dropped, period.frame_count, __ATOMIC_RELAXED);
+			continue;
+		}
+		__recorder_encode(recorder, recorder->work, count);
+		__atomic_add_fetch(&recorder->frames_recorded, period.frame_count, __ATOMIC_RELAXED);
+	}
+
+	/* the last block is padded with its last frame, the fact chunk tells the real length */
+	if(recorder->format == RADIO_RECORDING_FORMAT_WAV_IMA_ADPCM && recorder->block_samples > 0)
+	{
+		while(recorder->block_samples < _RADIO_RECORDER_ADPCM_SAMPLES)
+		{
+			memcpy(recorder->block + recorder->block_samples * recorder->channels,
+				recorder->block + (recorder->block_samples - 1) * recorder->channels, sizeof(int16_t) * recorder->channels);
+			recorder->block_samples++;
+		}
+		__recorder_encode_block(recorder);
+	}
+	pthread_mutex_lock(&recorder->lock);
+	if(recorder->current != NULL)
+		__recorder_queue(recorder);
+	recorder->eof = true;
+	pthread_cond_broadcast(&recorder->cond);
+	pthread_mutex_unlock(&recorder->lock);
+	return NULL;
+}
+
+static void *__recorder_writer_thread(void *data)
+{
+	_radio_recorder_s *recorder = (_radio_recorder_s *)data;
+	_radio_recorder_buffer_s *buffer;
+	ssize_t ret;
+	int done;
+
+	pthread_mutex_lock(&recorder->lock);
+	while(1)
+	{
+		if(recorder->filled_count == 0)
+		{
+			if(recorder->eof)
+				break;
+			pthread_cond_wait(&recorder->cond, &recorder->lock);
+			continue;
+		}
+		buffer = recorder->filled[recorder->filled_head];
+		recorder->filled_head = (recorder->filled_head + 1) % _RADIO_RECORDER_BUFFERS;
+		recorder->filled_count--;
+		pthread_mutex_unlock(&recorder->lock);
+
+		for(done = 0; done < buffer->size && __atomic_load_n(&recorder->error, __ATOMIC_RELAXED) == RADIO_ERROR_NONE; )
+		{
+			ret = write(recorder->fd, buffer->data + done, buffer->size - done);
+			if(ret < 0 && errno == EINTR)
+				continue;
+			if(ret <= 0)
+			{
+				LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to write the recording (%d)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, errno);
+				__atomic_store_n(&recorder->error, RADIO_ERROR_INVALID_OPERATION, __ATOMIC_RELAXED);
+				break;
+			}
+			done += ret;
+			__atomic_add_fetch(&recorder->bytes_written, ret, __ATOMIC_RELAXED);
+		}
+
+		pthread_mutex_lock(&recorder->lock);
+		buffer->size = 0;
+		recorder->free_list[recorder->free_count++] = buffer;
+		pthread_cond_broadcast(&recorder->cond);
+	}
+	pthread_mutex_unlock(&recorder->lock);
+	return NULL;
+}
+
+static void __recorder_release(_radio_recorder_s *recorder)
+{
+	int i;
+
+	for(i = 0; i < _RADIO_RECORDER_BUFFERS; i++)
+	{
+		free(recorder->buffers[i].data);
+		recorder->buffers[i].data = NULL;
+	}
+	free(recorder->work);
+	free(recorder->block);
+	recorder->work = NULL;
+	recorder->block = NULL;
+	if(recorder->fd >= 0)
+		close(recorder->fd);
+	recorder->fd = -1;
+}
+
+void _radio_recorder_init(_radio_recorder_s *recorder)
+{
+	memset(recorder, 0, sizeof(*recorder));
+	pthread_mutex_init(&recorder->lock, NULL);
+	pthread_cond_init(&recorder->cond, NULL);
+	recorder->fd = -1;
+}
+
+void _radio_recorder_deinit(_radio_recorder_s *recorder)
+{
+	_radio_recorder_stop(recorder);
+	pthread_cond_destroy(&recorder->cond);
+	pthread_mutex_destroy(&recorder->lock);
+}
+
+int _radio_recorder_start(_radio_recorder_s *recorder, radio_pcm_reader_h reader, const char *path,
+	radio_recording_format_e format, int sample_rate)
+{
+	uint8_t header[RADIO_RECORDER_WAV_ADPCM];
+	int input_rate, channels, period_frames, work_frames, header_size, i;
+	bool allocated = true;
+
+	radio_pcm_reader_get_format(reader, &input_rate, &channels, &period_frames);
+	if(sample_rate == 0)
+		sample_rate = input_rate;
+
+	pthread_mutex_lock(&recorder->lock);
+	if(recorder->fd >= 0)
+	{
+		pthread_mutex_unlock(&recorder->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : A recording is running" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		return RADIO_ERROR_INVALID_STATE;
+	}
+	recorder->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(recorder->fd < 0)
+	{
+		pthread_mutex_unlock(&recorder->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Failed to create %s (%d)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, path, errno);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+
+	recorder->format = format;
+	recorder->channels = channels;
+	recorder->input_rate = input_rate;
+	recorder->output_rate = sample_rate;
+	recorder->period_frames = period_frames;
+	recorder->output_frames = 0;
+	memset(&recorder->resampler, 0, sizeof(recorder->resampler));
+	recorder->resampler.step = ((uint64_t)input_rate << 32) / sample_rate;
+	memset(recorder->adpcm, 0, sizeof(recorder->adpcm));
+	recorder->block_samples = 0;
+
+	/* everything the recording needs is allocated here, none of it grows afterwards */
+	work_frames = (int)((int64_t)period_frames * sample_rate / input_rate) + 2;
+	recorder->work = (int16_t *)malloc(sizeof(int16_t) * channels * work_frames);
+	recorder->block = (int16_t *)malloc(sizeof(int16_t) * channels * _RADIO_RECORDER_ADPCM_SAMPLES);
+	allocated = recorder->work != NULL && recorder->block != NULL;
+	for(i = 0; i < _RADIO_RECORDER_BUFFERS; i++)
+	{
+		recorder->buffers[i].data = (uint8_t *)malloc(_RADIO_RECORDER_BUFFER_BYTES);
+		recorder->buffers[i].size = 0;
+		recorder->free_list[i] = &recorder->buffers[i];
+		allocated = allocated && recorder->buffers[i].data != NULL;
+	}
+	recorder->free_count = _RADIO_RECORDER_BUFFERS;
+	recorder->filled_head = 0;
+	recorder->filled_count = 0;
+	recorder->queue_peak = 0;
+	recorder->current = NULL;
+	recorder->frames_recorded = 0;
+	recorder->frames_dropped = 0;
+	recorder->bytes_written = 0;
+	recorder->error = RADIO_ERROR_NONE;
+	recorder->quit = false;
+	recorder->eof = false;
+	if(!allocated)
+	{
+		__recorder_release(recorder);
+		pthread_mutex_unlock(&recorder->lock);
+		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x)" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY);
+		return RADIO_ERROR_OUT_OF_MEMORY;
+	}
+
+	/* sizes are filled in when the recording stops */
+	memset(header, 0, sizeof(header));
+	header_size = __recorder_header(recorder, header, 0);
+	if(write(recorder->fd, header, header_size) != header_size)
+	{
+		__recorder_release(recorder);
+		pthread_mutex_unlock(&recorder->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to write %s (%d)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, path, errno);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+
+	recorder->reader = reader;
+	if(pthread_create(&recorder->writer_thread, NULL, __recorder_writer_thread, recorder) != 0)
+	{
+		recorder->reader = NULL;
+		__recorder_release(recorder);
+		pthread_mutex_unlock(&recorder->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create recorder threads" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	if(pthread_create(&recorder->capture_thread, NULL, __recorder_capture_thread, recorder) != 0)
+	{
+		recorder->eof = true;
+		pthread_cond_broadcast(&recorder->cond);
+		pthread_mutex_unlock(&recorder->lock);
+		pthread_join(recorder->writer_thread, NULL);
+		pthread_mutex_lock(&recorder->lock);
+		recorder->reader = NULL;
+		__recorder_release(recorder);
+		pthread_mutex_unlock(&recorder->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create recorder threads" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	recorder->running = true;
+	pthread_mutex_unlock(&recorder->lock);
+	LOGI("[%s] Recording %s, format %d, %d Hz from %d Hz" ,__FUNCTION__, path, format, sample_rate, input_rate);
+	return RADIO_ERROR_NONE;
+}
+
+void _radio_recorder_stop(_radio_recorder_s *recorder)
+{
+	uint8_t header[RADIO_RECORDER_WAV_ADPCM];
+	int header_size;
+
+	pthread_mutex_lock(&recorder->lock);
+	if(!recorder->running)
+	{
+		pthread_mutex_unlock(&recorder->lock);
+		return;
+	}
+	recorder->running = false;
+	__atomic_store_n(&recorder->quit, true, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&recorder->lock);
+	pthread_join(recorder->capture_thread, NULL);
+	pthread_join(recorder->writer_thread, NULL);
+
+	pthread_mutex_lock(&recorder->lock);
+	memset(header, 0, sizeof(header));
+	header_size = __recorder_header(recorder, header, (uint32_t)recorder->bytes_written);
+	if(pwrite(recorder->fd, header, header_size, 0) != header_size)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to complete the header (%d)" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION, errno);
+		if(recorder->error == RADIO_ERROR_NONE)
+			recorder->error = RADIO_ERROR_INVALID_OPERATION;
+	}
+	radio_pcm_reader_destroy(recorder->reader);
+	recorder->reader = NULL;
+	__recorder_release(recorder);
+	pthread_mutex_unlock(&recorder->lock);
+	LOGI("[%s] %llu frames recorded, %llu dropped, %llu bytes" ,__FUNCTION__, (unsigned long long)recorder->frames_recorded,
+		(unsigned long long)recorder->frames_dropped, (unsigned long long)recorder->bytes_written);
+}
+
+int _radio_recorder_get_status(_radio_recorder_s *recorder, radio_recording_status_s *status)
+{
+	pthread_mutex_lock(&recorder->lock);
+	status->recording = recorder->running;
+	status->queue_peak = recorder->queue_peak;
+	pthread_mutex_unlock(&recorder->lock);
+	status->frames_recorded = __atomic_load_n(&recorder->frames_recorded, __ATOMIC_RELAXED);
+	status->frames_dropped = __atomic_load_n(&recorder->frames_dropped, __ATOMIC_RELAXED);
+	status->bytes_written = __atomic_load_n(&recorder->bytes_written, __ATOMIC_RELAXED);
+	status->error = __atomic_load_n(&recorder->error, __ATOMIC_RELAXED);
+	return RADIO_ERROR_NONE;
+}
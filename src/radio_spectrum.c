@@ -0,0 +1,81 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <radio_spectrum_private.h>
+
+static int __spectrum_index(_radio_spectrum_s *spectrum, int frequency)
+{
+	int offset = frequency - spectrum->min;
+	if(offset < 0 || offset % spectrum->spacing != 0 || offset / spectrum->spacing >= spectrum->count)
+		return -1;
+	return offset / spectrum->spacing;
+}
+
+void _radio_spectrum_init(_radio_spectrum_s *spectrum, int min, int max, int spacing)
+{
+	int i;
+	int count = (max - min) / spacing + 1;
+
+	spectrum->min = min;
+	spectrum->spacing = spacing;
+	spectrum->count = count > _RADIO_SPECTRUM_MAX_CHANNELS ? _RADIO_SPECTRUM_MAX_CHANNELS : count;
+	for(i = 0; i < _RADIO_SPECTRUM_MAX_CHANNELS; i++)
+		spectrum->rssi[i] = _RADIO_SPECTRUM_UNKNOWN;
+}
+
+void _radio_spectrum_set(_radio_spectrum_s *spectrum, int frequency, int rssi)
+{
+	int index = __spectrum_index(spectrum, frequency);
+	if(index < 0)
+		return;
+	if(rssi > INT16_MAX)
+		rssi = INT16_MAX;
+	else if(rssi <= _RADIO_SPECTRUM_UNKNOWN)
+		rssi = _RADIO_SPECTRUM_UNKNOWN + 1;
+	__atomic_store_n(&spectrum->rssi[index], (int16_t)rssi, __ATOMIC_RELAXED);
+}
+
+int _radio_spectrum_get(_radio_spectrum_s *spectrum, int frequency)
+{
+	int index = __spectrum_index(spectrum, frequency);
+	if(index < 0)
+		return _RADIO_SPECTRUM_UNKNOWN;
+	return __atomic_load_n(&spectrum->rssi[index], __ATOMIC_RELAXED);
+}
+
+int _radio_spectrum_next(_radio_spectrum_s *spectrum, int frequency, int direction, int threshold)
+{
+	int index = __spectrum_index(spectrum, frequency);
+	int i;
+
+	/* off the raster : start from the channel just below, so that seeking up does not skip the one above */
+	if(index < 0)
+	{
+		if(frequency < spectrum->min)
+			index = (direction > 0) ? -1 : 0;
+		else
+			index = (frequency - spectrum->min) / spectrum->spacing + (direction > 0 ? 0 : 1);
+	}
+
+	for(i = 1; i < spectrum->count; i++)
+	{
+		int candidate = ((index + direction * i) % spectrum->count + spectrum->count) % spectrum->count;
+		int16_t rssi = __atomic_load_n(&spectrum->rssi[candidate], __ATOMIC_RELAXED);
+		if(rssi != _RADIO_SPECTRUM_UNKNOWN && rssi >= threshold)
+			return spectrum->min + candidate * spectrum->spacing;
+	}
+	return 0;
+}
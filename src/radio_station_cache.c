@@ -0,0 +1,319 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <radio_station_cache_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+/*
+* One file per band : <dir>/stations-<band_min>-<band_max>-<band_step>.cache
+* The file is mapped shared, so the station list is available as soon as the handle is created
+* and every update reaches the page cache without an explicit write.
+* The directory is looked up when a band is mapped for the first time in the process.
+*/
+static pthread_mutex_t g_bands_lock = PTHREAD_MUTEX_INITIALIZER;
+static _radio_station_cache_band_s g_bands[_RADIO_STATION_CACHE_BANDS];
+static int g_band_count;
+
+static _radio_station_cache_file_s *__cache_map_file(int band_min, int band_max, int band_step, int *file)
+{
+	const char *dir = getenv(_RADIO_STATION_CACHE_DIR_ENV);
+	char path[256];
+	struct stat st;
+	void *map;
+	int fd;
+
+	if(dir == NULL || dir[0] == '\0')
+		dir = RADIO_STATION_CACHE_DIR;
+	if(mkdir(dir, 0755) != 0 && errno != EEXIST)
+	{
+		LOGW("[%s] Failed to create %s (%d)" ,__FUNCTION__, dir, errno);
+		return NULL;
+	}
+	snprintf(path, sizeof(path), "%s/stations-%d-%d-%d.cache", dir, band_min, band_max, band_step);
+
+	fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if(fd < 0)
+	{
+		LOGW("[%s] Failed to open %s (%d)" ,__FUNCTION__, path, errno);
+		return NULL;
+	}
+	if(fstat(fd, &st) != 0 || (st.st_size != sizeof(_radio_station_cache_file_s)
+		&& ftruncate(fd, sizeof(_radio_station_cache_file_s)) != 0))
+	{
+		LOGW("[%s] Failed to size %s (%d)" ,__FUNCTION__, path, errno);
+		close(fd);
+		return NULL;
+	}
+	map = mmap(NULL, sizeof(_radio_station_cache_file_s), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(map == MAP_FAILED)
+	{
+		LOGW("[%s] Failed to map %s (%d)" ,__FUNCTION__, path, errno);
+		close(fd);
+		return NULL;
+	}
+	/* kept open for the flock() of the writers */
+	*file = fd;
+	return (_radio_station_cache_file_s *)map;
+}
+
+static void __cache_lock(_radio_station_cache_band_s *band, int operation)
+{
+	pthread_mutex_lock(&band->lock);
+	if(band->fd >= 0)
+	{
+		while(flock(band->fd, operation) != 0 && errno == EINTR)
+			;
+	}
+}
+
+static void __cache_unlock(_radio_station_cache_band_s *band)
+{
+	if(band->fd >= 0)
+		flock(band->fd, LOCK_UN);
+	pthread_mutex_unlock(&band->lock);
+}
+
+/* Called with g_bands_lock held */
+static _radio_station_cache_band_s *__cache_band_map(int band_min, int band_max, int band_step)
+{
+	_radio_station_cache_band_s *band;
+	_radio_station_cache_file_s *map;
+	int fd = -1;
+
+	if(g_band_count == _RADIO_STATION_CACHE_BANDS)
+	{
+		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x) : %d bands are mapped already" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY, g_band_count);
+		return NULL;
+	}
+	map = __cache_map_file(band_min, band_max, band_step, &fd);
+	if(map == NULL)
+	{
+		map = (_radio_station_cache_file_s *)mmap(NULL, sizeof(_radio_station_cache_file_s), PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(map == MAP_FAILED)
+		{
+			LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x)" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY);
+			return NULL;
+		}
+	}
+
+	band = &g_bands[g_band_count];
+	band->band_min = band_min;
+	band->band_max = band_max;
+	band->band_step = band_step;
+	band->fd = fd;
+	band->map = map;
+	pthread_mutex_init(&band->lock, NULL);
+
+	/* files written by another version or for another band are started over */
+	__cache_lock(band, LOCK_EX);
+	if(map->magic != _RADIO_STATION_CACHE_MAGIC || map->version != _RADIO_STATION_CACHE_VERSION
+		|| map->band_min != band_min || map->band_max != band_max || map->band_step != band_step
+		|| map->count > _RADIO_STATION_CACHE_MAX)
+	{
+		memset(map, 0, sizeof(_radio_station_cache_file_s));
+		map->magic = _RADIO_STATION_CACHE_MAGIC;
+		map->version = _RADIO_STATION_CACHE_VERSION;
+		map->band_min = band_min;
+		map->band_max = band_max;
+		map->band_step = band_step;
+	}
+	__cache_unlock(band);
+	g_band_count++;
+	LOGI("[%s] %d stations restored (persistent : %d)" ,__FUNCTION__, map->count, fd >= 0);
+	return band;
+}
+
+int _radio_station_cache_open(_radio_station_cache_s *cache, int band_min, int band_max, int band_step)
+{
+	_radio_station_cache_band_s *band = NULL;
+	int i;
+
+	pthread_mutex_lock(&g_bands_lock);
+	for(i = 0; i < g_band_count; i++)
+	{
+		if(g_bands[i].band_min == band_min && g_bands[i].band_max == band_max && g_bands[i].band_step == band_step)
+		{
+			band = &g_bands[i];
+			break;
+		}
+	}
+	if(band == NULL)
+		band = __cache_band_map(band_min, band_max, band_step);
+	pthread_mutex_unlock(&g_bands_lock);
+	if(band == NULL)
+		return RADIO_ERROR_OUT_OF_MEMORY;
+	__atomic_store_n(&cache->band, band, __ATOMIC_RELEASE);
+	return RADIO_ERROR_NONE;
+}
+
+void _radio_station_cache_close(_radio_station_cache_s *cache)
+{
+	__atomic_store_n(&cache->band, NULL, __ATOMIC_RELEASE);
+}
+
+static _radio_station_cache_band_s *__cache_band(_radio_station_cache_s *cache)
+{
+	return __atomic_load_n(&cache->band, __ATOMIC_ACQUIRE);
+}
+
+/* Returns the index of the record for frequency, or the insertion point when it is not found */
+static int __cache_find(_radio_station_cache_file_s *map, int frequency, bool *found)
+{
+	int low = 0;
+	int high = (int)map->count - 1;
+
+	while(low <= high)
+	{
+		int mid = (low + high) / 2;
+		if(map->records[mid].frequency == frequency)
+		{
+			*found = true;
+			return mid;
+		}
+		if(map->records[mid].frequency < frequency)
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+	*found = false;
+	return low;
+}
+
+static void __cache_store(_radio_station_cache_s *cache, int frequency, int rssi, int64_t timestamp, bool insert)
+{
+	_radio_station_cache_band_s *band = __cache_band(cache);
+	_radio_station_cache_file_s *map;
+	bool found;
+	int index;
+
+	if(band == NULL)
+		return;
+
+	map = band->map;
+	__cache_lock(band, LOCK_EX);
+	index = __cache_find(map, frequency, &found);
+	if(!found)
+	{
+		if(!insert || map->count == _RADIO_STATION_CACHE_MAX)
+		{
+			__cache_unlock(band);
+			return;
+		}
+		memmove(&map->records[index + 1], &map->records[index], (map->count - index) * sizeof(_radio_station_record_s));
+		map->records[index].frequency = frequency;
+		__atomic_store_n(&map->count, map->count + 1, __ATOMIC_RELEASE);
+	}
+	map->records[index].rssi = rssi;
+	map->records[index].timestamp = timestamp;
+	__cache_unlock(band);
+}
+
+void _radio_station_cache_update(_radio_station_cache_s *cache, int frequency, int rssi, int64_t timestamp)
+{
+	__cache_store(cache, frequency, rssi, timestamp, true);
+}
+
+void _radio_station_cache_refresh(_radio_station_cache_s *cache, int frequency, int rssi, int64_t timestamp)
+{
+	__cache_store(cache, frequency, rssi, timestamp, false);
+}
+
+void _radio_station_cache_prune(_radio_station_cache_s *cache, int min_frequency, int max_frequency, int64_t timestamp)
+{
+	_radio_station_cache_band_s *band = __cache_band(cache);
+	_radio_station_cache_file_s *map;
+	uint32_t i, kept = 0;
+
+	if(band == NULL)
+		return;
+
+	map = band->map;
+	__cache_lock(band, LOCK_EX);
+	for(i = 0; i < map->count; i++)
+	{
+		_radio_station_record_s *record = &map->records[i];
+		if(record->timestamp >= timestamp || record->frequency < min_frequency || record->frequency > max_frequency)
+			map->records[kept++] = *record;
+	}
+	__atomic_store_n(&map->count, kept, __ATOMIC_RELEASE);
+	__cache_unlock(band);
+}
+
+void _radio_station_cache_clear(_radio_station_cache_s *cache)
+{
+	_radio_station_cache_band_s *band = __cache_band(cache);
+
+	if(band == NULL)
+		return;
+	__cache_lock(band, LOCK_EX);
+	__atomic_store_n(&band->map->count, 0, __ATOMIC_RELEASE);
+	__cache_unlock(band);
+}
+
+int _radio_station_cache_copy(_radio_station_cache_s *cache, radio_station_s *stations, int max)
+{
+	_radio_station_cache_band_s *band = __cache_band(cache);
+	_radio_station_cache_file_s *map;
+	int i, count;
+
+	if(band == NULL)
+		return 0;
+
+	map = band->map;
+	__cache_lock(band, LOCK_SH);
+	count = (int)map->count < max ? (int)map->count : max;
+	for(i = 0; i < count; i++)
+	{
+		stations[i].frequency = map->records[i].frequency;
+		stations[i].rssi = map->records[i].rssi;
+		stations[i].timestamp = map->records[i].timestamp;
+	}
+	__cache_unlock(band);
+	return count;
+}
+
+int _radio_station_cache_count(_radio_station_cache_s *cache)
+{
+	_radio_station_cache_band_s *band = __cache_band(cache);
+
+	if(band == NULL)
+		return 0;
+	return (int)__atomic_load_n(&band->map->count, __ATOMIC_ACQUIRE);
+}
+
+void _radio_station_cache_sync(_radio_station_cache_s *cache)
+{
+	_radio_station_cache_band_s *band = __cache_band(cache);
+
+	if(band == NULL || band->fd < 0)
+		return;
+	msync(band->map, sizeof(_radio_station_cache_file_s), MS_ASYNC);
+}
@@ -0,0 +1,237 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <string.h>
+#include <time.h>
+#include <radio.h>
+#include <radio_stats_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+static _radio_stats_counter_s g_stats[_RADIO_STATS_NUM];
+
+static const char *g_stats_names[_RADIO_STATS_NUM] = {
+	[_RADIO_STATS_CREATE] = "radio_create",
+	[_RADIO_STATS_CREATE_ASYNC] = "radio_create_async",
+	[_RADIO_STATS_CREATE_LAZY] = "radio_create_lazy",
+	[_RADIO_STATS_DESTROY] = "radio_destroy",
+	[_RADIO_STATS_GET_STATE] = "radio_get_state",
+	[_RADIO_STATS_REFRESH] = "radio_refresh",
+	[_RADIO_STATS_START] = "radio_start",
+	[_RADIO_STATS_STOP] = "radio_stop",
+	[_RADIO_STATS_SEEK_UP] = "radio_seek_up",
+	[_RADIO_STATS_SEEK_DOWN] = "radio_seek_down",
+	[_RADIO_STATS_SET_REGION] = "radio_set_region",
+	[_RADIO_STATS_GET_REGION] = "radio_get_region",
+	[_RADIO_STATS_GET_FREQUENCY_RANGE] = "radio_get_frequency_range",
+	[_RADIO_STATS_GET_CHANNEL_SPACING] = "radio_get_channel_spacing",
+	[_RADIO_STATS_SET_FREQUENCY] = "radio_set_frequency",
+	[_RADIO_STATS_GET_FREQUENCY] = "radio_get_frequency",
+	[_RADIO_STATS_GET_SIGNAL_STRENGTH] = "radio_get_signal_strength",
+	[_RADIO_STATS_SCAN_START] = "radio_scan_start",
+	[_RADIO_STATS_SCAN_STOP] = "radio_scan_stop",
+	[_RADIO_STATS_SCAN_RANGE_START] = "radio_scan_range_start",
+	[_RADIO_STATS_SCAN_RESUME] = "radio_scan_resume",
+	[_RADIO_STATS_SCAN_INCREMENTAL_START] = "radio_scan_incremental_start",
+	[_RADIO_STATS_SET_SCAN_THRESHOLD] = "radio_set_scan_threshold",
+	[_RADIO_STATS_SET_PREDICTIVE_SEEK] = "radio_set_predictive_seek",
+	[_RADIO_STATS_FOREACH_STATION] = "radio_foreach_station",
+	[_RADIO_STATS_GET_STATION_COUNT] = "radio_get_station_count",
+	[_RADIO_STATS_CLEAR_STATIONS] = "radio_clear_stations",
+	[_RADIO_STATS_SET_MUTE] = "radio_set_mute",
+	[_RADIO_STATS_IS_MUTED] = "radio_is_muted",
+	[_RADIO_STATS_SET_SCAN_COMPLETED_CB] = "radio_set_scan_completed_cb",
+	[_RADIO_STATS_UNSET_SCAN_COMPLETED_CB] = "radio_unset_scan_completed_cb",
+	[_RADIO_STATS_SET_SCAN_BATCH_CB] = "radio_set_scan_batch_cb",
+	[_RADIO_STATS_UNSET_SCAN_BATCH_CB] = "radio_unset_scan_batch_cb",
+	[_RADIO_STATS_SET_INTERRUPTED_CB] = "radio_set_interrupted_cb",
+	[_RADIO_STATS_UNSET_INTERRUPTED_CB] = "radio_unset_interrupted_cb",
+	[_RADIO_STATS_SET_SIGNAL_STRENGTH_CHANGED_CB] = "radio_set_signal_strength_changed_cb",
+	[_RADIO_STATS_UNSET_SIGNAL_STRENGTH_CHANGED_CB] = "radio_unset_signal_strength_changed_cb",
+	[_RADIO_STATS_DUMP_TRACE] = "radio_dump_trace",
+	[_RADIO_STATS_SET_FREQUENCY_ASYNC] = "radio_set_frequency_async",
+	[_RADIO_STATS_START_ASYNC] = "radio_start_async",
+	[_RADIO_STATS_STOP_ASYNC] = "radio_stop_async",
+	[_RADIO_STATS_SEEK_UP_ASYNC] = "radio_seek_up_async",
+	[_RADIO_STATS_SEEK_DOWN_ASYNC] = "radio_seek_down_async",
+	[_RADIO_STATS_SET_EVENT_CONTEXT] = "radio_set_event_context",
+	[_RADIO_STATS_GET_EVENT_FD] = "radio_get_event_fd",
+	[_RADIO_STATS_READ_EVENTS] = "radio_read_events",
+	[_RADIO_STATS_ADD_SCAN_UPDATED_CB] = "radio_add_scan_updated_cb",
+	[_RADIO_STATS_ADD_SCAN_COMPLETED_CB] = "radio_add_scan_completed_cb",
+	[_RADIO_STATS_ADD_INTERRUPTED_CB] = "radio_add_interrupted_cb",
+	[_RADIO_STATS_REMOVE_CB] = "radio_remove_cb",
+	[_RADIO_STATS_SET_IDLE_TIMEOUT] = "radio_set_idle_timeout",
+	[_RADIO_STATS_GET_STATUS] = "radio_get_status",
+	[_RADIO_STATS_SET_ALTERNATE_FREQUENCIES] = "radio_set_alternate_frequencies",
+	[_RADIO_STATS_SET_ALTERNATE_FREQUENCY_CB] = "radio_set_alternate_frequency_cb",
+	[_RADIO_STATS_UNSET_ALTERNATE_FREQUENCY_CB] = "radio_unset_alternate_frequency_cb",
+	[_RADIO_STATS_PCM_TAP_START] = "radio_pcm_tap_start",
+	[_RADIO_STATS_PCM_TAP_STOP] = "radio_pcm_tap_stop",
+	[_RADIO_STATS_PCM_TAP_GET_FD] = "radio_pcm_tap_get_fd",
+	[_RADIO_STATS_PCM_READER_CREATE] = "radio_pcm_reader_create",
+	[_RADIO_STATS_TIMESHIFT_START] = "radio_timeshift_start",
+	[_RADIO_STATS_TIMESHIFT_STOP] = "radio_timeshift_stop",
+	[_RADIO_STATS_TIMESHIFT_PAUSE] = "radio_timeshift_pause",
+	[_RADIO_STATS_TIMESHIFT_RESUME] = "radio_timeshift_resume",
+	[_RADIO_STATS_TIMESHIFT_SEEK] = "radio_timeshift_seek",
+	[_RADIO_STATS_TIMESHIFT_GET_POSITION] = "radio_timeshift_get_position",
+	[_RADIO_STATS_TIMESHIFT_READ] = "radio_timeshift_read",
+	[_RADIO_STATS_RECORDING_START] = "radio_recording_start",
+	[_RADIO_STATS_RECORDING_STOP] = "radio_recording_stop",
+	[_RADIO_STATS_RECORDING_GET_STATUS] = "radio_recording_get_status",
+	[_RADIO_STATS_SET_RDS_CHANGED_CB] = "radio_set_rds_changed_cb",
+	[_RADIO_STATS_UNSET_RDS_CHANGED_CB] = "radio_unset_rds_changed_cb",
+	[_RADIO_STATS_GET_RDS_INFO] = "radio_get_rds_info",
+	[_RADIO_STATS_LEVEL_METER_START] = "radio_level_meter_start",
+	[_RADIO_STATS_LEVEL_METER_STOP] = "radio_level_meter_stop",
+	[_RADIO_STATS_LEVEL_METER_GET] = "radio_level_meter_get",
+	[_RADIO_STATS_MESSAGE_SCAN_INFO] = "message:scan_info",
+	[_RADIO_STATS_MESSAGE_SCAN_START] = "message:scan_start",
+	[_RADIO_STATS_MESSAGE_SCAN_STOP] = "message:scan_stop",
+	[_RADIO_STATS_MESSAGE_SCAN_FINISH] = "message:scan_finish",
+	[_RADIO_STATS_MESSAGE_SEEK_START] = "message:seek_start",
+	[_RADIO_STATS_MESSAGE_SEEK_FINISH] = "message:seek_finish",
+	[_RADIO_STATS_MESSAGE_STATE_CHANGED] = "message:state_changed",
+	[_RADIO_STATS_MESSAGE_STATE_INTERRUPTED] = "message:state_interrupted",
+	[_RADIO_STATS_MESSAGE_ERROR] = "message:error",
+	[_RADIO_STATS_MESSAGE_OTHER] = "message:other",
+	[_RADIO_STATS_DEVICE_RESUME] = "device:resume",
+	[_RADIO_STATS_DEVICE_AF_WINDOW] = "device:af_window",
+};
+
+static int __stats_error_index(int error)
+{
+	switch(error)
+	{
+		case RADIO_ERROR_INVALID_PARAMETER:	return _RADIO_STATS_ERROR_INVALID_PARAMETER;
+		case RADIO_ERROR_INVALID_OPERATION:	return _RADIO_STATS_ERROR_INVALID_OPERATION;
+		case RADIO_ERROR_INVALID_STATE:		return _RADIO_STATS_ERROR_INVALID_STATE;
+		case RADIO_ERROR_OUT_OF_MEMORY:		return _RADIO_STATS_ERROR_OUT_OF_MEMORY;
+		case RADIO_ERROR_SOUND_POLICY:		return _RADIO_STATS_ERROR_SOUND_POLICY;
+		default:							return _RADIO_STATS_ERROR_OTHER;
+	}
+}
+
+static int __stats_bucket(uint64_t ns)
+{
+	int bucket = ns ? 64 - __builtin_clzll(ns) : 0;
+	return bucket < _RADIO_STATS_BUCKETS ? bucket : _RADIO_STATS_BUCKETS - 1;
+}
+
+/* Upper bound of the bucket holding the given rank, latencies are rounded up to the next power of two */
+static uint64_t __stats_percentile(const uint64_t *buckets, uint64_t calls, int percent)
+{
+	uint64_t rank = (calls * percent + 99) / 100;
+	uint64_t seen = 0;
+	int i;
+
+	for(i = 0; i < _RADIO_STATS_BUCKETS; i++)
+	{
+		seen += buckets[i];
+		if(seen >= rank && seen > 0)
+			return ((uint64_t)1 << i) - 1;
+	}
+	return ((uint64_t)1 << (_RADIO_STATS_BUCKETS - 1)) - 1;
+}
+
+uint64_t _radio_stats_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void _radio_stats_record(_radio_stats_e id, uint64_t start_ns, int error)
+{
+	_radio_stats_counter_s *counter = &g_stats[id];
+	uint64_t ns = _radio_stats_now() - start_ns;
+	uint64_t max = __atomic_load_n(&counter->max_ns, __ATOMIC_RELAXED);
+
+	__atomic_fetch_add(&counter->total_ns, ns, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&counter->buckets[__stats_bucket(ns)], 1, __ATOMIC_RELAXED);
+	if(error != RADIO_ERROR_NONE)
+		__atomic_fetch_add(&counter->errors[__stats_error_index(error)], 1, __ATOMIC_RELAXED);
+	while(ns > max && !__atomic_compare_exchange_n(&counter->max_ns, &max, ns, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+int radio_foreach_statistics(radio_statistics_cb callback, void *user_data)
+{
+	if(callback == NULL)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+
+	int id, i;
+	for(id = 0; id < _RADIO_STATS_NUM; id++)
+	{
+		_radio_stats_counter_s *counter = &g_stats[id];
+		uint64_t buckets[_RADIO_STATS_BUCKETS];
+		uint64_t errors[_RADIO_STATS_ERROR_NUM];
+		radio_statistics_s statistics;
+		uint64_t calls = 0;
+
+		/* the call count is the sum of the histogram so that the percentiles agree with it */
+		for(i = 0; i < _RADIO_STATS_BUCKETS; i++)
+		{
+			buckets[i] = __atomic_load_n(&counter->buckets[i], __ATOMIC_RELAXED);
+			calls += buckets[i];
+		}
+		if(calls == 0)
+			continue;
+		for(i = 0; i < _RADIO_STATS_ERROR_NUM; i++)
+			errors[i] = __atomic_load_n(&counter->errors[i], __ATOMIC_RELAXED);
+
+		memset(&statistics, 0, sizeof(statistics));
+		statistics.name = g_stats_names[id];
+		statistics.calls = calls;
+		statistics.invalid_parameter = errors[_RADIO_STATS_ERROR_INVALID_PARAMETER];
+		statistics.invalid_operation = errors[_RADIO_STATS_ERROR_INVALID_OPERATION];
+		statistics.invalid_state = errors[_RADIO_STATS_ERROR_INVALID_STATE];
+		statistics.out_of_memory = errors[_RADIO_STATS_ERROR_OUT_OF_MEMORY];
+		statistics.sound_policy = errors[_RADIO_STATS_ERROR_SOUND_POLICY];
+		for(i = 0; i < _RADIO_STATS_ERROR_NUM; i++)
+			statistics.errors += errors[i];
+		statistics.total_ns = __atomic_load_n(&counter->total_ns, __ATOMIC_RELAXED);
+		statistics.max_ns = __atomic_load_n(&counter->max_ns, __ATOMIC_RELAXED);
+		statistics.p50_ns = __stats_percentile(buckets, calls, 50);
+		statistics.p99_ns = __stats_percentile(buckets, calls, 99);
+		if(!callback(&statistics, user_data))
+			break;
+	}
+	return RADIO_ERROR_NONE;
+}
+
+int radio_reset_statistics(void)
+{
+	int id, i;
+	for(id = 0; id < _RADIO_STATS_NUM; id++)
+	{
+		_radio_stats_counter_s *counter = &g_stats[id];
+		__atomic_store_n(&counter->total_ns, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&counter->max_ns, 0, __ATOMIC_RELAXED);
+		for(i = 0; i < _RADIO_STATS_ERROR_NUM; i++)
+			__atomic_store_n(&counter->errors[i], 0, __ATOMIC_RELAXED);
+		for(i = 0; i < _RADIO_STATS_BUCKETS; i++)
+			__atomic_store_n(&counter->buckets[i], 0, __ATOMIC_RELAXED);
+	}
+	return RADIO_ERROR_NONE;
+}
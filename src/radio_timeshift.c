@@ -0,0 +1,389 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <radio_timeshift_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+/* time the thread waits for a period before it looks at quit again */
+#define RADIO_TIMESHIFT_POLL_MS		100
+
+static size_t __timeshift_page_align(size_t size)
+{
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	return (size + page - 1) / page * page;
+}
+
+static uint64_t __timeshift_oldest(_radio_timeshift_s *ts)
+{
+	return ts->file->written > ts->capacity ? ts->file->written - ts->capacity : 0;
+}
+
+static uint64_t __timeshift_frames_ns(_radio_timeshift_s *ts, uint64_t frames)
+{
+	return frames * 1000000000ULL / ts->sample_rate;
+}
+
+/* Copies the staged batch to the file, called with the lock held */
+static void __timeshift_flush(_radio_timeshift_s *ts)
+{
+	size_t frame = sizeof(int16_t) * ts->channels;
+
+	memcpy((char *)ts->data + (ts->file->written % ts->capacity) * frame, ts->staging, ts->staged * frame);
+	ts->file->written += ts->staged;
+	ts->staged = 0;
+}
+
+/* Indexes the frame about to be staged, called with the lock held */
+static void __timeshift_index(_radio_timeshift_s *ts, uint64_t timestamp)
+{
+	uint64_t granule = timestamp / _RADIO_TIMESHIFT_GRANULE_NS;
+	uint64_t position = ts->file->written + ts->staged;
+	uint64_t first;
+	_radio_timeshift_index_s *entry;
+
+	if(ts->last_granule != 0 && granule <= ts->last_granule)
+		return;
+	/* the granules without audio lead to where it came back, only the last index_count ones can be kept */
+	first = ts->last_granule != 0 ? ts->last_granule + 1 : granule;
+	if(granule - first >= ts->file->index_count)
+		first = granule - ts->file->index_count + 1;
+	for(; first <= granule; first++)
+	{
+		entry = &ts->index[first % ts->file->index_count];
+		entry->tag = first + 1;
+		entry->position = position;
+		entry->timestamp = timestamp;
+	}
+	ts->last_granule = granule;
+}
+
+static void __timeshift_stage(_radio_timeshift_s *ts, const radio_pcm_period_s *period)
+{
+	size_t frame = sizeof(int16_t) * ts->channels;
+	uint64_t timestamp = period->timestamp - __timeshift_frames_ns(ts, period->frame_count);
+	uint64_t done = 0, count;
+
+	while(done < (uint64_t)period->frame_count)
+	{
+		count = _RADIO_TIMESHIFT_BATCH_FRAMES - ts->staged;
+		if(count > period->frame_count - done)
+			count = period->frame_count - done;
+
+		pthread_mutex_lock(&ts->lock);
+		__timeshift_index(ts, timestamp + __timeshift_frames_ns(ts, done));
+		pthread_mutex_unlock(&ts->lock);
+		memcpy((char *)ts->staging + ts->staged * frame, (const char *)period->frames + done * frame, count * frame);
+		ts->staged += count;
+		done += count;
+
+		if(ts->staged == _RADIO_TIMESHIFT_BATCH_FRAMES)
+		{
+			pthread_mutex_lock(&ts->lock);
+			__timeshift_flush(ts);
+			ts->live_timestamp = timestamp + __timeshift_frames_ns(ts, done);
+			pthread_mutex_unlock(&ts->lock);
+		}
+	}
+}
+
+static void *__timeshift_thread(void *data)
+{
+	_radio_timeshift_s *ts = (_radio_timeshift_s *)data;
+	radio_pcm_period_s period;
+	bool overrun;
+	int ret;
+
+	while(!__atomic_load_n(&ts->quit, __ATOMIC_ACQUIRE))
+	{
+		ret = radio_pcm_reader_acquire(ts->reader, RADIO_TIMESHIFT_POLL_MS, &period);
+		if(ret == RADIO_ERROR_INVALID_OPERATION)
+			continue;
+		if(ret != RADIO_ERROR_NONE)
+		{
+			LOGW("[%s] The audio tap was stopped, nothing more is recorded" ,__FUNCTION__);
+			break;
+		}
+		if(period.lost > 0)
+		{
+			LOGW("[%s] %d periods lost, the buffer has a gap" ,__FUNCTION__, period.lost);
+		}
+		__timeshift_stage(ts, &period);
+		radio_pcm_reader_release(ts->reader, &overrun);
+		if(overrun)
+		{
+			LOGW("[%s] Period %llu overwritten while it was copied" ,__FUNCTION__, period.sequence);
+		}
+	}
+	return NULL;
+}
+
+void _radio_timeshift_init(_radio_timeshift_s *ts)
+{
+	memset(ts, 0, sizeof(*ts));
+	pthread_mutex_init(&ts->lock, NULL);
+	ts->fd = -1;
+}
+
+void _radio_timeshift_deinit(_radio_timeshift_s *ts)
+{
+	_radio_timeshift_stop(ts);
+	pthread_mutex_destroy(&ts->lock);
+}
+
+int _radio_timeshift_start(_radio_timeshift_s *ts, radio_pcm_reader_h reader, const char *path, int seconds)
+{
+	size_t index_offset, data_offset, size;
+	uint64_t capacity;
+	uint32_t index_count;
+	int sample_rate, channels, period_frames;
+	char *map;
+	int fd;
+
+	radio_pcm_reader_get_format(reader, &sample_rate, &channels, &period_frames);
+	capacity = ((uint64_t)seconds * sample_rate + _RADIO_TIMESHIFT_BATCH_FRAMES - 1) / _RADIO_TIMESHIFT_BATCH_FRAMES * _RADIO_TIMESHIFT_BATCH_FRAMES;
+	/* gaps without audio make the buffer span more time than its capacity */
+	index_count = seconds * 2 + 4;
+	index_offset = __timeshift_page_align(sizeof(_radio_timeshift_file_s));
+	data_offset = index_offset + __timeshift_page_align(sizeof(_radio_timeshift_index_s) * index_count);
+	size = data_offset + capacity * sizeof(int16_t) * channels;
+
+	pthread_mutex_lock(&ts->lock);
+	if(ts->fd >= 0)
+	{
+		pthread_mutex_unlock(&ts->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : Time-shift is already started" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		return RADIO_ERROR_INVALID_STATE;
+	}
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if(fd < 0)
+	{
+		pthread_mutex_unlock(&ts->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x) : Failed to open %s (%d)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER, path, errno);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	map = MAP_FAILED;
+	if(ftruncate(fd, size) != 0
+		|| (map = (char *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED
+		|| (ts->staging = (int16_t *)malloc(sizeof(int16_t) * channels * _RADIO_TIMESHIFT_BATCH_FRAMES)) == NULL)
+	{
+		pthread_mutex_unlock(&ts->lock);
+		LOGE("[%s] RADIO_ERROR_OUT_OF_MEMORY(0x%08x) : Failed to map %zu bytes of %s (%d)" ,__FUNCTION__,RADIO_ERROR_OUT_OF_MEMORY, size, path, errno);
+		if(map != MAP_FAILED)
+			munmap(map, size);
+		close(fd);
+		return RADIO_ERROR_OUT_OF_MEMORY;
+	}
+
+	ts->map = map;
+	ts->size = size;
+	ts->file = (_radio_timeshift_file_s *)map;
+	ts->index = (_radio_timeshift_index_s *)(map + index_offset);
+	ts->data = (int16_t *)(map + data_offset);
+	ts->file->magic = _RADIO_TIMESHIFT_MAGIC;
+	ts->file->sample_rate = sample_rate;
+	ts->file->channels = channels;
+	ts->file->index_count = index_count;
+	ts->file->index_offset = index_offset;
+	ts->file->data_offset = data_offset;
+	ts->file->capacity = capacity;
+	ts->file->written = 0;
+	ts->channels = channels;
+	ts->sample_rate = sample_rate;
+	ts->capacity = capacity;
+	ts->staged = 0;
+	ts->last_granule = 0;
+	ts->live_timestamp = 0;
+	ts->play = 0;
+	ts->paused = false;
+	ts->reader = reader;
+	ts->quit = false;
+	if(pthread_create(&ts->thread, NULL, __timeshift_thread, ts) != 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_OPERATION(0x%08x) : Failed to create time-shift thread" ,__FUNCTION__,RADIO_ERROR_INVALID_OPERATION);
+		ts->reader = NULL;
+		free(ts->staging);
+		ts->staging = NULL;
+		munmap(map, size);
+		close(fd);
+		pthread_mutex_unlock(&ts->lock);
+		return RADIO_ERROR_INVALID_OPERATION;
+	}
+	ts->fd = fd;
+	ts->running = true;
+	pthread_mutex_unlock(&ts->lock);
+	LOGI("[%s] Time-shift of %d s in %s (%zu bytes)" ,__FUNCTION__, seconds, path, size);
+	return RADIO_ERROR_NONE;
+}
+
+void _radio_timeshift_stop(_radio_timeshift_s *ts)
+{
+	pthread_mutex_lock(&ts->lock);
+	if(ts->running)
+	{
+		__atomic_store_n(&ts->quit, true, __ATOMIC_RELEASE);
+		pthread_mutex_unlock(&ts->lock);
+		pthread_join(ts->thread, NULL);
+		pthread_mutex_lock(&ts->lock);
+		ts->running = false;
+	}
+	if(ts->reader != NULL)
+	{
+		radio_pcm_reader_destroy(ts->reader);
+		ts->reader = NULL;
+	}
+	if(ts->fd >= 0)
+	{
+		munmap(ts->map, ts->size);
+		close(ts->fd);
+		ts->fd = -1;
+		ts->map = NULL;
+		ts->file = NULL;
+	}
+	free(ts->staging);
+	ts->staging = NULL;
+	pthread_mutex_unlock(&ts->lock);
+}
+
+int _radio_timeshift_pause(_radio_timeshift_s *ts, bool paused)
+{
+	int ret = RADIO_ERROR_NONE;
+
+	pthread_mutex_lock(&ts->lock);
+	if(ts->fd < 0)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : Time-shift is not started" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		ret = RADIO_ERROR_INVALID_STATE;
+	}
+	else
+	{
+		ts->paused = paused;
+	}
+	pthread_mutex_unlock(&ts->lock);
+	return ret;
+}
+
+int _radio_timeshift_seek(_radio_timeshift_s *ts, int delay_ms)
+{
+	_radio_timeshift_index_s *entry, *next;
+	uint64_t target, granule, position, oldest;
+
+	pthread_mutex_lock(&ts->lock);
+	if(ts->fd < 0)
+	{
+		pthread_mutex_unlock(&ts->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : Time-shift is not started" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		return RADIO_ERROR_INVALID_STATE;
+	}
+	oldest = __timeshift_oldest(ts);
+	target = (uint64_t)delay_ms * 1000000ULL;
+	target = target < ts->live_timestamp ? ts->live_timestamp - target : 0;
+	granule = target / _RADIO_TIMESHIFT_GRANULE_NS;
+	entry = &ts->index[granule % ts->file->index_count];
+
+	if(delay_ms == 0 || ts->file->written == 0)
+	{
+		position = ts->file->written;
+	}
+	else if(entry->tag != granule + 1)
+	{
+		/* older than the index, or than the first audio */
+		position = oldest;
+	}
+	else
+	{
+		position = entry->position;
+		if(target > entry->timestamp)
+			position += (target - entry->timestamp) * ts->sample_rate / 1000000000ULL;
+		next = &ts->index[(granule + 1) % ts->file->index_count];
+		if(next->tag == granule + 2 && position > next->position)
+			position = next->position;
+	}
+	if(position < oldest)
+		position = oldest;
+	if(position > ts->file->written)
+		position = ts->file->written;
+	ts->play = position;
+	pthread_mutex_unlock(&ts->lock);
+	return RADIO_ERROR_NONE;
+}
+
+int _radio_timeshift_get_position(_radio_timeshift_s *ts, int *delay_ms, int *buffered_ms)
+{
+	uint64_t oldest, play;
+
+	pthread_mutex_lock(&ts->lock);
+	if(ts->fd < 0)
+	{
+		pthread_mutex_unlock(&ts->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : Time-shift is not started" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		return RADIO_ERROR_INVALID_STATE;
+	}
+	oldest = __timeshift_oldest(ts);
+	play = ts->play < oldest ? oldest : ts->play;
+	*delay_ms = (int)((ts->file->written - play) * 1000 / ts->sample_rate);
+	*buffered_ms = (int)((ts->file->written - oldest) * 1000 / ts->sample_rate);
+	pthread_mutex_unlock(&ts->lock);
+	return RADIO_ERROR_NONE;
+}
+
+int _radio_timeshift_read(_radio_timeshift_s *ts, short *frames, int frame_count, int *read_count)
+{
+	size_t frame;
+	uint64_t oldest, count, offset, first;
+
+	pthread_mutex_lock(&ts->lock);
+	if(ts->fd < 0)
+	{
+		pthread_mutex_unlock(&ts->lock);
+		LOGE("[%s] RADIO_ERROR_INVALID_STATE(0x%08x) : Time-shift is not started" ,__FUNCTION__,RADIO_ERROR_INVALID_STATE);
+		return RADIO_ERROR_INVALID_STATE;
+	}
+	*read_count = 0;
+	if(ts->paused)
+	{
+		pthread_mutex_unlock(&ts->lock);
+		return RADIO_ERROR_NONE;
+	}
+	/* a position the recording went past moves on to the oldest frame left */
+	oldest = __timeshift_oldest(ts);
+	if(ts->play < oldest)
+		ts->play = oldest;
+	count = ts->file->written - ts->play;
+	if(count > (uint64_t)frame_count)
+		count = frame_count;
+
+	frame = sizeof(int16_t) * ts->channels;
+	offset = ts->play % ts->capacity;
+	first = ts->capacity - offset < count ? ts->capacity - offset : count;
+	memcpy(frames, (char *)ts->data + offset * frame, first * frame);
+	memcpy((char *)frames + first * frame, ts->data, (count - first) * frame);
+	ts->play += count;
+	*read_count = (int)count;
+	pthread_mutex_unlock(&ts->lock);
+	return RADIO_ERROR_NONE;
+}
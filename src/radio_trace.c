@@ -0,0 +1,137 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <mm_radio.h>
+#include <radio_trace_private.h>
+
+#define RADIO_TRACE_MASK	(_RADIO_TRACE_ENTRIES - 1)
+
+static const char *__trace_message_name(int message)
+{
+	switch(message)
+	{
+		case MM_MESSAGE_RADIO_SCAN_INFO:	return "scan_info";
+		case MM_MESSAGE_RADIO_SCAN_START:	return "scan_start";
+		case MM_MESSAGE_RADIO_SCAN_STOP:	return "scan_stop";
+		case MM_MESSAGE_RADIO_SCAN_FINISH:	return "scan_finish";
+		case MM_MESSAGE_RADIO_SEEK_START:	return "seek_start";
+		case MM_MESSAGE_RADIO_SEEK_FINISH:	return "seek_finish";
+		case MM_MESSAGE_STATE_CHANGED:		return "state_changed";
+		case MM_MESSAGE_STATE_INTERRUPTED:	return "state_interrupted";
+		case MM_MESSAGE_ERROR:				return "error";
+		default:							return "unknown";
+	}
+}
+
+static int __trace_decode(const _radio_trace_entry_s *entry, char *buf, size_t size)
+{
+	unsigned long long sec = entry->timestamp / 1000000000ULL;
+	unsigned long nsec = (unsigned long)(entry->timestamp % 1000000000ULL);
+
+	switch(entry->event)
+	{
+		case _RADIO_TRACE_MESSAGE:
+			return snprintf(buf, size, "%llu.%09lu message %s(0x%x) %d\n", sec, nsec,
+				__trace_message_name(entry->args[0]), entry->args[0], entry->args[1]);
+		case _RADIO_TRACE_STATE:
+			return snprintf(buf, size, "%llu.%09lu state %d -> %d\n", sec, nsec, entry->args[0], entry->args[1]);
+		case _RADIO_TRACE_SET_CALLBACK:
+			return snprintf(buf, size, "%llu.%09lu set_callback %d\n", sec, nsec, entry->args[0]);
+		case _RADIO_TRACE_UNSET_CALLBACK:
+			return snprintf(buf, size, "%llu.%09lu unset_callback %d\n", sec, nsec, entry->args[0]);
+		case _RADIO_TRACE_ERROR:
+			return snprintf(buf, size, "%llu.%09lu error 0x%x -> 0x%08x\n", sec, nsec, entry->args[0], entry->args[1]);
+		case _RADIO_TRACE_SUSPEND:
+			return snprintf(buf, size, "%llu.%09lu suspend %d ms\n", sec, nsec, entry->args[0]);
+		case _RADIO_TRACE_AF_WINDOW:
+			return snprintf(buf, size, "%llu.%09lu af_window %d %d\n", sec, nsec, entry->args[0], entry->args[1]);
+		case _RADIO_TRACE_RDS:
+			return snprintf(buf, size, "%llu.%09lu rds %d 0x%x\n", sec, nsec, entry->args[0], entry->args[1]);
+		case _RADIO_TRACE_RESUME:
+			return snprintf(buf, size, "%llu.%09lu resume 0x%08x %d us\n", sec, nsec, entry->args[0], entry->args[1]);
+		default:
+			return snprintf(buf, size, "%llu.%09lu event %u %d %d\n", sec, nsec, entry->event, entry->args[0], entry->args[1]);
+	}
+}
+
+static int __trace_write_all(int fd, const char *buf, size_t size)
+{
+	while(size > 0)
+	{
+		ssize_t written = write(fd, buf, size);
+		if(written < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+		buf += written;
+		size -= written;
+	}
+	return 0;
+}
+
+void _radio_trace_write(_radio_trace_s *trace, uint64_t timestamp, _radio_trace_event_e event, int arg0, int arg1)
+{
+	uint32_t position = __atomic_fetch_add(&trace->head, 1, __ATOMIC_RELAXED);
+	_radio_trace_entry_s *entry = &trace->entries[position & RADIO_TRACE_MASK];
+
+	__atomic_store_n(&entry->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&entry->event, (uint32_t)event, __ATOMIC_RELAXED);
+	__atomic_store_n(&entry->timestamp, timestamp, __ATOMIC_RELAXED);
+	__atomic_store_n(&entry->args[0], arg0, __ATOMIC_RELAXED);
+	__atomic_store_n(&entry->args[1], arg1, __ATOMIC_RELAXED);
+	__atomic_store_n(&entry->seq, position + 1, __ATOMIC_RELEASE);
+}
+
+int _radio_trace_dump(_radio_trace_s *trace, int fd)
+{
+	uint32_t head = __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE);
+	uint32_t position = head > _RADIO_TRACE_ENTRIES ? head - _RADIO_TRACE_ENTRIES : 0;
+	char line[128];
+	int count = 0;
+
+	for(; position != head; position++)
+	{
+		_radio_trace_entry_s *slot = &trace->entries[position & RADIO_TRACE_MASK];
+		_radio_trace_entry_s entry;
+		int length;
+
+		/* entries being written or already overwritten by a newer event are skipped */
+		if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != position + 1)
+			continue;
+		entry.event = __atomic_load_n(&slot->event, __ATOMIC_RELAXED);
+		entry.timestamp = __atomic_load_n(&slot->timestamp, __ATOMIC_RELAXED);
+		entry.args[0] = __atomic_load_n(&slot->args[0], __ATOMIC_RELAXED);
+		entry.args[1] = __atomic_load_n(&slot->args[1], __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != position + 1)
+			continue;
+
+		length = __trace_decode(&entry, line, sizeof(line));
+		if(length >= (int)sizeof(line))
+			length = sizeof(line) - 1;
+		if(__trace_write_all(fd, line, length) != 0)
+			return -1;
+		count++;
+	}
+	return count;
+}
@@ -0,0 +1,797 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <radio.h>
+#include <radio_backend_private.h>
+#include <radio_rds_private.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_RADIO"
+
+/*
+* The mock tuner keeps its instances in a fixed pool, MMHandleType is the slot index + 1.
+* Seek and scan run on a per instance worker so messages arrive asynchronously, like with mm-radio.
+* A job is cleared before its final message is posted, so the next one can be requested from the callback.
+* The audio comes from config.pcm_file, read in a loop by a single reader while the tuner plays.
+* The RDS of a station is its range of blocks of config.rds_file, read in a loop by a single reader from the first
+* block of the range every time the station is tuned.
+*/
+#define _RADIO_MOCK_MAX_INSTANCES	16
+
+typedef enum {
+	_RADIO_MOCK_JOB_NONE,
+	_RADIO_MOCK_JOB_SEEK_UP,
+	_RADIO_MOCK_JOB_SEEK_DOWN,
+	_RADIO_MOCK_JOB_SCAN,
+} _radio_mock_job_e;
+
+typedef struct {
+	bool used;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t worker;
+	_radio_mock_config_s config;
+	MMRadioStateType state;
+	int frequency;
+	bool muted;
+	MMMessageCallback callback;
+	void *user_param;
+	_radio_mock_job_e job;
+	bool cancel;
+	bool quit;
+	int interrupt;				/* code of an interruption the worker posts next, -1 for none */
+	int pcm_fd;					/* -1 without audio */
+	off_t pcm_size;				/* whole frames */
+	off_t pcm_offset;			/* next frame to read, only used by the reader */
+	uint64_t pcm_due_ns;		/* monotonic time the next frame is due at, only used by the reader */
+	int rds_fd;					/* -1 without RDS */
+	int rds_frequency;			/* station of rds_position, only used by the reader */
+	int rds_position;			/* next block of the station, only used by the reader */
+	uint64_t rds_due_ns;		/* monotonic time the next block is due at, only used by the reader */
+} _radio_mock_s;
+
+static pthread_mutex_t g_mock_lock = PTHREAD_MUTEX_INITIALIZER;
+static _radio_mock_s g_mock[_RADIO_MOCK_MAX_INSTANCES];
+static _radio_mock_config_s g_mock_config = {
+	.band_min = 87500,
+	.band_max = 108000,
+	.band_step = 100,
+	.noise_rssi = 10,
+	.pcm_sample_rate = 48000,
+	.pcm_channels = 2,
+	.seek_delay_ms = 0,
+	.scan_step_delay_us = 0,
+	.station_count = 10,
+	.stations = {
+		{ 89100, 45 }, { 91900, 52 }, { 93500, 38 }, { 95700, 60 }, { 97300, 41 },
+		{ 99900, 55 }, { 101500, 47 }, { 103100, 30 }, { 105900, 58 }, { 107700, 36 },
+	},
+};
+static int g_mock_realize_failures;		/* next realizes which fail, protected by g_mock_lock */
+
+static _radio_mock_s *__mock_get(MMHandleType backend)
+{
+	int index = (int)backend - 1;
+	if(index < 0 || index >= _RADIO_MOCK_MAX_INSTANCES || !g_mock[index].used)
+		return NULL;
+	return &g_mock[index];
+}
+
+static int __mock_rssi(_radio_mock_s *mock, int frequency)
+{
+	int i;
+	for(i = 0; i < mock->config.station_count; i++)
+	{
+		if(mock->config.stations[i].frequency == frequency)
+			return mock->config.stations[i].rssi;
+	}
+	return mock->config.noise_rssi;
+}
+
+static bool __mock_is_station(_radio_mock_s *mock, int frequency)
+{
+	return __mock_rssi(mock, frequency) > mock->config.noise_rssi;
+}
+
+static uint64_t __mock_now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void __mock_pcm_open(_radio_mock_s *mock)
+{
+	size_t frame = sizeof(short) * mock->config.pcm_channels;
+	struct stat st;
+
+	mock->pcm_fd = -1;
+	if(mock->config.pcm_file[0] == '\0' || mock->config.pcm_channels <= 0 || mock->config.pcm_sample_rate <= 0)
+		return;
+	mock->pcm_fd = open(mock->config.pcm_file, O_RDONLY | O_CLOEXEC);
+	if(mock->pcm_fd < 0 || fstat(mock->pcm_fd, &st) != 0 || st.st_size < (off_t)frame)
+	{
+		LOGW("[%s] No audio, %s cannot be read" ,__FUNCTION__, mock->config.pcm_file);
+		if(mock->pcm_fd >= 0)
+			close(mock->pcm_fd);
+		mock->pcm_fd = -1;
+		return;
+	}
+	mock->pcm_size = st.st_size - st.st_size % frame;
+}
+
+static void __mock_rds_open(_radio_mock_s *mock)
+{
+	mock->rds_fd = -1;
+	if(mock->config.rds_file[0] == '\0')
+		return;
+	mock->rds_fd = open(mock->config.rds_file, O_RDONLY | O_CLOEXEC);
+	if(mock->rds_fd < 0)
+	{
+		LOGW("[%s] No RDS, %s cannot be read" ,__FUNCTION__, mock->config.rds_file);
+	}
+}
+
+static void __mock_close_files(_radio_mock_s *mock)
+{
+	if(mock->pcm_fd >= 0)
+		close(mock->pcm_fd);
+	if(mock->rds_fd >= 0)
+		close(mock->rds_fd);
+}
+
+/* Must be called without mock->lock held, the callback may call back into the mock */
+static void __mock_post(_radio_mock_s *mock, int message, MMMessageParamType *param)
+{
+	MMMessageCallback callback;
+	void *user_param;
+
+	pthread_mutex_lock(&mock->lock);
+	callback = mock->callback;
+	user_param = mock->user_param;
+	pthread_mutex_unlock(&mock->lock);
+
+	if(callback)
+		callback(message, param, user_param);
+}
+
+static void __mock_post_state(_radio_mock_s *mock, MMRadioStateType previous, MMRadioStateType current)
+{
+	MMMessageParamType param;
+	memset(&param, 0, sizeof(param));
+	param.state.previous = previous;
+	param.state.current = current;
+	__mock_post(mock, MM_MESSAGE_STATE_CHANGED, &param);
+}
+
+static void __mock_post_frequency(_radio_mock_s *mock, int message, int frequency)
+{
+	MMMessageParamType param;
+	memset(&param, 0, sizeof(param));
+	param.radio_scan.frequency = frequency;
+	__mock_post(mock, message, &param);
+}
+
+/* Waits for the given time with mock->lock held. Returns false when the job was cancelled. */
+static bool __mock_wait_us(_radio_mock_s *mock, int usec)
+{
+	struct timespec deadline;
+
+	if(usec <= 0)
+		return !mock->cancel && !mock->quit;
+
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += usec / 1000000;
+	deadline.tv_nsec += (long)(usec % 1000000) * 1000;
+	if(deadline.tv_nsec >= 1000000000)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
+	}
+	while(!mock->cancel && !mock->quit)
+	{
+		if(pthread_cond_timedwait(&mock->cond, &mock->lock, &deadline) == ETIMEDOUT)
+			break;
+	}
+	return !mock->cancel && !mock->quit;
+}
+
+static void __mock_run_seek(_radio_mock_s *mock, _radio_mock_job_e job)
+{
+	int step = (job == _RADIO_MOCK_JOB_SEEK_UP) ? mock->config.band_step : -mock->config.band_step;
+	int frequency = mock->frequency;
+	int channels = (mock->config.band_max - mock->config.band_min) / mock->config.band_step + 1;
+	int i;
+
+	for(i = 0; i < channels; i++)
+	{
+		frequency += step;
+		if(frequency > mock->config.band_max)
+			frequency = mock->config.band_min;
+		else if(frequency < mock->config.band_min)
+			frequency = mock->config.band_max;
+		if(__mock_is_station(mock, frequency))
+			break;
+	}
+	if(i == channels)
+		frequency = mock->frequency;
+
+	__mock_wait_us(mock, mock->config.seek_delay_ms * 1000);
+	mock->frequency = frequency;
+	mock->job = _RADIO_MOCK_JOB_NONE;
+
+	pthread_mutex_unlock(&mock->lock);
+	__mock_post_frequency(mock, MM_MESSAGE_RADIO_SEEK_FINISH, frequency);
+	pthread_mutex_lock(&mock->lock);
+}
+
+static void __mock_run_scan(_radio_mock_s *mock)
+{
+	int frequency;
+	int tuned = mock->frequency;
+	bool completed = true;
+
+	/* the tuner really moves across the band, so that the signal strength can be read on each station */
+	for(frequency = mock->config.band_min; frequency <= mock->config.band_max; frequency += mock->config.band_step)
+	{
+		if(!__mock_wait_us(mock, mock->config.scan_step_delay_us))
+		{
+			completed = false;
+			break;
+		}
+		mock->frequency = frequency;
+		if(__mock_is_station(mock, frequency))
+		{
+			pthread_mutex_unlock(&mock->lock);
+			__mock_post_frequency(mock, MM_MESSAGE_RADIO_SCAN_INFO, frequency);
+			pthread_mutex_lock(&mock->lock);
+		}
+	}
+
+	if(mock->quit)
+		return;
+
+	mock->frequency = tuned;
+	mock->state = MM_RADIO_STATE_READY;
+	mock->job = _RADIO_MOCK_JOB_NONE;
+	pthread_mutex_unlock(&mock->lock);
+	__mock_post_state(mock, MM_RADIO_STATE_SCANNING, MM_RADIO_STATE_READY);
+	__mock_post_frequency(mock, completed ? MM_MESSAGE_RADIO_SCAN_FINISH : MM_MESSAGE_RADIO_SCAN_STOP, 0);
+	pthread_mutex_lock(&mock->lock);
+}
+
+static void *__mock_worker(void *data)
+{
+	_radio_mock_s *mock = (_radio_mock_s *)data;
+	_radio_mock_job_e job;
+	MMMessageParamType param;
+
+	pthread_mutex_lock(&mock->lock);
+	while(!mock->quit)
+	{
+		if(mock->interrupt >= 0)
+		{
+			memset(&param, 0, sizeof(param));
+			param.code = mock->interrupt;
+			mock->interrupt = -1;
+			pthread_mutex_unlock(&mock->lock);
+			__mock_post(mock, MM_MESSAGE_STATE_INTERRUPTED, &param);
+			pthread_mutex_lock(&mock->lock);
+			continue;
+		}
+		if(mock->job == _RADIO_MOCK_JOB_NONE)
+		{
+			pthread_cond_wait(&mock->cond, &mock->lock);
+			continue;
+		}
+		job = mock->job;
+		mock->cancel = false;
+		if(job == _RADIO_MOCK_JOB_SCAN)
+			__mock_run_scan(mock);
+		else
+			__mock_run_seek(mock, job);
+	}
+	pthread_mutex_unlock(&mock->lock);
+	return NULL;
+}
+
+static int __mock_create(MMHandleType *backend)
+{
+	_radio_mock_s *mock = NULL;
+	pthread_condattr_t attr;
+	int i;
+
+	pthread_mutex_lock(&g_mock_lock);
+	for(i = 0; i < _RADIO_MOCK_MAX_INSTANCES; i++)
+	{
+		if(!g_mock[i].used)
+		{
+			mock = &g_mock[i];
+			break;
+		}
+	}
+	if(mock == NULL)
+	{
+		pthread_mutex_unlock(&g_mock_lock);
+		return MM_ERROR_RADIO_NO_FREE_SPACE;
+	}
+	memset(mock, 0, sizeof(_radio_mock_s));
+	mock->config = g_mock_config;
+	mock->state = MM_RADIO_STATE_NULL;
+	mock->frequency = mock->config.band_min;
+	mock->interrupt = -1;
+	__mock_pcm_open(mock);
+	__mock_rds_open(mock);
+	pthread_mutex_init(&mock->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&mock->cond, &attr);
+	pthread_condattr_destroy(&attr);
+	if(pthread_create(&mock->worker, NULL, __mock_worker, mock) != 0)
+	{
+		pthread_cond_destroy(&mock->cond);
+		pthread_mutex_destroy(&mock->lock);
+		__mock_close_files(mock);
+		pthread_mutex_unlock(&g_mock_lock);
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+	mock->used = true;
+	pthread_mutex_unlock(&g_mock_lock);
+
+	*backend = (MMHandleType)(i + 1);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_destroy(MMHandleType backend)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	mock->quit = true;
+	pthread_cond_broadcast(&mock->cond);
+	pthread_mutex_unlock(&mock->lock);
+	pthread_join(mock->worker, NULL);
+
+	pthread_mutex_lock(&g_mock_lock);
+	pthread_cond_destroy(&mock->cond);
+	pthread_mutex_destroy(&mock->lock);
+	__mock_close_files(mock);
+	mock->used = false;
+	pthread_mutex_unlock(&g_mock_lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_change_state(MMHandleType backend, MMRadioStateType expected, MMRadioStateType next)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	if(mock->state != expected)
+	{
+		pthread_mutex_unlock(&mock->lock);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+	mock->state = next;
+	pthread_mutex_unlock(&mock->lock);
+
+	__mock_post_state(mock, expected, next);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_realize(MMHandleType backend)
+{
+	pthread_mutex_lock(&g_mock_lock);
+	if(g_mock_realize_failures > 0)
+	{
+		g_mock_realize_failures--;
+		pthread_mutex_unlock(&g_mock_lock);
+		return MM_ERROR_RADIO_INTERNAL;
+	}
+	pthread_mutex_unlock(&g_mock_lock);
+	return __mock_change_state(backend, MM_RADIO_STATE_NULL, MM_RADIO_STATE_READY);
+}
+
+static int __mock_unrealize(MMHandleType backend)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	MMRadioStateType previous;
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	/* like mm-radio, a playing tuner is stopped first */
+	pthread_mutex_lock(&mock->lock);
+	previous = mock->state;
+	if(previous != MM_RADIO_STATE_READY && previous != MM_RADIO_STATE_PLAYING)
+	{
+		pthread_mutex_unlock(&mock->lock);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+	mock->state = MM_RADIO_STATE_NULL;
+	pthread_mutex_unlock(&mock->lock);
+
+	__mock_post_state(mock, previous, MM_RADIO_STATE_NULL);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_start(MMHandleType backend)
+{
+	return __mock_change_state(backend, MM_RADIO_STATE_READY, MM_RADIO_STATE_PLAYING);
+}
+
+static int __mock_stop(MMHandleType backend)
+{
+	return __mock_change_state(backend, MM_RADIO_STATE_PLAYING, MM_RADIO_STATE_READY);
+}
+
+static int __mock_set_message_callback(MMHandleType backend, MMMessageCallback callback, void *user_param)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	mock->callback = callback;
+	mock->user_param = user_param;
+	pthread_mutex_unlock(&mock->lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_get_state(MMHandleType backend, MMRadioStateType *state)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	*state = mock->state;
+	pthread_mutex_unlock(&mock->lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_seek(MMHandleType backend, MMRadioSeekDirectionType direction)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	if(mock->state != MM_RADIO_STATE_PLAYING || mock->job != _RADIO_MOCK_JOB_NONE)
+	{
+		pthread_mutex_unlock(&mock->lock);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+	mock->job = (direction == MM_RADIO_SEEK_UP) ? _RADIO_MOCK_JOB_SEEK_UP : _RADIO_MOCK_JOB_SEEK_DOWN;
+	pthread_cond_broadcast(&mock->cond);
+	pthread_mutex_unlock(&mock->lock);
+
+	__mock_post_frequency(mock, MM_MESSAGE_RADIO_SEEK_START, 0);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_set_frequency(MMHandleType backend, int frequency)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	if(frequency < mock->config.band_min || frequency > mock->config.band_max)
+	{
+		pthread_mutex_unlock(&mock->lock);
+		return MM_ERROR_COMMON_INVALID_ARGUMENT;
+	}
+	mock->frequency = frequency;
+	pthread_mutex_unlock(&mock->lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_get_frequency(MMHandleType backend, int *frequency)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	*frequency = mock->frequency;
+	pthread_mutex_unlock(&mock->lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_scan_start(MMHandleType backend)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	if(mock->state != MM_RADIO_STATE_READY || mock->job != _RADIO_MOCK_JOB_NONE)
+	{
+		pthread_mutex_unlock(&mock->lock);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+	mock->state = MM_RADIO_STATE_SCANNING;
+	mock->job = _RADIO_MOCK_JOB_SCAN;
+	pthread_mutex_unlock(&mock->lock);
+
+	__mock_post_state(mock, MM_RADIO_STATE_READY, MM_RADIO_STATE_SCANNING);
+	__mock_post_frequency(mock, MM_MESSAGE_RADIO_SCAN_START, 0);
+
+	/* the worker is woken up only now so that SCAN_START is always posted before the first SCAN_INFO */
+	pthread_mutex_lock(&mock->lock);
+	pthread_cond_broadcast(&mock->cond);
+	pthread_mutex_unlock(&mock->lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_scan_stop(MMHandleType backend)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	if(mock->state != MM_RADIO_STATE_SCANNING)
+	{
+		pthread_mutex_unlock(&mock->lock);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+	mock->cancel = true;
+	pthread_cond_broadcast(&mock->cond);
+	pthread_mutex_unlock(&mock->lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_set_mute(MMHandleType backend, bool muted)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	mock->muted = muted;
+	pthread_mutex_unlock(&mock->lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_get_signal_strength(MMHandleType backend, int *strength)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+
+	pthread_mutex_lock(&mock->lock);
+	*strength = __mock_rssi(mock, mock->frequency);
+	pthread_mutex_unlock(&mock->lock);
+	return MM_ERROR_NONE;
+}
+
+static int __mock_get_pcm_format(MMHandleType backend, int *sample_rate, int *channels)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+	if(mock->pcm_fd < 0)
+		return MM_ERROR_RADIO_DEVICE_NOT_FOUND;
+
+	*sample_rate = mock->config.pcm_sample_rate;
+	*channels = mock->config.pcm_channels;
+	return MM_ERROR_NONE;
+}
+
+/* Paced by the sample rate, the file and the sleep are handled without the lock */
+static int __mock_read_pcm(MMHandleType backend, short *frames, int frame_count)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	size_t frame, size, done = 0;
+	uint64_t now, period_ns;
+	struct timespec due;
+	bool muted;
+	ssize_t ret;
+
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+	if(mock->pcm_fd < 0)
+		return MM_ERROR_RADIO_DEVICE_NOT_FOUND;
+	pthread_mutex_lock(&mock->lock);
+	if(mock->state != MM_RADIO_STATE_PLAYING)
+	{
+		pthread_mutex_unlock(&mock->lock);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+	muted = mock->muted;
+	pthread_mutex_unlock(&mock->lock);
+
+	frame = sizeof(short) * mock->config.pcm_channels;
+	size = frame * frame_count;
+	while(done < size)
+	{
+		ret = pread(mock->pcm_fd, (char *)frames + done, size - done < (size_t)(mock->pcm_size - mock->pcm_offset)
+			? size - done : (size_t)(mock->pcm_size - mock->pcm_offset), mock->pcm_offset);
+		if(ret <= 0)
+		{
+			if(ret < 0 && errno == EINTR)
+				continue;
+			return MM_ERROR_RADIO_INTERNAL;
+		}
+		done += ret;
+		mock->pcm_offset = (mock->pcm_offset + ret) % mock->pcm_size;
+	}
+	if(muted)
+		memset(frames, 0, size);
+
+	if(mock->config.pcm_unpaced)
+		return MM_ERROR_NONE;
+	/* the first period after a pause starts now rather than catching up */
+	period_ns = (uint64_t)frame_count * 1000000000ULL / mock->config.pcm_sample_rate;
+	now = __mock_now_ns();
+	if(mock->pcm_due_ns + period_ns < now)
+		mock->pcm_due_ns = now;
+	mock->pcm_due_ns += period_ns;
+	due.tv_sec = mock->pcm_due_ns / 1000000000ULL;
+	due.tv_nsec = mock->pcm_due_ns % 1000000000ULL;
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR)
+		;
+	return MM_ERROR_NONE;
+}
+
+/* Paced by the RDS bit rate like __mock_read_pcm(), a station without RDS returns no block after the same wait */
+static int __mock_read_rds(MMHandleType backend, uint32_t *blocks, int count, int *read_count)
+{
+	_radio_mock_s *mock = __mock_get(backend);
+	int frequency, first = 0, total = 0, done = 0, i, n;
+	uint64_t now, period_ns;
+	struct timespec due;
+	ssize_t ret;
+
+	if(mock == NULL)
+		return MM_ERROR_RADIO_NOT_INITIALIZED;
+	if(mock->rds_fd < 0)
+		return MM_ERROR_RADIO_DEVICE_NOT_FOUND;
+	pthread_mutex_lock(&mock->lock);
+	if(mock->state != MM_RADIO_STATE_PLAYING)
+	{
+		pthread_mutex_unlock(&mock->lock);
+		return MM_ERROR_RADIO_NO_OP;
+	}
+	frequency = mock->frequency;
+	for(i = 0; i < mock->config.station_count; i++)
+	{
+		if(mock->config.stations[i].frequency == frequency)
+		{
+			first = mock->config.stations[i].rds_first;
+			total = mock->config.stations[i].rds_count;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&mock->lock);
+
+	if(frequency != mock->rds_frequency)
+	{
+		mock->rds_frequency = frequency;
+		mock->rds_position = 0;
+	}
+	while(total > 0 && done < count)
+	{
+		n = count - done < total - mock->rds_position ? count - done : total - mock->rds_position;
+		ret = pread(mock->rds_fd, blocks + done, sizeof(uint32_t) * n, sizeof(uint32_t) * ((off_t)first + mock->rds_position));
+		if(ret < 0 && errno == EINTR)
+			continue;
+		if(ret < (ssize_t)sizeof(uint32_t))
+			return MM_ERROR_RADIO_INTERNAL;
+		done += ret / sizeof(uint32_t);
+		mock->rds_position = (mock->rds_position + ret / sizeof(uint32_t)) % total;
+	}
+	*read_count = done;
+
+	if(mock->config.rds_unpaced && done > 0)
+		return MM_ERROR_NONE;
+	period_ns = (uint64_t)count * _RADIO_RDS_BLOCK_BITS * 1000000000ULL * 10 / 11875;
+	now = __mock_now_ns();
+	if(mock->rds_due_ns + period_ns < now)
+		mock->rds_due_ns = now;
+	mock->rds_due_ns += period_ns;
+	due.tv_sec = mock->rds_due_ns / 1000000000ULL;
+	due.tv_nsec = mock->rds_due_ns % 1000000000ULL;
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR)
+		;
+	return MM_ERROR_NONE;
+}
+
+const _radio_backend_s _radio_backend_mock = {
+	.name = "mock",
+	.create = __mock_create,
+	.destroy = __mock_destroy,
+	.realize = __mock_realize,
+	.unrealize = __mock_unrealize,
+	.set_message_callback = __mock_set_message_callback,
+	.get_state = __mock_get_state,
+	.start = __mock_start,
+	.stop = __mock_stop,
+	.seek = __mock_seek,
+	.set_frequency = __mock_set_frequency,
+	.get_frequency = __mock_get_frequency,
+	.scan_start = __mock_scan_start,
+	.scan_stop = __mock_scan_stop,
+	.set_mute = __mock_set_mute,
+	.get_signal_strength = __mock_get_signal_strength,
+	.get_pcm_format = __mock_get_pcm_format,
+	.read_pcm = __mock_read_pcm,
+	.read_rds = __mock_read_rds,
+};
+
+int _radio_mock_set_config(const _radio_mock_config_s *config)
+{
+	if(config == NULL || config->band_step <= 0 || config->band_min > config->band_max
+		|| config->station_count < 0 || config->station_count > _RADIO_MOCK_MAX_STATIONS)
+	{
+		LOGE("[%s] RADIO_ERROR_INVALID_PARAMETER(0x%08x)" ,__FUNCTION__,RADIO_ERROR_INVALID_PARAMETER);
+		return RADIO_ERROR_INVALID_PARAMETER;
+	}
+	pthread_mutex_lock(&g_mock_lock);
+	g_mock_config = *config;
+	pthread_mutex_unlock(&g_mock_lock);
+	return RADIO_ERROR_NONE;
+}
+
+void _radio_mock_get_config(_radio_mock_config_s *config)
+{
+	if(config == NULL)
+		return;
+	pthread_mutex_lock(&g_mock_lock);
+	*config = g_mock_config;
+	pthread_mutex_unlock(&g_mock_lock);
+}
+
+void _radio_mock_fail_realize(int count)
+{
+	pthread_mutex_lock(&g_mock_lock);
+	g_mock_realize_failures = count;
+	pthread_mutex_unlock(&g_mock_lock);
+}
+
+void _radio_mock_interrupt(int code)
+{
+	int i;
+
+	pthread_mutex_lock(&g_mock_lock);
+	for(i = 0; i < _RADIO_MOCK_MAX_INSTANCES; i++)
+	{
+		if(!g_mock[i].used)
+			continue;
+		pthread_mutex_lock(&g_mock[i].lock);
+		g_mock[i].interrupt = code;
+		pthread_cond_broadcast(&g_mock[i].cond);
+		pthread_mutex_unlock(&g_mock[i].lock);
+	}
+	pthread_mutex_unlock(&g_mock_lock);
+}
@@ -0,0 +1,220 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <radio_fixture.h>
+
+const _radio_fixture_rds_station_s _radio_fixture_rds_stations[_RADIO_FIXTURE_RDS_STATIONS] = {
+	{ 0xC201, 10, false, "RADIO 1 ", "Now playing: fixture stream A\r", 3, { 91900, 95700, 101500 } },
+	{ 0xD3C2, 1, true, "NEWS 24 ", "Traffic: A1 clear\r", 0, { 0 } },
+};
+
+static int __fixture_pcm_file(char *path, size_t size)
+{
+	short frames[2 * 1024];
+	int fd, i, j;
+
+	snprintf(path, size, "/tmp/radio_fixture_pcm_XXXXXX");
+	fd = mkstemp(path);
+	if(fd < 0)
+		return -1;
+	for(i = 0; i < _RADIO_FIXTURE_PCM_FRAMES; i += 1024)
+	{
+		for(j = 0; j < 1024; j++)
+		{
+			frames[j * 2] = (short)(i + j);
+			frames[j * 2 + 1] = (short)~(i + j);
+		}
+		if(write(fd, frames, sizeof(frames)) != sizeof(frames))
+		{
+			close(fd);
+			unlink(path);
+			return -1;
+		}
+	}
+	close(fd);
+	return 0;
+}
+
+static uint32_t __fixture_rds_block(uint16_t data, uint16_t offset)
+{
+	uint32_t value = (uint32_t)data << 10;
+	int bit;
+
+	for(bit = 25; bit >= 10; bit--)
+	{
+		if(value & (1U << bit))
+			value ^= 0x5B9U << (bit - 10);
+	}
+	return ((uint32_t)data << 10) | ((value & 0x3FF) ^ offset);
+}
+
+static int __fixture_rds_group(uint32_t *blocks, uint16_t a, uint16_t b, uint16_t c, uint16_t d)
+{
+	blocks[0] = __fixture_rds_block(a, 0x0FC);
+	blocks[1] = __fixture_rds_block(b, 0x198);
+	blocks[2] = __fixture_rds_block(c, (b & 0x0800) ? 0x350 : 0x168);
+	blocks[3] = __fixture_rds_block(d, 0x1B4);
+	return 4;
+}
+
+/* The program service name twice, with the AF list in 0A groups, then the RadioText up to its end mark */
+static int __fixture_rds_pass(const _radio_fixture_rds_station_s *station, uint32_t *blocks)
+{
+	uint16_t b = (station->version_b << 11) | (station->pty << 5);
+	int width = station->version_b ? 2 : 4;
+	int length = strlen(station->radio_text);
+	uint8_t codes[16], chars[4];
+	int i, k, segment, n = 0;
+
+	memset(codes, 205, sizeof(codes));
+	if(station->af_count > 0)
+		codes[0] = 224 + station->af_count;
+	for(i = 0; i < station->af_count; i++)
+		codes[i + 1] = (station->af[i] - 87500) / 100;
+	for(i = 0; i < 8; i++)
+	{
+		segment = i % 4;
+		n += __fixture_rds_group(blocks + n, station->pi, b | segment,
+			station->version_b ? station->pi : (codes[i * 2] << 8) | codes[i * 2 + 1],
+			(station->ps[segment * 2] << 8) | station->ps[segment * 2 + 1]);
+	}
+	for(segment = 0; segment * width < length; segment++)
+	{
+		for(k = 0; k < 4; k++)
+			chars[k] = segment * width + k < length ? station->radio_text[segment * width + k] : ' ';
+		if(station->version_b)
+			n += __fixture_rds_group(blocks + n, station->pi, 0x2000 | b | segment, station->pi, (chars[0] << 8) | chars[1]);
+		else
+			n += __fixture_rds_group(blocks + n, station->pi, 0x2000 | b | segment, (chars[0] << 8) | chars[1], (chars[2] << 8) | chars[3]);
+	}
+	return n;
+}
+
+int _radio_fixture_rds_stream(const _radio_fixture_rds_station_s *station, uint32_t *blocks)
+{
+	uint32_t pass[_RADIO_FIXTURE_RDS_BLOCKS_MAX / 4];
+	int length = __fixture_rds_pass(station, pass);
+	int i, n = 0;
+
+	/* noise, then the second half of a group before the sync */
+	blocks[n++] = 0x1234567;
+	blocks[n++] = 0x2ABCDEF;
+	for(i = 2; i < length; i++)
+		blocks[n++] = pass[i];
+	for(i = 0; i < length * 2; i++)
+		blocks[n++] = pass[i % length];
+	/* one error per block at most : a longer pattern may pass for a short burst, which the decoder would trust */
+	for(i = 2; i < n; i++)
+	{
+		if(i % 37 == 17)
+			blocks[i] ^= 0x2108421;
+		else if(i % 7 == 3)
+			blocks[i] ^= 1U << (i % 26);
+		else if(i % 11 == 5)
+			blocks[i] ^= 3U << (i % 25);
+	}
+	return n;
+}
+
+static int __fixture_rds_file(char *path, size_t size, _radio_mock_config_s *config)
+{
+	uint32_t blocks[_RADIO_FIXTURE_RDS_BLOCKS_MAX];
+	int fd, i, n, first = 0;
+
+	snprintf(path, size, "/tmp/radio_fixture_rds_XXXXXX");
+	fd = mkstemp(path);
+	if(fd < 0)
+		return -1;
+	for(i = 0; i < _RADIO_FIXTURE_RDS_STATIONS; i++)
+	{
+		n = _radio_fixture_rds_stream(&_radio_fixture_rds_stations[i], blocks);
+		if(write(fd, blocks, sizeof(uint32_t) * n) != (ssize_t)(sizeof(uint32_t) * n))
+		{
+			close(fd);
+			unlink(path);
+			return -1;
+		}
+		config->stations[i].rds_first = first;
+		config->stations[i].rds_count = n;
+		first += n;
+	}
+	close(fd);
+	return 0;
+}
+
+int _radio_fixture_open(_radio_fixture_s *fixture)
+{
+	_radio_mock_config_s *config = &fixture->config;
+	int i;
+
+	memset(fixture, 0, sizeof(_radio_fixture_s));
+	_radio_mock_get_config(config);
+	config->seek_delay_ms = 0;
+	config->scan_step_delay_us = 0;
+	config->station_count = _RADIO_MOCK_MAX_STATIONS;
+	for(i = 0; i < config->station_count; i++)
+	{
+		config->stations[i].frequency = config->band_min + (i * 3 + 1) * config->band_step;
+		config->stations[i].rssi = config->noise_rssi + 20 + i % 30;
+		config->stations[i].rds_first = 0;
+		config->stations[i].rds_count = 0;
+	}
+	if(__fixture_pcm_file(fixture->pcm_file, sizeof(fixture->pcm_file)) != 0)
+		return -1;
+	snprintf(config->pcm_file, sizeof(config->pcm_file), "%s", fixture->pcm_file);
+	config->pcm_sample_rate = _RADIO_FIXTURE_PCM_RATE;
+	config->pcm_channels = 2;
+	if(__fixture_rds_file(fixture->rds_file, sizeof(fixture->rds_file), config) != 0)
+	{
+		unlink(fixture->pcm_file);
+		return -1;
+	}
+	snprintf(config->rds_file, sizeof(config->rds_file), "%s", fixture->rds_file);
+	config->rds_unpaced = true;
+	_radio_mock_set_config(config);
+	_radio_backend_set_default(&_radio_backend_mock);
+	return 0;
+}
+
+void _radio_fixture_close(_radio_fixture_s *fixture)
+{
+	unlink(fixture->pcm_file);
+	unlink(fixture->rds_file);
+}
+
+void _radio_fixture_meter_signal(int16_t *buffer, int count)
+{
+	unsigned int seed = 12345;
+	int i, envelope;
+
+	for(i = 0; i < count; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		envelope = (i >> 12) % 16;
+		if(envelope == 5)
+			buffer[i] = 0;
+		else if(envelope == 9)
+			buffer[i] = (int16_t)((int)(seed >> 16) % (_RADIO_FIXTURE_SILENCE + 1));
+		else if(envelope == 15)
+			buffer[i] = (seed >> 31) ? INT16_MIN : INT16_MAX;
+		else
+			buffer[i] = (int16_t)((int)(seed >> 16) >> envelope);
+	}
+}
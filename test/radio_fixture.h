@@ -0,0 +1,80 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_MEDIA_RADIO_FIXTURE_H__
+#define	__TIZEN_MEDIA_RADIO_FIXTURE_H__
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <radio.h>
+#include <radio_backend_private.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+* Inputs shared by radio_test and radio_bench : the mock band, the audio file and the RDS streams it plays.
+* They are generated here independently of the library code they are fed to.
+*/
+
+#define _RADIO_FIXTURE_PCM_FRAMES		65536	/* frame i of the audio file holds i, then ~i */
+#define _RADIO_FIXTURE_PCM_RATE			48000
+#define _RADIO_FIXTURE_RDS_BLOCKS_MAX	1024	/* of the stream of one station */
+#define _RADIO_FIXTURE_RDS_STATIONS		2		/* the first stations of the band, the others have no RDS */
+#define _RADIO_FIXTURE_RDS_ALL			(RADIO_RDS_FIELD_PI | RADIO_RDS_FIELD_PTY | RADIO_RDS_FIELD_PS | RADIO_RDS_FIELD_RADIO_TEXT | RADIO_RDS_FIELD_AF)
+#define _RADIO_FIXTURE_SILENCE			64		/* silence level of the meter signal */
+
+typedef struct {
+	int pi;
+	int pty;
+	bool version_b;				/* 0B and 2B groups, which carry no AF */
+	const char *ps;
+	const char *radio_text;		/* ends with the end mark */
+	int af_count;
+	int af[4];
+} _radio_fixture_rds_station_s;
+
+extern const _radio_fixture_rds_station_s _radio_fixture_rds_stations[_RADIO_FIXTURE_RDS_STATIONS];
+
+typedef struct {
+	_radio_mock_config_s config;
+	char pcm_file[64];
+	char rds_file[64];
+} _radio_fixture_s;
+
+/*
+* Densest band the mock supports without any artificial tuner delay, playing the audio file and the RDS streams.
+* The files are removed by _radio_fixture_close().
+*/
+int _radio_fixture_open(_radio_fixture_s *fixture);
+
+void _radio_fixture_close(_radio_fixture_s *fixture);
+
+/*
+* 3 passes over the metadata of station, starting in the middle of a group, with single bit errors, 2-bit bursts and
+* blocks beyond repair spread over them. Returns the number of blocks, at most _RADIO_FIXTURE_RDS_BLOCKS_MAX.
+*/
+int _radio_fixture_rds_stream(const _radio_fixture_rds_station_s *station, uint32_t *blocks);
+
+/* Noise under an envelope, with silent stretches of zeros and of noise below _RADIO_FIXTURE_SILENCE */
+void _radio_fixture_meter_signal(int16_t *buffer, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__TIZEN_MEDIA_RADIO_FIXTURE_H__
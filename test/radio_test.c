@@ -0,0 +1,1291 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/*
+* radio_test : checks the behaviour of the radio API on top of the mock tuner backend.
+* "radio_test <case>" runs one case on a handle of its own, every case runs without an argument.
+* The exit status is 0 when every case passed.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <radio.h>
+#include <radio_backend_private.h>
+#include <radio_rds_private.h>
+#include <radio_meter_private.h>
+#include <radio_fixture.h>
+
+#define TEST_TIMEOUT_S		5
+#define TEST_SCANS			20
+#define TEST_STRESS_SCANS	200
+
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int done;
+	int events;
+} test_sync_s;
+
+static test_sync_s g_sync = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0 };
+static _radio_fixture_s g_fixture;
+
+static unsigned long long __now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void __test_reset(void)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.done = 0;
+	g_sync.events = 0;
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static void __test_signal(void)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.done = 1;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+/* Waits until a callback called __test_signal() since the last __test_reset() */
+static int __test_wait(const char *what)
+{
+	struct timespec deadline;
+	int ret = 0;
+
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += TEST_TIMEOUT_S;
+	pthread_mutex_lock(&g_sync.lock);
+	while(!g_sync.done && ret == 0)
+		ret = pthread_cond_timedwait(&g_sync.cond, &g_sync.lock, &deadline);
+	pthread_mutex_unlock(&g_sync.lock);
+	if(ret != 0)
+		fprintf(stderr, "%s : timed out\n", what);
+	return ret == 0 ? 0 : -1;
+}
+
+static int __test_events(void)
+{
+	int events;
+
+	pthread_mutex_lock(&g_sync.lock);
+	events = g_sync.events;
+	pthread_mutex_unlock(&g_sync.lock);
+	return events;
+}
+
+/* The mock posts READY right before SCAN_FINISH, waits until the handle has seen it */
+static int __test_wait_ready(radio_h radio)
+{
+	unsigned long long deadline = __now_ns() + TEST_TIMEOUT_S * 1000000000ULL;
+	radio_state_e state;
+
+	do {
+		if(radio_get_state(radio, &state) != RADIO_ERROR_NONE)
+			return -1;
+	} while(state != RADIO_STATE_READY && __now_ns() < deadline);
+	return state == RADIO_STATE_READY ? 0 : -1;
+}
+
+/* radio_get_status() must give the values of the four getters */
+static int __test_status(radio_h radio)
+{
+	radio_status_s status;
+	radio_state_e state;
+	int frequency, strength;
+	bool muted;
+	int ret = 0;
+
+	if(radio_start(radio) != RADIO_ERROR_NONE)
+		return -1;
+	if(radio_get_state(radio, &state) != RADIO_ERROR_NONE || radio_get_frequency(radio, &frequency) != RADIO_ERROR_NONE
+		|| radio_get_signal_strength(radio, &strength) != RADIO_ERROR_NONE || radio_is_muted(radio, &muted) != RADIO_ERROR_NONE
+		|| radio_get_status(radio, &status) != RADIO_ERROR_NONE)
+		ret = -1;
+	else if(status.state != state || status.frequency != frequency || status.signal_strength != strength || status.muted != muted)
+	{
+		fprintf(stderr, "status : %d %d kHz %d dBuV muted %d, getters %d %d kHz %d dBuV muted %d\n",
+			status.state, status.frequency, status.signal_strength, status.muted, state, frequency, strength, muted);
+		ret = -1;
+	}
+	if(radio_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	return ret;
+}
+
+static void __seek_completed_cb(int frequency, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.events = frequency;
+	g_sync.done = 1;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+/* Seeks with and without prediction must complete on the frequency the tuner plays */
+static int __test_seek(radio_h radio)
+{
+	int i, frequency, ret = 0;
+
+	if(radio_start(radio) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < 2 * TEST_SCANS && ret == 0; i++)
+	{
+		__test_reset();
+		if(radio_set_predictive_seek(radio, i >= TEST_SCANS) != RADIO_ERROR_NONE
+			|| radio_seek_up(radio, __seek_completed_cb, NULL) != RADIO_ERROR_NONE || __test_wait("seek") != 0
+			|| radio_get_frequency(radio, &frequency) != RADIO_ERROR_NONE)
+			ret = -1;
+		else if(frequency != g_sync.events)
+		{
+			fprintf(stderr, "seek : completed on %d kHz, playing %d kHz\n", g_sync.events, frequency);
+			ret = -1;
+		}
+	}
+	if(radio_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	return ret;
+}
+
+static void __scan_updated_cb(int frequency, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.events++;
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static void __scan_completed_cb(void *user_data)
+{
+	__test_signal();
+}
+
+/* Runs scans with the legacy callback, g_sync.events counts the stations */
+static int __test_scan(radio_h radio, int scans)
+{
+	int i;
+
+	__test_reset();
+	if(radio_set_scan_completed_cb(radio, __scan_completed_cb, NULL) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < scans; i++)
+	{
+		g_sync.done = 0;
+		if(radio_scan_start(radio, __scan_updated_cb, NULL) != RADIO_ERROR_NONE || __test_wait("scan") != 0
+			|| __test_wait_ready(radio) != 0)
+			return -1;
+	}
+	return radio_unset_scan_completed_cb(radio) == RADIO_ERROR_NONE ? 0 : -1;
+}
+
+/* Scans read from the event descriptor : every scan must finish without an overflow */
+static int __test_event_fd(radio_h radio)
+{
+	radio_event_s events[64];
+	struct pollfd pfd;
+	int i, j, count;
+	bool done;
+
+	if(radio_get_event_fd(radio, &pfd.fd) != RADIO_ERROR_NONE)
+		return -1;
+	pfd.events = POLLIN;
+	while(radio_read_events(radio, events, 64, &count) == RADIO_ERROR_NONE && count > 0)
+		;
+	for(i = 0; i < TEST_SCANS; i++)
+	{
+		if(radio_scan_start(radio, NULL, NULL) != RADIO_ERROR_NONE)
+			return -1;
+		for(done = false; !done; )
+		{
+			if(poll(&pfd, 1, TEST_TIMEOUT_S * 1000) != 1 || radio_read_events(radio, events, 64, &count) != RADIO_ERROR_NONE)
+				return -1;
+			for(j = 0; j < count; j++)
+			{
+				if(events[j].type == RADIO_EVENT_SCAN_FINISH)
+					done = true;
+				else if(events[j].type == RADIO_EVENT_OVERFLOW)
+				{
+					fprintf(stderr, "event_fd : overflow during scan %d\n", i);
+					return -1;
+				}
+			}
+		}
+		if(__test_wait_ready(radio) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/*
+* Command queue : each burst is a dial turned over 8 channels then start, seek up and stop, all asynchronous.
+* Every command must complete once : the frequency changes either run or are cancelled by the next one, and the other
+* commands complete in order, after the last frequency.
+*/
+#define TEST_BURSTS				50
+#define TEST_BURST_FREQUENCIES	8
+
+static radio_command_e g_completed[TEST_BURST_FREQUENCIES + 3];
+static radio_error_e g_completed_error[TEST_BURST_FREQUENCIES + 3];
+static int g_completed_frequency[TEST_BURST_FREQUENCIES + 3];
+
+static void __command_completed_cb(radio_command_e command, radio_error_e error, int frequency, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	if(g_sync.events < TEST_BURST_FREQUENCIES + 3)
+	{
+		g_completed[g_sync.events] = command;
+		g_completed_error[g_sync.events] = error;
+		g_completed_frequency[g_sync.events] = frequency;
+	}
+	g_sync.events++;
+	if(command == RADIO_COMMAND_STOP)
+	{
+		g_sync.done = 1;
+		pthread_cond_signal(&g_sync.cond);
+	}
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static int __test_command_queue(radio_h radio)
+{
+	int i, j, last = 0, cancelled = 0, ret;
+
+	for(i = 0; i < TEST_BURSTS; i++)
+	{
+		__test_reset();
+		for(j = 0; j < TEST_BURST_FREQUENCIES; j++)
+		{
+			last = 87500 + ((i + j) % 200) * 100;
+			if(radio_set_frequency_async(radio, last, __command_completed_cb, NULL) != RADIO_ERROR_NONE)
+				return -1;
+		}
+		if(radio_start_async(radio, __command_completed_cb, NULL) != RADIO_ERROR_NONE
+			|| radio_seek_up_async(radio, __command_completed_cb, NULL) != RADIO_ERROR_NONE
+			|| radio_stop_async(radio, __command_completed_cb, NULL) != RADIO_ERROR_NONE
+			|| __test_wait("command_queue") != 0)
+			return -1;
+
+		ret = g_sync.events == TEST_BURST_FREQUENCIES + 3 ? 0 : -1;
+		for(j = 0; j < TEST_BURST_FREQUENCIES + 3 && ret == 0; j++)
+		{
+			if(j < TEST_BURST_FREQUENCIES && g_completed[j] != RADIO_COMMAND_SET_FREQUENCY)
+				ret = -1;
+			else if(j < TEST_BURST_FREQUENCIES - 1 && g_completed_error[j] == RADIO_ERROR_CANCELLED)
+				cancelled++;
+			else if(g_completed_error[j] != RADIO_ERROR_NONE)
+				ret = -1;
+		}
+		j = TEST_BURST_FREQUENCIES - 1;
+		if(ret != 0 || g_completed_frequency[j] != last || g_completed[j + 1] != RADIO_COMMAND_START
+			|| g_completed[j + 2] != RADIO_COMMAND_SEEK_UP || g_completed[j + 3] != RADIO_COMMAND_STOP)
+		{
+			fprintf(stderr, "command_queue : burst %d completed out of order (%d events)\n", i, g_sync.events);
+			return -1;
+		}
+	}
+	if(cancelled == 0)
+	{
+		fprintf(stderr, "command_queue : no frequency change was replaced in %d bursts\n", TEST_BURSTS);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+* Callback stress : a thread keeps registering two callback/user data pairs and unregistering them
+* while the main thread runs scans. A callback called with the user data of the other pair fails the case.
+*/
+static int g_stress_cookie[2];
+static int g_stress_torn;
+static int g_stress_stop;
+
+static void __stress_completed_a_cb(void *user_data)
+{
+	if(user_data != &g_stress_cookie[0])
+		__atomic_add_fetch(&g_stress_torn, 1, __ATOMIC_RELAXED);
+}
+
+static void __stress_completed_b_cb(void *user_data)
+{
+	if(user_data != &g_stress_cookie[1])
+		__atomic_add_fetch(&g_stress_torn, 1, __ATOMIC_RELAXED);
+}
+
+static void __stress_interrupted_cb(radio_interrupted_code_e code, void *user_data)
+{
+}
+
+static void *__stress_register_thread(void *data)
+{
+	radio_h radio = (radio_h)data;
+	int i = 0;
+	while(!__atomic_load_n(&g_stress_stop, __ATOMIC_RELAXED))
+	{
+		switch(i++ % 3)
+		{
+			case 0: radio_set_scan_completed_cb(radio, __stress_completed_a_cb, &g_stress_cookie[0]); break;
+			case 1: radio_set_scan_completed_cb(radio, __stress_completed_b_cb, &g_stress_cookie[1]); break;
+			default: radio_unset_scan_completed_cb(radio); break;
+		}
+		radio_set_interrupted_cb(radio, __stress_interrupted_cb, NULL);
+		radio_unset_interrupted_cb(radio);
+	}
+	return NULL;
+}
+
+static int __test_callback_stress(radio_h radio)
+{
+	pthread_t thread;
+	int i;
+
+	g_stress_torn = 0;
+	g_stress_stop = 0;
+	if(pthread_create(&thread, NULL, __stress_register_thread, radio) != 0)
+		return -1;
+	for(i = 0; i < TEST_STRESS_SCANS; i++)
+	{
+		if(radio_scan_start(radio, NULL, NULL) != RADIO_ERROR_NONE || __test_wait_ready(radio) != 0)
+			break;
+	}
+	__atomic_store_n(&g_stress_stop, 1, __ATOMIC_RELAXED);
+	pthread_join(thread, NULL);
+	radio_unset_scan_completed_cb(radio);
+	if(i < TEST_STRESS_SCANS || g_stress_torn != 0)
+	{
+		fprintf(stderr, "callback_stress : %d torn callbacks after %d scans\n", g_stress_torn, i);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+* Listeners : scans with extra scan listeners, while a thread keeps adding and removing one more.
+* Every listener registered for the whole case must see as many stations as the legacy callback.
+*/
+#define TEST_LISTENERS	4
+
+static int g_listener_events[TEST_LISTENERS];
+
+static void __listener_updated_cb(int frequency, void *user_data)
+{
+	__atomic_add_fetch((int *)user_data, 1, __ATOMIC_RELAXED);
+}
+
+static void *__listener_churn_thread(void *data)
+{
+	radio_h radio = (radio_h)data;
+	int id;
+	while(!__atomic_load_n(&g_stress_stop, __ATOMIC_RELAXED))
+	{
+		if(radio_add_scan_updated_cb(radio, __listener_updated_cb, &g_stress_cookie[0], &id) != RADIO_ERROR_NONE
+			|| radio_remove_cb(radio, id) != RADIO_ERROR_NONE)
+			__atomic_add_fetch(&g_stress_torn, 1, __ATOMIC_RELAXED);
+	}
+	return NULL;
+}
+
+static int __test_scan_listeners(radio_h radio)
+{
+	int ids[TEST_LISTENERS];
+	pthread_t thread;
+	int i, ret;
+
+	for(i = 0; i < TEST_LISTENERS; i++)
+	{
+		g_listener_events[i] = 0;
+		if(radio_add_scan_updated_cb(radio, __listener_updated_cb, &g_listener_events[i], &ids[i]) != RADIO_ERROR_NONE)
+			return -1;
+	}
+	g_stress_torn = 0;
+	g_stress_stop = 0;
+	if(pthread_create(&thread, NULL, __listener_churn_thread, radio) != 0)
+		return -1;
+	ret = __test_scan(radio, TEST_SCANS);
+	__atomic_store_n(&g_stress_stop, 1, __ATOMIC_RELAXED);
+	pthread_join(thread, NULL);
+
+	for(i = 0; i < TEST_LISTENERS; i++)
+	{
+		if(radio_remove_cb(radio, ids[i]) != RADIO_ERROR_NONE || g_listener_events[i] != g_sync.events)
+		{
+			fprintf(stderr, "scan_listeners : listener %d saw %d stations out of %d\n", i, g_listener_events[i], g_sync.events);
+			ret = -1;
+		}
+	}
+	if(g_stress_torn != 0 || radio_remove_cb(radio, ids[0]) != RADIO_ERROR_INVALID_PARAMETER)
+	{
+		fprintf(stderr, "scan_listeners : %d failed registrations\n", g_stress_torn);
+		ret = -1;
+	}
+	return ret;
+}
+
+/*
+* Interrupted sweeps : the sound manager interrupts the radio while software scans report in batches, the message
+* callback flushes the batch the sweep thread keeps adding to. Every station must be delivered once, in order.
+*/
+#define TEST_BATCH_COUNT	4
+
+static int g_batch_stations;
+static int g_batch_torn;
+static int g_interruptions;
+
+static void __batch_cb(const radio_station_s *stations, int count, void *user_data)
+{
+	_radio_mock_config_s *config = &g_fixture.config;
+	int i, channel;
+
+	for(i = 0; i < count; i++)
+	{
+		channel = (stations[i].frequency - config->band_min) / config->band_step;
+		if(channel % 3 != 1 || channel / 3 >= config->station_count || (i > 0 && stations[i].frequency <= stations[i - 1].frequency))
+			__atomic_add_fetch(&g_batch_torn, 1, __ATOMIC_RELAXED);
+	}
+	__atomic_add_fetch(&g_batch_stations, count, __ATOMIC_RELAXED);
+}
+
+static void __count_interrupted_cb(radio_interrupted_code_e code, void *user_data)
+{
+	__atomic_add_fetch(&g_interruptions, 1, __ATOMIC_RELEASE);
+}
+
+static int __test_interrupt_sweep(radio_h radio)
+{
+	_radio_mock_config_s *config = &g_fixture.config;
+	unsigned long long deadline;
+	int i, found, ret = 0;
+
+	g_batch_stations = 0;
+	g_batch_torn = 0;
+	g_interruptions = 0;
+	__test_reset();
+	if(radio_set_scan_batch_cb(radio, TEST_BATCH_COUNT, 0, __batch_cb, NULL) != RADIO_ERROR_NONE
+		|| radio_set_interrupted_cb(radio, __count_interrupted_cb, NULL) != RADIO_ERROR_NONE
+		|| radio_set_scan_completed_cb(radio, __scan_completed_cb, NULL) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < TEST_STRESS_SCANS && ret == 0; i++)
+	{
+		g_sync.done = 0;
+		found = __test_events();
+		if(radio_scan_range_start(radio, config->band_min, config->band_max, 0, __scan_updated_cb, NULL) != RADIO_ERROR_NONE)
+		{
+			ret = -1;
+			break;
+		}
+		/* from right after the start to the middle of the band */
+		deadline = __now_ns() + TEST_TIMEOUT_S * 1000000000ULL;
+		while(__test_events() < found + i % (config->station_count / 2) && __now_ns() < deadline)
+			;
+		_radio_mock_interrupt(RADIO_INTERRUPTED_BY_OTHER_APP);
+		while(__atomic_load_n(&g_interruptions, __ATOMIC_ACQUIRE) <= i && __now_ns() < deadline)
+			;
+		if(__test_wait("interrupt_sweep") != 0 || __test_wait_ready(radio) != 0 || g_interruptions != i + 1)
+			ret = -1;
+	}
+	radio_unset_scan_completed_cb(radio);
+	radio_unset_interrupted_cb(radio);
+	radio_unset_scan_batch_cb(radio);
+	if(ret != 0 || g_batch_torn != 0 || g_batch_stations != g_sync.events || g_sync.events != i * config->station_count)
+	{
+		fprintf(stderr, "interrupt_sweep : %d scans, %d stations found, %d batched, %d out of order\n",
+			i, g_sync.events, g_batch_stations, g_batch_torn);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+* Idle suspend : the handle is left ready past its idle timeout before every radio_start(), which resumes the device.
+* The tuner must be back on the frequency set before the suspend, and every start must have resumed the device.
+*/
+#define TEST_IDLE_TIMEOUT_MS	100
+#define TEST_IDLE_RESUMES		5
+
+static bool __count_resume_cb(const radio_statistics_s *statistics, void *user_data)
+{
+	if(strcmp(statistics->name, "device:resume") != 0)
+		return true;
+	*(unsigned long long *)user_data = statistics->calls;
+	return false;
+}
+
+static int __test_idle_resume(radio_h radio)
+{
+	unsigned long long resumes = 0, resumed = 0;
+	radio_state_e state;
+	int i, frequency;
+
+	radio_foreach_statistics(__count_resume_cb, &resumes);
+	if(radio_set_idle_timeout(radio, TEST_IDLE_TIMEOUT_MS) != RADIO_ERROR_NONE)
+		return -1;
+	for(i = 0; i < TEST_IDLE_RESUMES; i++)
+	{
+		int expected = 87500 + (i % 100) * 200;
+		if(radio_get_state(radio, &state) != RADIO_ERROR_NONE || state != RADIO_STATE_READY
+			|| radio_set_frequency(radio, expected) != RADIO_ERROR_NONE)
+			return -1;
+		usleep((TEST_IDLE_TIMEOUT_MS + 50) * 1000);
+		if(radio_start(radio) != RADIO_ERROR_NONE)
+			return -1;
+		if(radio_refresh(radio) != RADIO_ERROR_NONE || radio_get_frequency(radio, &frequency) != RADIO_ERROR_NONE
+			|| frequency != expected || radio_stop(radio) != RADIO_ERROR_NONE)
+		{
+			fprintf(stderr, "idle_resume : frequency %d restored as %d\n", expected, frequency);
+			return -1;
+		}
+	}
+	if(radio_set_idle_timeout(radio, 0) != RADIO_ERROR_NONE)
+		return -1;
+	radio_foreach_statistics(__count_resume_cb, &resumed);
+	if(resumed - resumes != TEST_IDLE_RESUMES)
+	{
+		fprintf(stderr, "idle_resume : %llu resumes out of %d\n", resumed - resumes, TEST_IDLE_RESUMES);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+* Realize retry : a device which failed to open, lazily, asynchronously or when resumed after an idle suspend, must be
+* opened by the next call which needs it. The resumed one must come back on its frequency.
+*/
+static void __ready_cb(radio_error_e error, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.events = error;
+	g_sync.done = 1;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static int __test_realize_retry(radio_h radio)
+{
+	radio_h other = NULL;
+	int frequency, expected = g_fixture.config.stations[3].frequency;
+	int ret = 0;
+
+	_radio_mock_fail_realize(1);
+	if(radio_create_lazy(&other) != RADIO_ERROR_NONE)
+		ret = -1;
+	else if(radio_start(other) == RADIO_ERROR_NONE || radio_start(other) != RADIO_ERROR_NONE || radio_stop(other) != RADIO_ERROR_NONE)
+	{
+		fprintf(stderr, "realize_retry : lazy realize not retried\n");
+		ret = -1;
+	}
+	if(other != NULL && radio_destroy(other) != RADIO_ERROR_NONE)
+		ret = -1;
+
+	other = NULL;
+	__test_reset();
+	_radio_mock_fail_realize(1);
+	if(ret == 0 && (radio_create_async(&other, __ready_cb, NULL) != RADIO_ERROR_NONE || __test_wait("realize_retry") != 0))
+		ret = -1;
+	else if(ret == 0 && (g_sync.events == RADIO_ERROR_NONE || radio_start(other) != RADIO_ERROR_NONE || radio_stop(other) != RADIO_ERROR_NONE))
+	{
+		fprintf(stderr, "realize_retry : asynchronous realize not retried\n");
+		ret = -1;
+	}
+	if(other != NULL && radio_destroy(other) != RADIO_ERROR_NONE)
+		ret = -1;
+
+	if(ret == 0 && (radio_set_idle_timeout(radio, TEST_IDLE_TIMEOUT_MS) != RADIO_ERROR_NONE
+		|| radio_set_frequency(radio, expected) != RADIO_ERROR_NONE))
+		ret = -1;
+	if(ret == 0)
+	{
+		usleep((TEST_IDLE_TIMEOUT_MS + 50) * 1000);
+		_radio_mock_fail_realize(1);
+		if(radio_start(radio) == RADIO_ERROR_NONE || radio_start(radio) != RADIO_ERROR_NONE
+			|| radio_get_frequency(radio, &frequency) != RADIO_ERROR_NONE || frequency != expected
+			|| radio_stop(radio) != RADIO_ERROR_NONE)
+		{
+			fprintf(stderr, "realize_retry : resume not retried\n");
+			ret = -1;
+		}
+	}
+	_radio_mock_fail_realize(0);
+	if(radio_set_idle_timeout(radio, 0) != RADIO_ERROR_NONE)
+		ret = -1;
+	return ret;
+}
+
+/*
+* Alternate frequency : the radio plays the weakest station with the strongest one as its alternate, the monitor must
+* switch over to it, and the tuner time spent in the windows must stay within the configured share.
+*/
+#define TEST_AF_MARGIN			10
+#define TEST_AF_TUNER_SHARE		20
+#define TEST_AF_SWITCHES		2
+
+static void __alternate_frequency_cb(int frequency, int strength, bool switched, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.events = switched ? frequency : -1;
+	g_sync.done = 1;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+static bool __af_window_cb(const radio_statistics_s *statistics, void *user_data)
+{
+	if(strcmp(statistics->name, "device:af_window") != 0)
+		return true;
+	*(unsigned long long *)user_data = statistics->total_ns;
+	return false;
+}
+
+static int __test_alternate_frequency(radio_h radio)
+{
+	int weak = g_fixture.config.stations[0].frequency;
+	int strong = g_fixture.config.stations[29].frequency;
+	unsigned long long windows = 0, windowed = 0, elapsed = 0;
+	int i, frequency, ret = 0;
+
+	if(radio_set_alternate_frequency_cb(radio, TEST_AF_MARGIN, TEST_AF_TUNER_SHARE, true, __alternate_frequency_cb, NULL) != RADIO_ERROR_NONE)
+		return -1;
+	radio_foreach_statistics(__af_window_cb, &windows);
+	for(i = 0; i < TEST_AF_SWITCHES && ret == 0; i++)
+	{
+		unsigned long long t0;
+		__test_reset();
+		if(radio_set_frequency(radio, weak) != RADIO_ERROR_NONE || radio_set_alternate_frequencies(radio, &strong, 1) != RADIO_ERROR_NONE)
+			return -1;
+		t0 = __now_ns();
+		if(radio_start(radio) != RADIO_ERROR_NONE || __test_wait("alternate_frequency") != 0)
+			return -1;
+		elapsed += __now_ns() - t0;
+		if(g_sync.events != strong || radio_get_frequency(radio, &frequency) != RADIO_ERROR_NONE || frequency != strong)
+		{
+			fprintf(stderr, "alternate_frequency : switched to %d, playing %d instead of %d\n", g_sync.events, frequency, strong);
+			ret = -1;
+		}
+		if(radio_stop(radio) != RADIO_ERROR_NONE)
+			ret = -1;
+	}
+	if(radio_unset_alternate_frequency_cb(radio) != RADIO_ERROR_NONE || radio_set_alternate_frequencies(radio, NULL, 0) != RADIO_ERROR_NONE)
+		return -1;
+	if(ret != 0)
+		return ret;
+	radio_foreach_statistics(__af_window_cb, &windowed);
+	if((windowed - windows) * 100 > elapsed * TEST_AF_TUNER_SHARE)
+	{
+		fprintf(stderr, "alternate_frequency : windows took %.2f%% of the tuner time, above %d%%\n",
+			100.0 * (windowed - windows) / elapsed, TEST_AF_TUNER_SHARE);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+* Audio tap : the mock plays the fixture file in real time. Readers follow the tap, through the handle and through the
+* descriptor, and check that the frames come in order without any loss. A reader much slower than the ring must then
+* see its periods counted as lost, and a reader outliving the tap must drain it and then see it is closed.
+*/
+#define TEST_PCM_PERIOD_FRAMES	256
+#define TEST_PCM_PERIODS		8
+#define TEST_PCM_READERS		3
+#define TEST_PCM_READS			200
+
+typedef struct {
+	radio_pcm_reader_h reader;
+	int errors;
+	int lost;
+} test_pcm_reader_s;
+
+static void *__pcm_reader_thread(void *data)
+{
+	test_pcm_reader_s *pcm = (test_pcm_reader_s *)data;
+	radio_pcm_period_s period;
+	unsigned long long expected = 0;
+	short first = 0;
+	bool overrun;
+	int i, k;
+
+	for(i = 0; i < TEST_PCM_READS; i++)
+	{
+		if(radio_pcm_reader_acquire(pcm->reader, 1000, &period) != RADIO_ERROR_NONE)
+		{
+			pcm->errors++;
+			break;
+		}
+		pcm->lost += period.lost;
+		if(i > 0 && (period.sequence != expected + period.lost
+			|| period.frames[0] != (short)(first + TEST_PCM_PERIOD_FRAMES * (1 + period.lost))))
+			pcm->errors++;
+		for(k = 1; k < period.frame_count; k++)
+		{
+			if(period.frames[k * 2] != (short)(period.frames[0] + k) || period.frames[k * 2 + 1] != (short)~period.frames[k * 2])
+			{
+				pcm->errors++;
+				break;
+			}
+		}
+		expected = period.sequence + 1;
+		first = period.frames[0];
+		if(radio_pcm_reader_release(pcm->reader, &overrun) != RADIO_ERROR_NONE || overrun)
+			pcm->errors++;
+	}
+	return NULL;
+}
+
+static int __test_pcm_tap(radio_h radio)
+{
+	test_pcm_reader_s readers[TEST_PCM_READERS];
+	pthread_t threads[TEST_PCM_READERS];
+	radio_pcm_period_s period;
+	int i, fd, started = 0, lost = 0, ret = 0;
+	bool overrun = false;
+
+	if(radio_pcm_tap_start(radio, TEST_PCM_PERIOD_FRAMES, TEST_PCM_PERIODS) != RADIO_ERROR_NONE
+		|| radio_pcm_tap_get_fd(radio, &fd) != RADIO_ERROR_NONE)
+		return -1;
+	memset(readers, 0, sizeof(readers));
+	for(i = 0; i < TEST_PCM_READERS; i++)
+	{
+		/* the last one maps the ring like another process would */
+		if((i < TEST_PCM_READERS - 1 ? radio_pcm_reader_create(radio, &readers[i].reader)
+			: radio_pcm_reader_create_from_fd(fd, &readers[i].reader)) != RADIO_ERROR_NONE)
+			ret = -1;
+	}
+	if(ret == 0 && radio_start(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	for(i = 0; i < TEST_PCM_READERS && ret == 0; i++, started++)
+	{
+		if(pthread_create(&threads[i], NULL, __pcm_reader_thread, &readers[i]) != 0)
+			ret = -1;
+	}
+	for(i = 0; i < started; i++)
+	{
+		pthread_join(threads[i], NULL);
+		if(readers[i].errors > 0 || readers[i].lost > 0)
+		{
+			fprintf(stderr, "pcm_tap : reader %d, %d errors, %d periods lost\n", i, readers[i].errors, readers[i].lost);
+			ret = -1;
+		}
+	}
+
+	/* a reader sleeping for longer than the ring lasts */
+	if(ret == 0)
+	{
+		for(i = 0; i < 4; i++)
+		{
+			if(radio_pcm_reader_acquire(readers[0].reader, 1000, &period) != RADIO_ERROR_NONE)
+				break;
+			lost += period.lost;
+			usleep(TEST_PCM_PERIODS * 2 * TEST_PCM_PERIOD_FRAMES * 1000000ULL / _RADIO_FIXTURE_PCM_RATE);
+			radio_pcm_reader_release(readers[0].reader, &overrun);
+		}
+		if(i < 4 || lost == 0 || !overrun)
+		{
+			fprintf(stderr, "pcm_tap : slow reader, %d periods lost, overrun %d\n", lost, overrun);
+			ret = -1;
+		}
+	}
+	radio_stop(radio);
+	if(radio_pcm_tap_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	while(ret == 0 && radio_pcm_reader_acquire(readers[1].reader, -1, &period) == RADIO_ERROR_NONE)
+		;
+	if(ret == 0 && radio_pcm_reader_acquire(readers[1].reader, -1, &period) != RADIO_ERROR_INVALID_STATE)
+	{
+		fprintf(stderr, "pcm_tap : the reader of a closed tap is not told so\n");
+		ret = -1;
+	}
+	for(i = 0; i < TEST_PCM_READERS; i++)
+	{
+		if(readers[i].reader != NULL)
+			radio_pcm_reader_destroy(readers[i].reader);
+	}
+	return ret;
+}
+
+/*
+* Time-shift : the tap is recorded into a two second buffer for three seconds, so that it wraps around. Seeks must land
+* within a period and a bit of the requested delay, and the audio read from there must follow the file without a gap.
+*/
+#define TEST_TIMESHIFT_SECONDS		2
+#define TEST_TIMESHIFT_RECORD_MS	3000
+
+static int __test_timeshift_check(radio_h radio, int delay_ms)
+{
+	short frames[2 * TEST_PCM_PERIOD_FRAMES];
+	int delay, buffered, count, k;
+
+	if(radio_timeshift_seek(radio, delay_ms) != RADIO_ERROR_NONE
+		|| radio_timeshift_get_position(radio, &delay, &buffered) != RADIO_ERROR_NONE)
+		return -1;
+	if(delay > buffered || (delay_ms < buffered - 100 && (delay < delay_ms - 50 || delay > delay_ms + 50)))
+	{
+		fprintf(stderr, "timeshift : seek %d ms back landed %d ms back, %d ms buffered\n", delay_ms, delay, buffered);
+		return -1;
+	}
+	if(radio_timeshift_read(radio, frames, TEST_PCM_PERIOD_FRAMES, &count) != RADIO_ERROR_NONE
+		|| count != (delay_ms > 0 ? TEST_PCM_PERIOD_FRAMES : 0))
+		return -1;
+	for(k = 1; k < count; k++)
+	{
+		if(frames[k * 2] != (short)(frames[0] + k))
+		{
+			fprintf(stderr, "timeshift : gap at frame %d of a read %d ms back\n", k, delay_ms);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int __test_timeshift(radio_h radio)
+{
+	char path[] = "/tmp/radio_test_timeshift_XXXXXX";
+	int fd, delay, buffered, ret = 0;
+
+	fd = mkstemp(path);
+	if(fd < 0)
+		return -1;
+	close(fd);
+	if(radio_pcm_tap_start(radio, TEST_PCM_PERIOD_FRAMES, 64) != RADIO_ERROR_NONE
+		|| radio_timeshift_start(radio, path, TEST_TIMESHIFT_SECONDS) != RADIO_ERROR_NONE
+		|| radio_start(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	if(ret == 0)
+	{
+		usleep(TEST_TIMESHIFT_RECORD_MS * 1000);
+		if(radio_timeshift_pause(radio) != RADIO_ERROR_NONE || radio_timeshift_get_position(radio, &delay, &buffered) != RADIO_ERROR_NONE
+			|| buffered < TEST_TIMESHIFT_SECONDS * 1000 || radio_timeshift_resume(radio) != RADIO_ERROR_NONE)
+		{
+			fprintf(stderr, "timeshift : %d ms buffered after %d ms\n", buffered, TEST_TIMESHIFT_RECORD_MS);
+			ret = -1;
+		}
+	}
+	if(ret == 0 && (__test_timeshift_check(radio, 0) != 0 || __test_timeshift_check(radio, 500) != 0
+		|| __test_timeshift_check(radio, 1500) != 0 || __test_timeshift_check(radio, 60000) != 0))
+		ret = -1;
+	radio_stop(radio);
+	if(radio_timeshift_stop(radio) != RADIO_ERROR_NONE || radio_pcm_tap_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	unlink(path);
+	return ret;
+}
+
+/*
+* Recording : the tap is recorded as PCM at its own rate, then as IMA ADPCM at 16 kHz. No frame may be dropped and the
+* file must hold its header and every byte written. The PCM file must follow the fixture file without a gap.
+*/
+#define TEST_RECORDING_MS		1000
+#define TEST_RECORDING_RATE		16000
+
+static int __test_recording_file(radio_h radio, const char *path, radio_recording_format_e format, int sample_rate)
+{
+	radio_recording_status_s status;
+	struct stat st;
+
+	if(radio_recording_start(radio, path, format, sample_rate) != RADIO_ERROR_NONE)
+		return -1;
+	usleep(TEST_RECORDING_MS * 1000);
+	if(radio_recording_stop(radio) != RADIO_ERROR_NONE || radio_recording_get_status(radio, &status) != RADIO_ERROR_NONE
+		|| stat(path, &st) != 0)
+		return -1;
+	if(status.recording || status.error != RADIO_ERROR_NONE || status.frames_dropped != 0 || status.bytes_written == 0
+		|| (unsigned long long)st.st_size != (format == RADIO_RECORDING_FORMAT_WAV_PCM ? 44 : 60) + status.bytes_written)
+	{
+		fprintf(stderr, "recording : %llu frames, %llu dropped, %llu bytes in a file of %lld, error 0x%x\n", status.frames_recorded,
+			status.frames_dropped, status.bytes_written, (long long)st.st_size, status.error);
+		return -1;
+	}
+	return 0;
+}
+
+static int __test_recording(radio_h radio)
+{
+	char path[] = "/tmp/radio_test_recording_XXXXXX";
+	short frames[2 * TEST_PCM_PERIOD_FRAMES];
+	int fd, k, ret = 0;
+
+	fd = mkstemp(path);
+	if(fd < 0)
+		return -1;
+	close(fd);
+	if(radio_pcm_tap_start(radio, TEST_PCM_PERIOD_FRAMES, 64) != RADIO_ERROR_NONE || radio_start(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	if(ret == 0 && __test_recording_file(radio, path, RADIO_RECORDING_FORMAT_WAV_PCM, 0) != 0)
+		ret = -1;
+	if(ret == 0)
+	{
+		fd = open(path, O_RDONLY);
+		if(fd < 0 || pread(fd, frames, sizeof(frames), 44) != sizeof(frames))
+			ret = -1;
+		for(k = 1; k < TEST_PCM_PERIOD_FRAMES && ret == 0; k++)
+		{
+			if(frames[k * 2] != (short)(frames[0] + k) || frames[k * 2 + 1] != (short)~frames[k * 2])
+			{
+				fprintf(stderr, "recording : gap at frame %d of the PCM file\n", k);
+				ret = -1;
+			}
+		}
+		if(fd >= 0)
+			close(fd);
+	}
+	if(ret == 0 && __test_recording_file(radio, path, RADIO_RECORDING_FORMAT_WAV_IMA_ADPCM, TEST_RECORDING_RATE) != 0)
+		ret = -1;
+	radio_stop(radio);
+	if(radio_pcm_tap_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	unlink(path);
+	return ret;
+}
+
+/*
+* RDS : the decoder must recover the exact metadata from the fixture streams, and the same streams played by the mock
+* must reach the application. Coming back to a station must report its cached metadata at once.
+*/
+static int g_rds_frequency;
+
+static int __test_rds_check(const _radio_fixture_rds_station_s *station, const radio_rds_info_s *info, const char *from)
+{
+	char radio_text[RADIO_RDS_RADIO_TEXT_LENGTH + 1];
+	int i;
+
+	snprintf(radio_text, sizeof(radio_text), "%.*s", (int)strlen(station->radio_text) - 1, station->radio_text);
+	if(info->fields != (station->af_count > 0 ? _RADIO_FIXTURE_RDS_ALL : _RADIO_FIXTURE_RDS_ALL & ~RADIO_RDS_FIELD_AF)
+		|| info->pi != station->pi || info->pty != station->pty || strcmp(info->ps, station->ps) != 0
+		|| strcmp(info->radio_text, radio_text) != 0 || info->af_count != station->af_count)
+	{
+		fprintf(stderr, "rds : %s fields 0x%x pi 0x%x pty %d ps \"%s\" rt \"%s\" af %d\n", from, info->fields, info->pi, info->pty,
+			info->ps, info->radio_text, info->af_count);
+		return -1;
+	}
+	for(i = 0; i < station->af_count; i++)
+	{
+		if(info->af[i] != station->af[i])
+		{
+			fprintf(stderr, "rds : %s af %d is %d\n", from, i, info->af[i]);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int __test_rds_decoder(void)
+{
+	static uint32_t stream[_RADIO_FIXTURE_RDS_BLOCKS_MAX];
+	static _radio_rds_cache_s cache;
+	_radio_rds_decoder_s decoder;
+	radio_rds_info_s info;
+	int i, n, ret = 0;
+
+	_radio_rds_cache_init(&cache);
+	_radio_rds_decoder_init(&decoder);
+	for(i = 0; i < _RADIO_FIXTURE_RDS_STATIONS && ret == 0; i++)
+	{
+		n = _radio_fixture_rds_stream(&_radio_fixture_rds_stations[i], stream);
+		_radio_rds_decoder_tune(&decoder, &cache, 90000 + i * 100);
+		_radio_rds_decode(&decoder, &cache, stream, n);
+		_radio_rds_cache_get(&cache, 90000 + i * 100, &info);
+		ret = __test_rds_check(&_radio_fixture_rds_stations[i], &info, "fixture");
+	}
+	if(ret == 0 && (decoder.corrected == 0 || decoder.uncorrectable == 0))
+	{
+		fprintf(stderr, "rds : %llu blocks corrected, %llu beyond repair\n", (unsigned long long)decoder.corrected,
+			(unsigned long long)decoder.uncorrectable);
+		ret = -1;
+	}
+	if(ret == 0 && _radio_rds_decoder_tune(&decoder, &cache, 90000) != _RADIO_FIXTURE_RDS_ALL)
+	{
+		fprintf(stderr, "rds : metadata lost by the retune\n");
+		ret = -1;
+	}
+	_radio_rds_cache_deinit(&cache);
+	return ret;
+}
+
+static void __rds_changed_cb(int frequency, unsigned int fields, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	if(frequency == g_rds_frequency)
+	{
+		g_sync.events |= fields;
+		pthread_cond_signal(&g_sync.cond);
+	}
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+/* Tunes a station and waits for the fields */
+static int __test_rds_tune(radio_h radio, int frequency, unsigned int fields)
+{
+	struct timespec deadline;
+	int ret = 0;
+
+	pthread_mutex_lock(&g_sync.lock);
+	g_rds_frequency = frequency;
+	g_sync.events = 0;
+	pthread_mutex_unlock(&g_sync.lock);
+	if(radio_set_frequency(radio, frequency) != RADIO_ERROR_NONE)
+		return -1;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += 2;
+	pthread_mutex_lock(&g_sync.lock);
+	while(((unsigned int)g_sync.events & fields) != fields && ret == 0)
+		ret = pthread_cond_timedwait(&g_sync.cond, &g_sync.lock, &deadline);
+	pthread_mutex_unlock(&g_sync.lock);
+	if(ret != 0)
+	{
+		fprintf(stderr, "rds : 0x%x of 0x%x received on %d kHz\n", g_sync.events, fields, frequency);
+		return -1;
+	}
+	return 0;
+}
+
+static int __test_rds(radio_h radio)
+{
+	const _radio_mock_config_s *config = &g_fixture.config;
+	radio_rds_info_s info;
+	int ret = 0;
+
+	if(__test_rds_decoder() != 0)
+		return -1;
+	if(radio_set_rds_changed_cb(radio, __rds_changed_cb, NULL) != RADIO_ERROR_NONE || radio_start(radio) != RADIO_ERROR_NONE)
+		return -1;
+	if(__test_rds_tune(radio, config->stations[0].frequency, _RADIO_FIXTURE_RDS_ALL) != 0
+		|| radio_get_rds_info(radio, 0, &info) != RADIO_ERROR_NONE || __test_rds_check(&_radio_fixture_rds_stations[0], &info, "mock") != 0
+		|| __test_rds_tune(radio, config->stations[1].frequency, _RADIO_FIXTURE_RDS_ALL & ~RADIO_RDS_FIELD_AF) != 0
+		|| radio_get_rds_info(radio, 0, &info) != RADIO_ERROR_NONE || __test_rds_check(&_radio_fixture_rds_stations[1], &info, "mock") != 0
+		|| __test_rds_tune(radio, config->stations[0].frequency, _RADIO_FIXTURE_RDS_ALL) != 0)
+		ret = -1;
+	if(radio_unset_rds_changed_cb(radio) != RADIO_ERROR_NONE || radio_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	return ret;
+}
+
+/*
+* Level meter : the kernel must give the results of its scalar reference on slices of a synthetic buffer at every
+* alignment and length. Through the tap, muting the radio must be reported as dead air, and the audio coming back as its end.
+*/
+#define TEST_METER_SAMPLES		(1024 * 1024)
+#define TEST_METER_SLICES		2000
+#define TEST_METER_INTERVAL_MS	20
+#define TEST_METER_DEAD_AIR_MS	200
+
+static int g_level_peak;
+static int g_level_silence_ms;
+
+static int __test_meter_check(const int16_t *buffer, int count, int level)
+{
+	_radio_meter_block_s block, reference;
+
+	_radio_meter_scan(buffer, count, level, &block);
+	_radio_meter_scan_scalar(buffer, count, level, &reference);
+	if(block.peak != reference.peak || block.energy != reference.energy || block.silent_tail != reference.silent_tail)
+	{
+		fprintf(stderr, "meter : %d samples, peak %d energy %llu tail %d instead of %d %llu %d\n", count, block.peak,
+			(unsigned long long)block.energy, block.silent_tail, reference.peak, (unsigned long long)reference.energy,
+			reference.silent_tail);
+		return -1;
+	}
+	return 0;
+}
+
+static int __test_meter_kernel(void)
+{
+	int16_t *buffer = (int16_t *)malloc(sizeof(int16_t) * TEST_METER_SAMPLES);
+	unsigned int seed = 1;
+	int i, offset, length, ret = 0;
+
+	if(buffer == NULL)
+		return -1;
+	_radio_fixture_meter_signal(buffer, TEST_METER_SAMPLES);
+	for(i = 0; i < TEST_METER_SLICES && ret == 0; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		offset = (seed >> 8) % (TEST_METER_SAMPLES - 20000);
+		length = i < 64 ? i : (int)((seed >> 4) % 20000);
+		ret = __test_meter_check(buffer + offset, length, i % 3 == 0 ? 0 : _RADIO_FIXTURE_SILENCE);
+	}
+	if(ret == 0)
+		ret = __test_meter_check(buffer, TEST_METER_SAMPLES, _RADIO_FIXTURE_SILENCE);
+	free(buffer);
+	return ret;
+}
+
+static void __level_cb(int peak, int rms, int silence_ms, void *user_data)
+{
+	pthread_mutex_lock(&g_sync.lock);
+	g_level_peak = peak;
+	g_level_silence_ms = silence_ms;
+	g_sync.events++;
+	pthread_cond_signal(&g_sync.cond);
+	pthread_mutex_unlock(&g_sync.lock);
+}
+
+/* Waits for a window with dead air, or without it */
+static int __test_level_wait(bool dead_air)
+{
+	struct timespec deadline;
+	int ret = 0;
+
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += 2;
+	pthread_mutex_lock(&g_sync.lock);
+	g_sync.events = 0;
+	while(ret == 0 && (g_sync.events == 0 || (g_level_silence_ms >= TEST_METER_DEAD_AIR_MS) != dead_air
+		|| (g_level_peak > _RADIO_FIXTURE_SILENCE) == dead_air))
+		ret = pthread_cond_timedwait(&g_sync.cond, &g_sync.lock, &deadline);
+	pthread_mutex_unlock(&g_sync.lock);
+	if(ret != 0)
+		fprintf(stderr, "meter : no window %s dead air, peak %d silence %d ms\n", dead_air ? "with" : "without", g_level_peak,
+			g_level_silence_ms);
+	return ret == 0 ? 0 : -1;
+}
+
+static int __test_meter(radio_h radio)
+{
+	radio_level_s level;
+	int ret = 0;
+
+	if(__test_meter_kernel() != 0)
+		return -1;
+	if(radio_pcm_tap_start(radio, TEST_PCM_PERIOD_FRAMES, 64) != RADIO_ERROR_NONE || radio_start(radio) != RADIO_ERROR_NONE
+		|| radio_level_meter_start(radio, TEST_METER_INTERVAL_MS, _RADIO_FIXTURE_SILENCE, __level_cb, NULL) != RADIO_ERROR_NONE)
+		ret = -1;
+	if(ret == 0 && (__test_level_wait(false) != 0 || radio_set_mute(radio, true) != RADIO_ERROR_NONE || __test_level_wait(true) != 0
+		|| radio_set_mute(radio, false) != RADIO_ERROR_NONE || __test_level_wait(false) != 0))
+		ret = -1;
+	if(radio_level_meter_stop(radio) != RADIO_ERROR_NONE || radio_level_meter_get(radio, &level) != RADIO_ERROR_NONE
+		|| level.running || (ret == 0 && level.windows == 0))
+		ret = -1;
+	radio_stop(radio);
+	if(radio_pcm_tap_stop(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	return ret;
+}
+
+/*
+* Handle lifetime : lazy handles are created and destroyed in a loop, the token of every destroyed handle must be rejected,
+* also after its slot was taken again by the next handle. Creates whose device fails must give their slot back.
+*/
+#define TEST_HANDLES	100
+
+static int __test_handles(radio_h unused)
+{
+	radio_h radio, stale = NULL;
+	radio_state_e state;
+	int i;
+
+	for(i = 0; i < TEST_HANDLES; i++)
+	{
+		if(radio_create_lazy(&radio) != RADIO_ERROR_NONE || radio_destroy(radio) != RADIO_ERROR_NONE)
+			return -1;
+		if(radio_get_state(radio, &state) != RADIO_ERROR_INVALID_PARAMETER
+			|| (stale != NULL && radio_get_state(stale, &state) != RADIO_ERROR_INVALID_PARAMETER))
+		{
+			fprintf(stderr, "handles : destroyed handle accepted after %d handles\n", i);
+			return -1;
+		}
+		stale = radio;
+	}
+	for(i = 0; i < TEST_HANDLES; i++)
+	{
+		_radio_mock_fail_realize(1);
+		if(radio_create(&radio) == RADIO_ERROR_NONE || radio != NULL)
+		{
+			_radio_mock_fail_realize(0);
+			fprintf(stderr, "handles : create %d did not fail\n", i);
+			return -1;
+		}
+	}
+	if(radio_create(&radio) != RADIO_ERROR_NONE || radio_destroy(radio) != RADIO_ERROR_NONE)
+	{
+		fprintf(stderr, "handles : no handle left after %d failed creates\n", TEST_HANDLES);
+		return -1;
+	}
+	return 0;
+}
+
+typedef struct {
+	const char *name;
+	int (*run)(radio_h radio);
+} test_case_s;
+
+static const test_case_s g_cases[] = {
+	{ "status", __test_status },
+	{ "seek", __test_seek },
+	{ "event_fd", __test_event_fd },
+	{ "command_queue", __test_command_queue },
+	{ "callback_stress", __test_callback_stress },
+	{ "scan_listeners", __test_scan_listeners },
+	{ "interrupt_sweep", __test_interrupt_sweep },
+	{ "idle_resume", __test_idle_resume },
+	{ "realize_retry", __test_realize_retry },
+	{ "alternate_frequency", __test_alternate_frequency },
+	{ "pcm_tap", __test_pcm_tap },
+	{ "timeshift", __test_timeshift },
+	{ "recording", __test_recording },
+	{ "rds", __test_rds },
+	{ "meter", __test_meter },
+	{ "handles", __test_handles },
+};
+
+static int __test_run(const test_case_s *test)
+{
+	radio_h radio = NULL;
+	int ret;
+
+	if(radio_create(&radio) != RADIO_ERROR_NONE)
+	{
+		fprintf(stderr, "%s : radio_create failed\n", test->name);
+		return -1;
+	}
+	ret = test->run(radio);
+	if(radio_destroy(radio) != RADIO_ERROR_NONE)
+		ret = -1;
+	printf("%-24s %s\n", test->name, ret == 0 ? "PASS" : "FAIL");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int i, count = sizeof(g_cases) / sizeof(g_cases[0]), run = 0, failed = 0;
+
+	if(_radio_fixture_open(&g_fixture) != 0)
+	{
+		fprintf(stderr, "fixture files could not be written\n");
+		return 1;
+	}
+	for(i = 0; i < count; i++)
+	{
+		if(argc > 1 && strcmp(argv[1], g_cases[i].name) != 0)
+			continue;
+		run++;
+		if(__test_run(&g_cases[i]) != 0)
+			failed++;
+	}
+	_radio_fixture_close(&g_fixture);
+	if(run == 0)
+	{
+		fprintf(stderr, "usage: %s [case]\n", argv[0]);
+		return 2;
+	}
+	return failed == 0 ? 0 : 1;
+}